@@ -0,0 +1,59 @@
+// Local credential agent.
+//
+// Resolves credentials with the default provider chain and serves them to
+// AgentProvider clients on a Unix domain socket, so the refresh logic and
+// its STS, metadata and TLS traffic live in one process per host.
+//
+// Usage: credential_agent [--socket PATH] [--poll-interval-ms N]
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <alibabacloud/credential/AgentServer.hpp>
+#include <alibabacloud/credential/provider/DefaultProvider.hpp>
+
+using namespace AlibabaCloud::Credential;
+
+int main(int argc, char *argv[]) {
+  std::string socketPath = AgentProtocol::getDefaultSocketPath();
+  int64_t pollIntervalMs = AgentServer::DEFAULT_POLL_INTERVAL_MS;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+      socketPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--poll-interval-ms") == 0 && i + 1 < argc) {
+      pollIntervalMs = std::atoll(argv[++i]);
+    } else {
+      std::fprintf(stderr,
+                   "Usage: %s [--socket PATH] [--poll-interval-ms N]\n",
+                   argv[0]);
+      return 2;
+    }
+  }
+
+  // Block the stop signals before any thread starts so only sigwait sees them
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+
+  try {
+    AgentServer server(std::make_shared<DefaultProvider>(), socketPath,
+                       pollIntervalMs);
+    server.start();
+    std::fprintf(stderr, "credential agent listening on %s\n",
+                 socketPath.c_str());
+    int received = 0;
+    sigwait(&signals, &received);
+    server.stop();
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "credential agent: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,169 @@
+// Credential read throughput at 1..128 threads.
+//
+// Compares the read paths a request thread can use:
+//   baseline      - the previous release's RefreshableProvider::getCredential()
+//   snapshot      - RefreshableProvider::getSnapshot() (shared refcount)
+//   reference     - RefreshableProvider::getCredential() (atomic load)
+//   thread-local  - ThreadLocalCachedProvider::getCredential()
+//
+// Each read touches one field without copying it, so the numbers measure
+// the access path rather than std::string allocation.
+//
+// Usage: credential_read_benchmark [duration_ms] [max_threads]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
+#include <alibabacloud/credential/provider/ThreadLocalCachedProvider.hpp>
+
+using namespace AlibabaCloud::Credential;
+
+namespace {
+
+class StaticRefreshableProvider : public RefreshableProvider {
+public:
+  ~StaticRefreshableProvider() { shutdown(); }
+
+  std::string getProviderName() const override { return "benchmark"; }
+
+protected:
+  RefreshResult doRefresh() const override {
+    Models::CredentialModel credential;
+    credential.setAccessKeyId("LTAI5tBenchmarkAccessKeyId")
+        .setAccessKeySecret("BenchmarkAccessKeySecretValue000000")
+        .setSecurityToken(std::string(512, 't'));
+    int64_t stale = getCurrentTime() + 24 * 3600;
+    return RefreshResult(credential, stale, stale);
+  }
+};
+
+// RefreshableProvider::getCredential() as it was before the lock-free
+// cache, kept verbatim for a warm cache: take accessMutex_, compare the
+// system clock with the stale and prefetch times, return the cached value
+class BaselineRefreshableProvider {
+public:
+  explicit BaselineRefreshableProvider(const RefreshResult &value)
+      : cachedValue_(std::make_shared<RefreshResult>(value)) {}
+
+  const Models::CredentialModel &getCredential() const {
+    std::lock_guard<std::mutex> lock(accessMutex_);
+
+    if (cacheIsStale() || shouldInitiateCachePrefetch()) {
+      // Never reached: the benchmark credential is valid for a day
+      std::abort();
+    }
+
+    if (!cachedValue_) {
+      throw std::runtime_error("No cached credential available");
+    }
+
+    return cachedValue_->credential;
+  }
+
+private:
+  static int64_t getCurrentTime() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+  bool cacheIsStale() const {
+    if (!cachedValue_) {
+      return true;
+    }
+    return getCurrentTime() >= cachedValue_->staleTime;
+  }
+
+  bool shouldInitiateCachePrefetch() const {
+    if (!cachedValue_) {
+      return true;
+    }
+    return getCurrentTime() >= cachedValue_->prefetchTime;
+  }
+
+  mutable std::mutex accessMutex_;
+  std::shared_ptr<RefreshResult> cachedValue_;
+};
+
+double run(size_t threads, std::chrono::milliseconds duration,
+           const std::function<size_t()> &read) {
+  std::atomic<bool> start(false);
+  std::atomic<bool> stop(false);
+  std::atomic<uint64_t> total(0);
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threads; ++i) {
+    workers.emplace_back([&]() {
+      while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      uint64_t ops = 0;
+      size_t sink = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 64; ++i) {
+          sink += read();
+        }
+        ops += 64;
+      }
+      total.fetch_add(ops + (sink == 0 ? 1 : 0));
+    });
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  std::this_thread::sleep_for(duration);
+  stop.store(true);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  auto elapsed = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - begin).count();
+  return static_cast<double>(total.load()) / elapsed / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::chrono::milliseconds duration(argc > 1 ? std::atoi(argv[1]) : 500);
+  size_t maxThreads = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 128;
+
+  auto refreshable = std::make_shared<StaticRefreshableProvider>();
+  const int64_t stale = std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count() + 24 * 3600;
+  BaselineRefreshableProvider baseline(
+      RefreshResult(refreshable->getCredential(), stale, stale));
+  ThreadLocalCachedProvider threadLocal(refreshable);
+
+  std::printf("hardware threads: %u, %lld ms per run, Mops/s\n",
+              std::thread::hardware_concurrency(),
+              static_cast<long long>(duration.count()));
+  std::printf("%8s %12s %12s %12s %12s\n", "threads", "baseline", "snapshot",
+              "reference", "thread-local");
+
+  for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+    double baselineRate = run(threads, duration, [&]() {
+      return baseline.getCredential().hasAccessKeyId() ? 1 : 0;
+    });
+    double snapshotRate = run(threads, duration, [&]() {
+      return refreshable->getSnapshot()->getAccessKeyId().size();
+    });
+    double referenceRate = run(threads, duration, [&]() {
+      return refreshable->getCredential().hasAccessKeyId() ? 1 : 0;
+    });
+    double threadLocalRate = run(threads, duration, [&]() {
+      return threadLocal.getCredential().hasAccessKeyId() ? 1 : 0;
+    });
+    std::printf("%8zu %12.2f %12.2f %12.2f %12.2f\n", threads, baselineRate,
+                snapshotRate, referenceRate, threadLocalRate);
+  }
+  return 0;
+}
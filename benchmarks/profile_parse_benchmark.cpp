@@ -0,0 +1,146 @@
+// Profile lookup latency in a large shared profile file.
+//
+// Writes an INI file and a CLI JSON config with N profiles (10000 by
+// default) and times looking up one profile and copying its fields out:
+//   ini / Darabonba::Ini  - std::ifstream + Darabonba::Ini::parse
+//   ini / ProfileFile     - read() + single-pass section scan
+//   json / nlohmann       - full DOM parse + linear scan of "profiles"
+//   json / ProfileFile    - read() + scan up to the matching profile
+//
+// Each lookup opens the file again, as a provider does when it (re)loads.
+// Profiles at the start, middle and end of the file are measured.
+//
+// Usage: profile_parse_benchmark [profiles] [iterations] [directory]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+
+#include <darabonba/Ini.hpp>
+#include <nlohmann/json.hpp>
+
+#include <alibabacloud/credential/ProfileFile.hpp>
+
+using namespace AlibabaCloud::Credential;
+
+namespace {
+
+std::string profileName(int i) { return "profile_" + std::to_string(i); }
+
+void writeIni(const std::string &path, int profiles) {
+  std::ofstream ofs(path, std::ios::trunc);
+  for (int i = 0; i < profiles; ++i) {
+    ofs << "[" << profileName(i) << "]\n"
+        << "enable = true\n"
+        << "type = ram_role_arn\n"
+        << "access_key_id = LTAI5tBenchmark" << i << "\n"
+        << "access_key_secret = BenchmarkAccessKeySecretValue" << i << "\n"
+        << "role_arn = acs:ram::1234567890:role/benchmark-" << i << "\n"
+        << "role_session_name = benchmark\n\n";
+  }
+}
+
+void writeJson(const std::string &path, int profiles) {
+  std::ofstream ofs(path, std::ios::trunc);
+  ofs << "{\"current\": \"" << profileName(0) << "\", \"profiles\": [\n";
+  for (int i = 0; i < profiles; ++i) {
+    ofs << (i == 0 ? "" : ",\n") << "{\"name\": \"" << profileName(i)
+        << "\", \"mode\": \"RamRoleArn\", \"access_key_id\": \"LTAI5tBenchmark"
+        << i << "\", \"access_key_secret\": \"BenchmarkAccessKeySecretValue" << i
+        << "\", \"ram_role_arn\": \"acs:ram::1234567890:role/benchmark-" << i
+        << "\", \"role_session_name\": \"benchmark\", \"region_id\": "
+           "\"cn-hangzhou\"}";
+  }
+  ofs << "\n]}\n";
+}
+
+// Microseconds per call of `lookup`, which returns the size of what it copied
+double run(int iterations, const std::function<size_t()> &lookup) {
+  size_t sink = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    sink += lookup();
+  }
+  auto elapsed = std::chrono::duration<double, std::micro>(
+                     std::chrono::steady_clock::now() - begin)
+                     .count();
+  if (sink == 0) {
+    std::printf("lookup failed\n");
+  }
+  return elapsed / iterations;
+}
+
+size_t iniDarabonba(const std::string &path, const std::string &name) {
+  std::ifstream ifs(path);
+  auto iniObj = Darabonba::Ini::parse(ifs);
+  const auto &section = iniObj.get(name);
+  std::string accessKeyId = section.get("access_key_id");
+  std::string roleArn = section.get("role_arn");
+  return accessKeyId.size() + roleArn.size();
+}
+
+size_t iniProfileFile(const std::string &path, const std::string &name) {
+  ProfileFile file(path);
+  ProfileFile::Section section;
+  file.findSection(name, section);
+  std::string accessKeyId = ProfileFile::find(section, "access_key_id")->str();
+  std::string roleArn = ProfileFile::find(section, "role_arn")->str();
+  return accessKeyId.size() + roleArn.size();
+}
+
+size_t jsonNlohmann(const std::string &path, const std::string &name) {
+  std::ifstream ifs(path);
+  nlohmann::json config;
+  ifs >> config;
+  for (const auto &profile : config["profiles"]) {
+    if (profile["name"] == name) {
+      std::string accessKeyId = profile["access_key_id"];
+      std::string roleArn = profile["ram_role_arn"];
+      return accessKeyId.size() + roleArn.size();
+    }
+  }
+  return 0;
+}
+
+size_t jsonProfileFile(const std::string &path, const std::string &name) {
+  ProfileFile file(path);
+  ProfileFile::Section section;
+  file.findJsonProfile(name, section);
+  std::string accessKeyId = ProfileFile::find(section, "access_key_id")->str();
+  std::string roleArn = ProfileFile::find(section, "ram_role_arn")->str();
+  return accessKeyId.size() + roleArn.size();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int profiles = argc > 1 ? std::atoi(argv[1]) : 10000;
+  int iterations = argc > 2 ? std::atoi(argv[2]) : 20;
+  std::string directory = argc > 3 ? argv[3] : "/tmp";
+  const std::string iniPath = directory + "/profile_parse_benchmark.ini";
+  const std::string jsonPath = directory + "/profile_parse_benchmark.json";
+  writeIni(iniPath, profiles);
+  writeJson(jsonPath, profiles);
+
+  std::printf("%d profiles, %d lookups per cell, us per lookup\n", profiles,
+              iterations);
+  std::printf("%10s %16s %16s %16s %16s\n", "profile", "ini/Darabonba",
+              "ini/ProfileFile", "json/nlohmann", "json/ProfileFile");
+  const int positions[] = {0, profiles / 2, profiles - 1};
+  for (int position : positions) {
+    const std::string name = profileName(position);
+    double iniOld = run(iterations, [&]() { return iniDarabonba(iniPath, name); });
+    double iniNew = run(iterations, [&]() { return iniProfileFile(iniPath, name); });
+    double jsonOld = run(iterations, [&]() { return jsonNlohmann(jsonPath, name); });
+    double jsonNew = run(iterations, [&]() { return jsonProfileFile(jsonPath, name); });
+    std::printf("%10d %16.1f %16.1f %16.1f %16.1f\n", position, iniOld, iniNew,
+                jsonOld, jsonNew);
+  }
+
+  std::remove(iniPath.c_str());
+  std::remove(jsonPath.c_str());
+  return 0;
+}
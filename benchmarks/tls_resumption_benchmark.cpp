@@ -0,0 +1,70 @@
+// Cost of reconnecting to a TLS endpoint per credential refresh.
+//
+// Runs a loopback HTTPS server standing in for STS that closes the
+// connection after every response, as an idle connection is closed between
+// hourly rotations, and times one request per refresh through an
+// HttpConnectionPool:
+//   full     - no TlsSessionCache: every refresh makes a full handshake
+//   resumed  - with a TlsSessionCache: refreshes after the first resume the
+//              session
+//
+// Usage: tls_resumption_benchmark [refreshes] [directory]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <alibabacloud/credential/HttpConnectionPool.hpp>
+#include <alibabacloud/credential/TlsSessionCache.hpp>
+
+#include "tls_loopback_server.hpp"
+
+using namespace AlibabaCloud::Credential;
+
+namespace {
+
+const char *const BODY =
+    "{\"RequestId\":\"benchmark\",\"Code\":\"Success\",\"Credentials\":{"
+    "\"AccessKeyId\":\"STS.benchmark\",\"AccessKeySecret\":\"secret\","
+    "\"SecurityToken\":\"token\",\"Expiration\":\"2030-01-01T00:00:00Z\"}}";
+
+// Microseconds per refresh, and the server's handshake counts
+void run(const char *label, int refreshes, const std::string &caFile,
+         std::shared_ptr<TlsSessionCache> sessionCache) {
+  TlsLoopbackServer server(BODY, caFile);
+  HttpConnectionPool::Options options;
+  options.maxIdlePerEndpoint = 0;
+  options.sessionCache = std::move(sessionCache);
+  options.caFile = server.caFile();
+  HttpConnectionPool pool(options);
+  const HttpRequest request(server.url());
+
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < refreshes; ++i) {
+    if (pool.send(request).statusCode != 200) {
+      std::printf("refresh failed\n");
+    }
+  }
+  auto elapsed = std::chrono::duration<double, std::micro>(
+                     std::chrono::steady_clock::now() - begin)
+                     .count();
+  std::printf("%10s %16.1f %12d %12d\n", label, elapsed / refreshes,
+              server.handshakes(), server.resumed());
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int refreshes = argc > 1 ? std::atoi(argv[1]) : 200;
+  std::string directory = argc > 2 ? argv[2] : "/tmp";
+  const std::string caFile = directory + "/tls_resumption_benchmark.pem";
+
+  std::printf("%d refreshes, one new connection each\n", refreshes);
+  std::printf("%10s %16s %12s %12s\n", "handshake", "us per refresh",
+              "handshakes", "resumed");
+  run("full", refreshes, caFile, nullptr);
+  run("resumed", refreshes, caFile, std::make_shared<TlsSessionCache>());
+  return 0;
+}
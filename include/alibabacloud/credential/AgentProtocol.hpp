@@ -0,0 +1,118 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_AGENTPROTOCOL_HPP_
+#define ALIBABACLOUD_CREDENTIAL_AGENTPROTOCOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <alibabacloud/credential/CredentialSnapshot.hpp>
+#include <alibabacloud/credential/Model.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Wire format between the credential agent and AgentProvider
+ *
+ * Every message is a frame:
+ *
+ *   magic "AC" | version u8 | type u8 | payload length u32 LE | payload
+ *
+ * Requests (GET, SUBSCRIBE) carry no payload. A CREDENTIAL payload is
+ *
+ *   generation u64 LE | expiration i64 LE | 6 x (length u16 LE | bytes)
+ *
+ * with the fields in CredentialSnapshot order (access key id, secret,
+ * security token, bearer token, type, provider name). A FAILURE payload is
+ * the error message. After SUBSCRIBE the agent sends the current credential
+ * and then one CREDENTIAL frame per rotation on the same connection.
+ */
+class AgentProtocol {
+public:
+  static constexpr uint8_t VERSION = 1;
+  static constexpr size_t HEADER_SIZE = 8;
+  static constexpr uint32_t MAX_PAYLOAD_SIZE = 64 * 1024;
+
+  enum class MessageType : uint8_t {
+    GET = 1,           // Request the current credential
+    SUBSCRIBE = 2,     // Current credential, then push on rotation
+    CREDENTIAL = 0x81,
+    FAILURE = 0x82
+  };
+
+  struct Message {
+    MessageType type = MessageType::FAILURE;
+    std::string payload;
+  };
+
+  /**
+   * @brief A decoded CREDENTIAL payload
+   */
+  struct Credential {
+    Models::CredentialModel credential;
+    int64_t expiration = 0;  // Seconds timestamp, 0 if it does not expire
+    uint64_t generation = 0;
+  };
+
+  /**
+   * @brief Default socket path
+   *
+   * ALIBABA_CLOUD_CREDENTIALS_AGENT_SOCKET if set, otherwise
+   * alibabacloud-credential-agent.sock in the per-user $XDG_RUNTIME_DIR, or
+   * in /tmp/alibabacloud-credential-agent-<uid> if that is not set either.
+   */
+  static std::string getDefaultSocketPath();
+
+  static std::string encodeFrame(MessageType type,
+                                 const std::string &payload = "");
+
+  /**
+   * @throw Darabonba::Exception if a field is longer than 65535 bytes
+   */
+  static std::string encodeCredential(const CredentialSnapshot &snapshot,
+                                      uint64_t generation);
+
+  /**
+   * @return false if the payload is malformed
+   */
+  static bool decodeCredential(const std::string &payload, Credential &out);
+
+  /**
+   * @brief Parse one frame from the front of `buffer`
+   *
+   * @return Bytes consumed, 0 if the frame is incomplete
+   * @throw Darabonba::Exception if the data is not a valid frame
+   */
+  static size_t decodeFrame(const std::string &buffer, Message &message);
+
+#ifndef _WIN32
+  /**
+   * @brief Blocking helpers on a connected socket
+   *
+   * @return false on error, timeout or closed connection
+   */
+  static bool writeFrame(int fd, const std::string &frame);
+  static bool readFrame(int fd, Message &message);
+
+  /**
+   * @brief Connect to the agent, -1 on failure
+   *
+   * @param timeoutMs Send and receive timeout, 0 for none
+   */
+  static int connectTo(const std::string &socketPath, int64_t timeoutMs);
+
+  /**
+   * @brief Whether the process at the other end of a connected socket runs
+   *        as this process's user or as root
+   *
+   * Checked with SO_PEERCRED (getpeereid() where that is missing) before a
+   * credential received from the agent is used.
+   */
+  static bool isTrustedPeer(int fd);
+#endif
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_AGENTSERVER_HPP_
+#define ALIBABACLOUD_CREDENTIAL_AGENTSERVER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <alibabacloud/credential/AgentProtocol.hpp>
+#include <alibabacloud/credential/provider/Provider.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Serves one provider's credential on a Unix domain socket
+ *
+ * The server owns the provider, and with it all refresh logic: a watcher
+ * thread reads the provider every poll interval, which also drives its
+ * refresh, and an event loop thread answers GET requests from the last
+ * encoded credential and pushes a CREDENTIAL frame to every subscriber when
+ * the key material changes. Clients never wait for the remote service, and
+ * responses are written without blocking, so a client that stops reading
+ * only delays itself.
+ *
+ * The socket is created with mode 0600, so only processes of the same user
+ * connect, in a directory created with mode 0700 if it is missing; a
+ * directory owned by another user is refused. The credential-agent binary
+ * wraps a server around DefaultProvider; applications read it with
+ * AgentProvider. Not supported on Windows.
+ */
+class AgentServer {
+public:
+  static constexpr int64_t DEFAULT_POLL_INTERVAL_MS = 1000;
+  // Unsent response bytes after which a client that stopped reading is dropped
+  static constexpr size_t MAX_PENDING_BYTES =
+      4 * (AgentProtocol::HEADER_SIZE + AgentProtocol::MAX_PAYLOAD_SIZE);
+
+  /**
+   * @param provider Provider whose credential is served
+   * @param socketPath Socket to listen on, replaced if stale
+   * @param pollIntervalMs How often the provider is read for rotations
+   */
+  AgentServer(std::shared_ptr<Provider> provider,
+              std::string socketPath = AgentProtocol::getDefaultSocketPath(),
+              int64_t pollIntervalMs = DEFAULT_POLL_INTERVAL_MS);
+  ~AgentServer();
+
+  AgentServer(const AgentServer &) = delete;
+  AgentServer &operator=(const AgentServer &) = delete;
+
+  /**
+   * @brief Load the credential, bind the socket and start serving
+   *
+   * A provider that fails to load does not prevent the start: clients get
+   * FAILURE until a later poll succeeds.
+   *
+   * @throw Darabonba::Exception if the socket cannot be bound, its directory
+   *        belongs to another user or another agent already serves it
+   */
+  void start();
+
+  /**
+   * @brief Close all connections and remove the socket
+   */
+  void stop();
+
+  const std::string &getSocketPath() const { return socketPath_; }
+
+  /**
+   * @brief Generation of the served credential, bumped on each rotation
+   */
+  uint64_t getGeneration() const {
+    return generation_.load(std::memory_order_acquire);
+  }
+
+private:
+  struct Client;
+
+  void watch();
+  void serve();
+  bool pollProvider();
+  bool handle(Client &client);
+  bool flush(Client &client);
+  bool send(Client &client, const std::shared_ptr<const std::string> &frame);
+  std::shared_ptr<const std::string> currentFrame() const;
+
+  std::shared_ptr<Provider> provider_;
+  std::string socketPath_;
+  int64_t pollIntervalMs_;
+
+  int listenFd_ = -1;
+  int wakeFds_[2] = {-1, -1};  // Self-pipe: stop or new credential
+  std::thread serveThread_;
+  std::thread watchThread_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable stopCondition_;
+  bool stopping_ = false;
+  std::shared_ptr<const CredentialSnapshot> snapshot_;  // Last served
+  std::shared_ptr<const std::string> frame_;  // CREDENTIAL or FAILURE frame
+  std::atomic<uint64_t> generation_{0};
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
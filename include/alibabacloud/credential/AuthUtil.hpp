@@ -15,6 +15,8 @@ namespace AlibabaCloud {
 
 namespace Credential {
 
+struct HttpRequest;
+
 class AuthUtil {
 public:
   static bool setClientType(const std::string &type);
@@ -48,6 +50,15 @@ public:
    */
   static Darabonba::Http::Request getNewRequest(const std::string& url, 
                                                   const std::string& customUserAgent = "");
+
+  /**
+   * @brief Create a request for an HttpTransport with User-Agent header
+   *
+   * @param url Request URL
+   * @param customUserAgent Custom user agent suffix (optional)
+   */
+  static HttpRequest getNewHttpRequest(const std::string& url,
+                                       const std::string& customUserAgent = "");
   
   /**
    * @brief Get SDK version string
@@ -43,6 +43,18 @@ public:
   static const std::string ENV_STS_REGION;
   static const std::string ENV_VPC_ENDPOINT_ENABLED;
   static const std::string ENV_CLI_PROFILE_DISABLED;
+  static const std::string ENV_REFRESH_THREADS;
+  static const std::string ENV_REFRESH_CPUS;
+  static const std::string ENV_REFRESH_PREFETCH_FRACTION;
+  static const std::string ENV_REFRESH_JITTER_FRACTION;
+  static const std::string ENV_REFRESH_MIN_INTERVAL;
+  static const std::string ENV_REFRESH_MAX_INTERVAL;
+  static const std::string ENV_CREDENTIALS_CACHE_DIR;
+  static const std::string ENV_CREDENTIALS_CACHE_ENCRYPTED;
+  static const std::string ENV_CREDENTIALS_SHARED_MEMORY;
+  static const std::string ENV_CREDENTIALS_AGENT_SOCKET;
+  static const std::string ENV_CREDENTIALS_PARALLEL_RESOLUTION;
+  static const std::string ENV_CREDENTIALS_HTTP_TRANSPORT;
   
   // OIDC Environment Variables
   static const std::string ENV_ROLE_ARN;
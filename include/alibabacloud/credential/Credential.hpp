@@ -4,6 +4,7 @@
 #include <alibabacloud/credential/Model.hpp>
 #include <alibabacloud/credential/provider/Provider.hpp>
 
+#include <future>
 #include <memory>
 #include <string>
 
@@ -53,7 +54,7 @@ public:
     return provider_ == nullptr;
   }
 
-  // Deprecated: use getCredentials() to avoid AK/SK misalignment due to refresh
+  // Deprecated: use getSnapshot() to avoid AK/SK misalignment due to refresh
   std::string getAccessKeyId() {
     return provider_->getCredential().getAccessKeyId();
   };
@@ -73,6 +74,31 @@ public:
    */
   Models::CredentialModel getCredential() const { return provider_->getCredential(); }
 
+  /**
+   * @brief Get an immutable snapshot of the current credential
+   *
+   * No copy is made; all fields of the snapshot come from the same refresh.
+   */
+  std::shared_ptr<const CredentialSnapshot> getSnapshot() const {
+    return provider_->getSnapshot();
+  }
+
+  /**
+   * @brief Get the credential generation, see Provider::getGeneration()
+   */
+  uint64_t getGeneration() const { return provider_->getGeneration(); }
+
+  /**
+   * @brief Start fetching the credential in the background
+   *
+   * Call it during process initialization and get() the future before
+   * serving traffic; warm-ups of several clients run in parallel. The fetch
+   * runs on its own thread holding a reference to the provider, so the
+   * client may go away first and discarding the future does not wait for
+   * it.
+   */
+  std::shared_future<std::shared_ptr<const CredentialSnapshot>> warmUp() const;
+
 private:
   static std::shared_ptr<Provider> makeProvider(std::shared_ptr<Models::Config> config);
 
@@ -0,0 +1,88 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_CREDENTIALSNAPSHOT_HPP_
+#define ALIBABACLOUD_CREDENTIAL_CREDENTIALSNAPSHOT_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <alibabacloud/credential/Model.hpp>
+#include <alibabacloud/credential/StringView.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Immutable view of a credential at one point in time
+ *
+ * Providers hand snapshots out as std::shared_ptr<const CredentialSnapshot>.
+ * A snapshot is never modified after construction, so a caller may keep it
+ * for the duration of a request and all fields always belong to the same
+ * rotation, even if the provider refreshes meanwhile.
+ *
+ * All fields live in one contiguous buffer addressed by offset/length slots:
+ * copying a snapshot is a single allocation and reading a field never
+ * allocates. Use toCredentialModel() or toMap() for the Darabonba model.
+ */
+class CredentialSnapshot {
+public:
+  /**
+   * @param credential Credential to capture
+   * @param expiration Seconds timestamp after which the provider no longer
+   *                   serves this credential, 0 if it does not expire
+   */
+  explicit CredentialSnapshot(const Models::CredentialModel &credential,
+                              int64_t expiration = 0);
+  CredentialSnapshot(const CredentialSnapshot &other);
+  CredentialSnapshot &operator=(const CredentialSnapshot &) = delete;
+
+  StringView getAccessKeyId() const { return field(ACCESS_KEY_ID); }
+  StringView getAccessKeySecret() const { return field(ACCESS_KEY_SECRET); }
+  StringView getSecurityToken() const { return field(SECURITY_TOKEN); }
+  StringView getBearerToken() const { return field(BEARER_TOKEN); }
+  StringView getType() const { return field(TYPE); }
+  StringView getProviderName() const { return field(PROVIDER_NAME); }
+  int64_t getExpiration() const { return expiration_; }
+
+  /**
+   * @brief Copy the snapshot into a mutable CredentialModel
+   *
+   * Empty fields are left unset.
+   */
+  Models::CredentialModel toCredentialModel() const;
+
+  /**
+   * @brief Darabonba map representation (same keys as CredentialModel)
+   */
+  Darabonba::Json toMap() const { return toCredentialModel().toMap(); }
+
+private:
+  enum Field {
+    ACCESS_KEY_ID,
+    ACCESS_KEY_SECRET,
+    SECURITY_TOKEN,
+    BEARER_TOKEN,
+    TYPE,
+    PROVIDER_NAME,
+    FIELD_COUNT
+  };
+
+  struct Slot {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  StringView field(Field index) const {
+    return StringView(buffer_.get() + slots_[index].offset,
+                      slots_[index].length);
+  }
+
+  std::unique_ptr<char[]> buffer_;  // Fields back to back, no separators
+  uint32_t size_ = 0;
+  Slot slots_[FIELD_COUNT];
+  const int64_t expiration_;
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
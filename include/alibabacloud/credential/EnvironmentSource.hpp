@@ -0,0 +1,85 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_ENVIRONMENTSOURCE_HPP_
+#define ALIBABACLOUD_CREDENTIAL_ENVIRONMENTSOURCE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Snapshot of the environment variables read by the providers
+ *
+ * fromProcess() copies the ALIBABA_CLOUD_* variables and the home directory
+ * variables out of the process environment once; providers then read the
+ * copy instead of calling getenv on every access. The snapshot changes only
+ * through reload(), which bumps the version so providers built from it
+ * rebuild on their next call.
+ *
+ * A source built from a fixed set of variables never reads the process
+ * environment, so tests can run side by side without touching environ.
+ */
+class EnvironmentSource {
+public:
+  typedef std::map<std::string, std::string> Variables;
+
+  /**
+   * @brief New snapshot of the process environment
+   */
+  static std::shared_ptr<EnvironmentSource> fromProcess();
+
+  /**
+   * @brief Source holding exactly `variables`
+   */
+  explicit EnvironmentSource(Variables variables);
+
+  EnvironmentSource(const EnvironmentSource &) = delete;
+  EnvironmentSource &operator=(const EnvironmentSource &) = delete;
+
+  /**
+   * @brief Value of `name`, `defaultValue` if it is not set
+   */
+  std::string get(const std::string &name,
+                  const std::string &defaultValue = "") const;
+
+  /**
+   * @brief Take a new snapshot of the process environment
+   *
+   * No-op for a source built from fixed variables.
+   */
+  void reload();
+
+  /**
+   * @brief Replace the variables with `variables`
+   */
+  void reload(Variables variables);
+
+  /**
+   * @brief Incremented by every reload that changed a variable
+   */
+  uint64_t getVersion() const {
+    return version_.load(std::memory_order_acquire);
+  }
+
+private:
+  EnvironmentSource(Variables variables, bool fromProcess);
+
+  /**
+   * @brief ALIBABA_CLOUD_* and home directory variables of the process
+   */
+  static Variables capture();
+
+  const bool fromProcess_;
+  Variables variables_;  // Guarded by mutex_
+  std::atomic<uint64_t> version_{0};
+  mutable std::mutex mutex_;
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
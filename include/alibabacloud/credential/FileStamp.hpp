@@ -0,0 +1,41 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_FILESTAMP_HPP_
+#define ALIBABACLOUD_CREDENTIAL_FILESTAMP_HPP_
+
+#include <cstdint>
+#include <string>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Identity of a file's content: device, inode, mtime and size
+ *
+ * Two equal stamps of the same path mean the file was neither replaced nor
+ * modified in between, so anything parsed from it is still valid. Replacing
+ * the file (rename over it) changes the inode; writing in place changes the
+ * mtime or size.
+ */
+struct FileStamp {
+  uint64_t device = 0;
+  uint64_t inode = 0;
+  int64_t mtimeNs = 0;
+  int64_t size = -1;  // -1 if the file does not exist
+
+  /**
+   * @brief Stamp of `path`, a missing-file stamp if it can't be stat'ed
+   */
+  static FileStamp of(const std::string &path);
+
+  bool exists() const { return size >= 0; }
+
+  bool operator==(const FileStamp &other) const {
+    return device == other.device && inode == other.inode &&
+           mtimeNs == other.mtimeNs && size == other.size;
+  }
+  bool operator!=(const FileStamp &other) const { return !(*this == other); }
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_HTTPCONNECTIONPOOL_HPP_
+#define ALIBABACLOUD_CREDENTIAL_HTTPCONNECTIONPOOL_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <alibabacloud/credential/HttpTransport.hpp>
+#include <alibabacloud/credential/TlsSessionCache.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Keep-alive HTTP connections shared by all credential providers
+ *
+ * Connections are kept per endpoint (scheme, host and port) after a request
+ * completes, so the next refresh against the same STS, SSO, OAuth or
+ * metadata endpoint skips the TCP and TLS handshakes. At most
+ * maxIdlePerEndpoint connections are kept per endpoint; one unused for
+ * idleTimeoutMs is closed. Requests in flight are not limited: a request
+ * finding no idle connection opens a new one.
+ *
+ * New TLS connections resume a session from the TlsSessionCache when the
+ * endpoint was connected to before, which keeps reconnects after an idle
+ * close cheap.
+ *
+ * getInstance() is the default HttpTransport of the providers.
+ */
+class HttpConnectionPool : public HttpTransport {
+public:
+  struct Options {
+    size_t maxIdlePerEndpoint = 4;  // Idle connections kept per endpoint
+    int64_t idleTimeoutMs = 60000;  // Idle connections older than this close
+    std::shared_ptr<TlsSessionCache> sessionCache =
+        TlsSessionCache::getDefault();  // nullptr: no resumption
+    std::string caFile;  // CA bundle for TLS endpoints, empty for the default
+  };
+
+  struct Stats {
+    uint64_t connectionsOpened = 0;  // Requests that had to connect
+    uint64_t connectionsReused = 0;  // Requests sent on a kept connection
+  };
+
+  /**
+   * @brief Get the shared pool instance
+   */
+  static HttpConnectionPool &getInstance();
+
+  explicit HttpConnectionPool(const Options &options);
+  ~HttpConnectionPool();
+
+  HttpConnectionPool(const HttpConnectionPool &) = delete;
+  HttpConnectionPool &operator=(const HttpConnectionPool &) = delete;
+
+  /**
+   * @brief Send a request, reusing an idle connection to its endpoint
+   *
+   * @throw Darabonba::Exception if no response was received
+   */
+  HttpResponse send(const HttpRequest &request) override;
+
+  /**
+   * @brief Number of idle connections kept for all endpoints
+   */
+  size_t idleConnections() const;
+
+  Stats getStats() const;
+
+private:
+  struct Idle {
+    void *handle;  // CURL easy handle owning the connection
+    int64_t idleSinceMs;
+  };
+
+  void *acquire(const std::string &endpoint);
+  void release(const std::string &endpoint, void *handle);
+  void closeExpired(int64_t nowMs);
+
+  Options options_;
+  std::map<std::string, std::deque<Idle>> idle_;  // Most recent at the back
+  mutable std::mutex mutex_;                      // Guards idle_
+
+  std::atomic<uint64_t> connectionsOpened_{0};
+  std::atomic<uint64_t> connectionsReused_{0};
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_HTTPTRANSPORT_HPP_
+#define ALIBABACLOUD_CREDENTIAL_HTTPTRANSPORT_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <darabonba/http/Query.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Request sent by a credential provider
+ */
+struct HttpRequest {
+  std::string method = "GET";
+  std::string url;                           // scheme://host[:port]/path
+  Darabonba::Http::Query query;              // Appended to url when sent
+  std::map<std::string, std::string> headers;
+  std::string body;
+  int64_t connectTimeoutMs = 0;  // 0 for the transport default
+  int64_t readTimeoutMs = 0;     // 0 for no limit
+
+  HttpRequest() = default;
+  explicit HttpRequest(const std::string &url) : url(url) {}
+};
+
+struct HttpResponse {
+  int statusCode = 0;
+  std::string body;
+};
+
+/**
+ * @brief Sends the HTTP requests of credential providers
+ *
+ * Providers fetching credentials (STS, Cloud SSO, OAuth, URL, ECS metadata)
+ * send every request through the transport set with
+ * RefreshableProvider::setHttpTransport() or Models::Config::setHttpTransport(),
+ * by default the process-wide HttpConnectionPool. Implementations must be
+ * thread safe: background refreshes of several providers call send()
+ * concurrently.
+ */
+class HttpTransport {
+public:
+  virtual ~HttpTransport() {}
+
+  /**
+   * @brief Transport of providers that were given none
+   *
+   * The process-wide HttpConnectionPool, or a DarabonbaHttpTransport when
+   * ALIBABA_CLOUD_CREDENTIALS_HTTP_TRANSPORT is "darabonba" on first use.
+   */
+  static std::shared_ptr<HttpTransport> getDefault();
+
+  /**
+   * @brief Send a request and wait for the response
+   *
+   * A response with any status code is returned; only a request that got
+   * no response throws.
+   *
+   * @throw Darabonba::Exception if no response was received
+   */
+  virtual HttpResponse send(const HttpRequest &request) = 0;
+};
+
+/**
+ * @brief Transport sending each request with Darabonba::Core::doAction
+ */
+class DarabonbaHttpTransport : public HttpTransport {
+public:
+  HttpResponse send(const HttpRequest &request) override;
+};
+
+/**
+ * @brief Transport reporting how long each request of another one took
+ */
+class TimedHttpTransport : public HttpTransport {
+public:
+  /**
+   * @brief Called after every request with its status code (0 if it threw)
+   *        and duration in microseconds
+   */
+  typedef std::function<void(const HttpRequest &request, int statusCode,
+                             int64_t elapsedUs)>
+      Listener;
+
+  TimedHttpTransport(std::shared_ptr<HttpTransport> transport,
+                     Listener listener)
+      : transport_(std::move(transport)), listener_(std::move(listener)) {}
+
+  HttpResponse send(const HttpRequest &request) override;
+
+private:
+  std::shared_ptr<HttpTransport> transport_;
+  Listener listener_;
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
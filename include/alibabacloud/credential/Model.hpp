@@ -8,6 +8,7 @@ using namespace std;
 namespace AlibabaCloud {
 namespace Credential {
 class AuthUtil;
+class HttpTransport;
 }
 } // namespace AlibabaCloud
 
@@ -161,6 +162,7 @@ public:
     DARABONBA_PTR_TO_JSON(connectTimeout, connectTimeout_);
     DARABONBA_PTR_TO_JSON(disableIMDSv1, disableIMDSv1_);
     DARABONBA_PTR_TO_JSON(reuseLastProviderEnabled, reuseLastProviderEnabled_);
+    DARABONBA_PTR_TO_JSON(parallelResolutionEnabled, parallelResolutionEnabled_);
   };
   friend void from_json(const Darabonba::Json &j, Config &obj) {
     DARABONBA_PTR_FROM_JSON(accessKeyId, accessKeyId_);
@@ -192,6 +194,8 @@ public:
     DARABONBA_PTR_FROM_JSON(disableIMDSv1, disableIMDSv1_);
     DARABONBA_PTR_FROM_JSON(reuseLastProviderEnabled,
                             reuseLastProviderEnabled_);
+    DARABONBA_PTR_FROM_JSON(parallelResolutionEnabled,
+                            parallelResolutionEnabled_);
   };
   Config() = default;
   Config(const Config &) = default;
@@ -228,7 +232,8 @@ public:
            this->enableVpc_ == nullptr && this->timeout_ == nullptr &&
            this->connectTimeout_ == nullptr &&
            this->disableIMDSv1_ == nullptr &&
-           this->reuseLastProviderEnabled_ == nullptr;
+           this->reuseLastProviderEnabled_ == nullptr &&
+           this->parallelResolutionEnabled_ == nullptr;
   };
   // accessKeyId Field Functions
   bool hasAccessKeyId() const { return this->accessKeyId_ != nullptr; };
@@ -502,6 +507,31 @@ public:
     DARABONBA_PTR_SET_VALUE(reuseLastProviderEnabled_, reuseLastProviderEnabled)
   };
 
+  // parallelResolutionEnabled Field Functions
+  bool hasParallelResolutionEnabled() const {
+    return this->parallelResolutionEnabled_ != nullptr;
+  };
+  void deleteParallelResolutionEnabled() {
+    this->parallelResolutionEnabled_ = nullptr;
+  };
+  inline bool getParallelResolutionEnabled() const {
+    DARABONBA_PTR_GET_DEFAULT(parallelResolutionEnabled_, false)
+  };
+  inline Config &setParallelResolutionEnabled(bool parallelResolutionEnabled) {
+    DARABONBA_PTR_SET_VALUE(parallelResolutionEnabled_, parallelResolutionEnabled)
+  };
+
+  // httpTransport Field Functions (not serialized)
+  bool hasHttpTransport() const { return this->httpTransport_ != nullptr; };
+  void deleteHttpTransport() { this->httpTransport_ = nullptr; };
+  inline shared_ptr<HttpTransport> getHttpTransport() const {
+    return this->httpTransport_;
+  };
+  inline Config &setHttpTransport(shared_ptr<HttpTransport> httpTransport) {
+    this->httpTransport_ = std::move(httpTransport);
+    return *this;
+  };
+
 protected:
   // accesskey id
   shared_ptr<string> accessKeyId_{};
@@ -559,6 +589,10 @@ protected:
   shared_ptr<bool> disableIMDSv1_ = make_shared<bool>(false);
   // reuse last provider enabled
   shared_ptr<bool> reuseLastProviderEnabled_ = make_shared<bool>(false);
+  // probe the default provider chain concurrently
+  shared_ptr<bool> parallelResolutionEnabled_ = make_shared<bool>(false);
+  // transport of credential requests, nullptr for HttpTransport::getDefault()
+  shared_ptr<HttpTransport> httpTransport_{};
 };
 
 } // namespace Models
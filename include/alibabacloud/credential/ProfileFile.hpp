@@ -0,0 +1,110 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_PROFILEFILE_HPP_
+#define ALIBABACLOUD_CREDENTIAL_PROFILEFILE_HPP_
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <alibabacloud/credential/StringView.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Read-only view of a profile file (INI sections or CLI JSON)
+ *
+ * The file is read into one buffer and searched in a single pass for the
+ * requested section; nothing else is copied until a field's str() is called,
+ * so looking up one profile in a file of thousands costs a read, a scan and
+ * no allocation per entry. Returned fields point into the buffer and are
+ * valid only while the ProfileFile lives.
+ *
+ * The content is a copy: a file rewritten or truncated by another program
+ * after construction does not affect it.
+ */
+class ProfileFile {
+public:
+  struct Field {
+    StringView key;
+    StringView value;      // As written, without JSON quotes
+    bool escaped = false;  // JSON value containing escape sequences
+
+    /**
+     * @brief Decoded value
+     */
+    std::string str() const;
+  };
+  typedef std::vector<Field> Section;
+  typedef std::unordered_map<std::string, Section> Index;  // By section name
+
+  /**
+   * @brief Read `filePath`
+   *
+   * @throw Darabonba::Exception if the file can't be opened
+   */
+  explicit ProfileFile(const std::string &filePath);
+
+  ProfileFile(const ProfileFile &) = delete;
+  ProfileFile &operator=(const ProfileFile &) = delete;
+
+  StringView content() const { return StringView(buffer_); }
+
+  /**
+   * @brief Whether the content is a JSON object
+   */
+  bool isJson() const;
+
+  /**
+   * @brief Fields of INI section `name`
+   *
+   * Sections of the same name are merged. Blank lines and lines starting
+   * with '#' or ';' are skipped; keys and values are trimmed.
+   *
+   * @return false if there is no such section
+   */
+  bool findSection(StringView name, Section &section) const;
+
+  /**
+   * @brief String fields of the first entry named `name` in the `profiles`
+   *        array of a CLI JSON config
+   *
+   * Only the JSON up to the matching profile is read.
+   *
+   * @return false if there is no such profile
+   * @throw Darabonba::Exception if the JSON is malformed or has no
+   *        `profiles` array
+   */
+  bool findJsonProfile(StringView name, Section &section) const;
+
+  /**
+   * @brief Fields of every INI section, by name, read in one pass
+   *
+   * Parsed like findSection().
+   */
+  void indexSections(Index &index) const;
+
+  /**
+   * @brief String fields of every named entry of the `profiles` array of a
+   *        CLI JSON config, by name, read in one pass
+   *
+   * The first entry of a name wins, as with findJsonProfile(). On error the
+   * entries read before it are left in `index`.
+   *
+   * @throw Darabonba::Exception as findJsonProfile()
+   */
+  void indexJsonProfiles(Index &index) const;
+
+  /**
+   * @brief Last field of `key` in `section`, nullptr if absent
+   */
+  static const Field *find(const Section &section, StringView key);
+
+private:
+  std::string buffer_;  // File content
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
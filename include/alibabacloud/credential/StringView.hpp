@@ -0,0 +1,94 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_STRINGVIEW_HPP_
+#define ALIBABACLOUD_CREDENTIAL_STRINGVIEW_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Minimal read-only string view
+ *
+ * Mirrors the subset of std::string_view used by this library. It is the
+ * same type whatever standard the library and its users are built with, so
+ * the ABI and the class definition do not depend on it; C++17 code gets a
+ * std::string_view from toStdStringView().
+ */
+class StringView {
+public:
+  typedef const char *const_iterator;
+  typedef const char *iterator;
+  static const size_t npos = static_cast<size_t>(-1);
+
+  StringView() : data_(nullptr), size_(0) {}
+  StringView(const char *data, size_t size) : data_(data), size_(size) {}
+  StringView(const char *str) : data_(str), size_(str ? std::strlen(str) : 0) {}
+  StringView(const std::string &str) : data_(str.data()), size_(str.size()) {}
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+  size_t length() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const char *begin() const { return data_; }
+  const char *end() const { return data_ + size_; }
+  char operator[](size_t pos) const { return data_[pos]; }
+
+  StringView substr(size_t pos, size_t count = npos) const {
+    if (pos > size_) {
+      throw std::out_of_range("StringView::substr");
+    }
+    return StringView(data_ + pos, std::min(count, size_ - pos));
+  }
+
+  int compare(StringView other) const {
+    size_t n = std::min(size_, other.size_);
+    int result = n == 0 ? 0 : std::memcmp(data_, other.data_, n);
+    if (result != 0) {
+      return result;
+    }
+    return size_ == other.size_ ? 0 : (size_ < other.size_ ? -1 : 1);
+  }
+
+  explicit operator std::string() const { return std::string(data_, size_); }
+
+private:
+  const char *data_;
+  size_t size_;
+};
+
+inline bool operator==(StringView lhs, StringView rhs) {
+  return lhs.compare(rhs) == 0;
+}
+inline bool operator!=(StringView lhs, StringView rhs) {
+  return lhs.compare(rhs) != 0;
+}
+inline bool operator<(StringView lhs, StringView rhs) {
+  return lhs.compare(rhs) < 0;
+}
+
+inline std::ostream &operator<<(std::ostream &os, StringView view) {
+  return os.write(view.data(), static_cast<std::streamsize>(view.size()));
+}
+
+#if __cplusplus >= 201703L
+/**
+ * @brief The same characters as a std::string_view
+ */
+inline std::string_view toStdStringView(StringView view) {
+  return std::string_view(view.data(), view.size());
+}
+#endif
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_TLSSESSIONCACHE_HPP_
+#define ALIBABACLOUD_CREDENTIAL_TLSSESSIONCACHE_HPP_
+
+#include <memory>
+#include <mutex>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief TLS sessions kept for resumption across connections
+ *
+ * Session IDs and session tickets received from an endpoint are stored per
+ * host and port, and offered when a new connection to it is made, so the
+ * reconnect after an idle connection was closed resumes the session (one
+ * round trip, no certificate exchange) instead of a full handshake.
+ *
+ * Connections made through an HttpConnectionPool use the cache of its
+ * options, the process-wide default one unless replaced.
+ */
+class TlsSessionCache {
+public:
+  /**
+   * @brief Get the cache shared by the process
+   */
+  static std::shared_ptr<TlsSessionCache> getDefault();
+
+  TlsSessionCache();
+  ~TlsSessionCache();
+
+  TlsSessionCache(const TlsSessionCache &) = delete;
+  TlsSessionCache &operator=(const TlsSessionCache &) = delete;
+
+  /**
+   * @brief libcurl share handle holding the sessions
+   */
+  void *getHandle() const { return share_; }
+
+private:
+  void *share_;
+  std::mutex mutex_;  // Held by libcurl while it reads or stores a session
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_TOKENFILE_HPP_
+#define ALIBABACLOUD_CREDENTIAL_TOKENFILE_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <alibabacloud/credential/FileStamp.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+class TokenFile;
+
+/**
+ * @brief Background thread noticing changes to TokenFiles
+ *
+ * On Linux the directories of the watched files are watched with inotify, so
+ * a rotation (including Kubernetes' symlink swap of a projected token) is
+ * seen as it happens. Every file is also stat'ed once per poll interval,
+ * which is the only mechanism where inotify is unavailable and catches
+ * changes inotify misses (network file systems, a full watch table).
+ *
+ * The thread is started when the first file is registered.
+ */
+class TokenFileWatcher {
+public:
+  struct Options {
+    int64_t pollIntervalMs = 1000;  // Stat period of every watched file
+    bool inotifyEnabled = true;     // Use inotify where available
+  };
+
+  /**
+   * @brief Get the shared watcher instance
+   */
+  static TokenFileWatcher &getInstance();
+
+  explicit TokenFileWatcher(const Options &options);
+  ~TokenFileWatcher();
+
+  TokenFileWatcher(const TokenFileWatcher &) = delete;
+  TokenFileWatcher &operator=(const TokenFileWatcher &) = delete;
+
+  /**
+   * @brief Whether changes are picked up through inotify
+   */
+  bool usesInotify() const;
+
+private:
+  friend class TokenFile;
+
+  void add(TokenFile *file);
+  void remove(TokenFile *file);
+  void watchDirectory(const std::string &directory);
+  void unwatchDirectory(const std::string &directory);
+  void wake();
+  void run();
+
+  Options options_;
+  std::set<TokenFile *> files_;
+  std::map<std::string, std::pair<int, size_t>>
+      directories_;  // Watch descriptor and number of files per directory
+  std::thread thread_;
+  bool stopping_ = false;
+  int inotifyFd_ = -1;
+  int wakeFds_[2] = {-1, -1};  // Pipe interrupting the poll
+
+  mutable std::mutex mutex_;  // Guards the above; held while checking files
+  std::condition_variable wakeCond_;  // Wakes the thread without a pipe
+};
+
+/**
+ * @brief Contents of a token file, kept in memory and reloaded on change
+ *
+ * The file is read on the first getToken(). After that the watcher reloads
+ * it in the background when its (device, inode, mtime, size) changes, so
+ * getToken() returns the current token without touching the disk. A read
+ * that fails during a rotation keeps the previous token and is retried on
+ * the next check.
+ */
+class TokenFile {
+public:
+  explicit TokenFile(const std::string &path,
+                     TokenFileWatcher &watcher = TokenFileWatcher::getInstance());
+  ~TokenFile();
+
+  TokenFile(const TokenFile &) = delete;
+  TokenFile &operator=(const TokenFile &) = delete;
+
+  const std::string &getPath() const { return path_; }
+
+  /**
+   * @brief Current token
+   *
+   * @throw Darabonba::Exception if the file has never been readable
+   */
+  std::shared_ptr<const std::string> getToken() const;
+
+  /**
+   * @brief Call `listener` on the watcher thread whenever the token changes
+   *
+   * The listener must not block. Once this returns, the previous listener
+   * is neither running nor called again; nullptr removes it.
+   */
+  void setListener(std::function<void()> listener);
+
+private:
+  friend class TokenFileWatcher;
+
+  /**
+   * @brief Reload the token if the file changed (watcher thread)
+   */
+  void check();
+
+  const std::string path_;
+  TokenFileWatcher &watcher_;
+
+  mutable std::mutex mutex_;
+  mutable std::shared_ptr<const std::string> token_;  // nullptr until read
+  mutable FileStamp stamp_;  // Of the file token_ was read from
+
+  std::mutex listenerMutex_;  // Held while the listener runs
+  std::function<void()> listener_;
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
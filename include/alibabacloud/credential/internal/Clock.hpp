@@ -0,0 +1,27 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_INTERNAL_CLOCK_HPP_
+#define ALIBABACLOUD_CREDENTIAL_INTERNAL_CLOCK_HPP_
+
+#include <chrono>
+#include <cstdint>
+
+namespace AlibabaCloud {
+namespace Credential {
+namespace Internal {
+
+/**
+ * @brief Steady clock in milliseconds, for deadlines and revalidation
+ *        intervals
+ *
+ * Not part of the public API.
+ */
+inline int64_t nowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace Internal
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
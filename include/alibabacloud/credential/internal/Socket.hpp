@@ -0,0 +1,57 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_INTERNAL_SOCKET_HPP_
+#define ALIBABACLOUD_CREDENTIAL_INTERNAL_SOCKET_HPP_
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/socket.h>
+
+// macOS has no MSG_NOSIGNAL; its sockets set SO_NOSIGPIPE instead
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace AlibabaCloud {
+namespace Credential {
+namespace Internal {
+
+/**
+ * @brief Add file status flags (O_NONBLOCK) to a descriptor
+ */
+inline bool addStatusFlags(int fd, int flags) {
+  const int current = fcntl(fd, F_GETFL);
+  return current >= 0 && fcntl(fd, F_SETFL, current | flags) == 0;
+}
+
+/**
+ * @brief Mark a descriptor close-on-exec
+ *
+ * Used instead of SOCK_CLOEXEC, pipe2() and accept4(), which are missing on
+ * macOS; the short window before the flag is set only matters to programs
+ * forking from other threads meanwhile.
+ */
+inline bool setCloseOnExec(int fd) {
+  const int current = fcntl(fd, F_GETFD);
+  return current >= 0 && fcntl(fd, F_SETFD, current | FD_CLOEXEC) == 0;
+}
+
+/**
+ * @brief Prepare a new socket: close-on-exec, and no SIGPIPE where
+ *        send() cannot suppress it with MSG_NOSIGNAL
+ */
+inline bool prepareSocket(int fd) {
+#ifdef SO_NOSIGPIPE
+  const int on = 1;
+  if (setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on)) != 0) {
+    return false;
+  }
+#endif
+  return setCloseOnExec(fd);
+}
+
+} // namespace Internal
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
+
+#endif
@@ -17,12 +17,14 @@ public:
     credential_.setAccessKeyId(config->getAccessKeyId())
         .setAccessKeySecret(config->getAccessKeySecret())
         .setType(Constant::ACCESS_KEY);
+    snapshot_ = std::make_shared<const CredentialSnapshot>(credential_);
   }
   AccessKeyProvider(const std::string &accessKeyId,
                     const std::string &accessKeySecret) {
     credential_.setAccessKeyId(accessKeyId)
         .setAccessKeySecret(accessKeySecret)
         .setType(Constant::ACCESS_KEY);
+    snapshot_ = std::make_shared<const CredentialSnapshot>(credential_);
   }
   virtual ~AccessKeyProvider() {}
 
@@ -30,6 +32,12 @@ public:
   virtual const Models::CredentialModel &getCredential() const override {
     return credential_;
   }
+
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    return snapshot_;
+  }
+
+  virtual uint64_t getGeneration() const override { return 1; }  // Never rotates
   
   /**
    * @brief Get provider name
@@ -38,6 +46,7 @@ public:
 
 protected:
   mutable Models::CredentialModel credential_;
+  std::shared_ptr<const CredentialSnapshot> snapshot_;
 };
 } // namespace Credential
 
@@ -0,0 +1,96 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_AGENTPROVIDER_HPP_
+#define ALIBABACLOUD_CREDENTIAL_AGENTPROVIDER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <alibabacloud/credential/AgentProtocol.hpp>
+#include <alibabacloud/credential/provider/Provider.hpp>
+#include <alibabacloud/credential/provider/PublishedValue.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Provider reading credentials from the local credential agent
+ *
+ * A background thread subscribes to the agent (see AgentServer) and
+ * installs every credential it pushes, so getCredential() is a pinned read
+ * with no network, TLS or refresh code involved. If no credential has been
+ * pushed yet or the cached one expired, getCredential() asks the agent
+ * directly and throws if it is unreachable. The subscription reconnects
+ * with backoff when the agent restarts.
+ *
+ * The socket defaults to AgentProtocol::getDefaultSocketPath(). An agent
+ * running as another user than this process (other than root) is never
+ * trusted: its credentials are ignored and a direct request throws.
+ */
+class AgentProvider : public Provider {
+public:
+  static constexpr int64_t DEFAULT_TIMEOUT_MS = 1000;
+  static constexpr int64_t MIN_RECONNECT_MS = 100;
+  static constexpr int64_t MAX_RECONNECT_MS = 5000;
+
+  /**
+   * @param socketPath Agent socket
+   * @param timeoutMs Timeout of a direct request to the agent
+   */
+  explicit AgentProvider(
+      std::string socketPath = AgentProtocol::getDefaultSocketPath(),
+      int64_t timeoutMs = DEFAULT_TIMEOUT_MS);
+  virtual ~AgentProvider();
+
+  AgentProvider(const AgentProvider &) = delete;
+  AgentProvider &operator=(const AgentProvider &) = delete;
+
+  virtual Models::CredentialModel &getCredential() override;
+  virtual const Models::CredentialModel &getCredential() const override;
+
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override;
+
+  virtual uint64_t getGeneration() const override {
+    return generation_.load(std::memory_order_acquire);
+  }
+
+  virtual std::string getProviderName() const override { return "agent"; }
+
+  const std::string &getSocketPath() const { return socketPath_; }
+
+private:
+  struct Published {
+    explicit Published(const AgentProtocol::Credential &received)
+        : credential(received.credential),
+          snapshot(std::make_shared<const CredentialSnapshot>(
+              received.credential, received.expiration)) {}
+    const Models::CredentialModel credential;
+    const std::shared_ptr<const CredentialSnapshot> snapshot;
+  };
+
+  const Published *current() const;
+  void publish(const AgentProtocol::Credential &received) const;
+  void subscribe();
+
+  std::string socketPath_;
+  int64_t timeoutMs_;
+
+  mutable PublishedValue<Published> published_;  // Stored under publishMutex_
+  mutable std::atomic<uint64_t> generation_{0};  // Bumped on new key material
+  mutable std::mutex publishMutex_;
+  mutable std::mutex requestMutex_;  // Single-flight direct requests
+
+  std::mutex subscriptionMutex_;
+  std::condition_variable stopCondition_;
+  bool stopping_ = false;
+  int subscriptionFd_ = -1;
+  std::thread subscriptionThread_;
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
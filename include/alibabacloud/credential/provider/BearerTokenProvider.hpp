@@ -14,9 +14,11 @@ class BearerTokenProvider : public Provider {
 public:
   BearerTokenProvider(std::shared_ptr<Models::Config> config) {
     credential_.setBearerToken(config->getBearerToken()).setType(Constant::BEARER);
+    snapshot_ = std::make_shared<const CredentialSnapshot>(credential_);
   }
   BearerTokenProvider(const std::string &bearToken) {
     credential_.setBearerToken(bearToken).setType(Constant::BEARER);
+    snapshot_ = std::make_shared<const CredentialSnapshot>(credential_);
   }
 
   virtual ~BearerTokenProvider() {}
@@ -25,6 +27,12 @@ public:
   virtual const Models::CredentialModel &getCredential() const override {
     return credential_;
   }
+
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    return snapshot_;
+  }
+
+  virtual uint64_t getGeneration() const override { return 1; }  // Never rotates
   
   /**
    * @brief Get provider name
@@ -33,6 +41,7 @@ public:
 
 protected:
   mutable Models::CredentialModel credential_;
+  std::shared_ptr<const CredentialSnapshot> snapshot_;
 };
 } // namespace Credential
 
@@ -1,11 +1,16 @@
 #ifndef ALIBABACLOUD_CREDENTIAL_CLIPROFILEPROVIDER_HPP_
 #define ALIBABACLOUD_CREDENTIAL_CLIPROFILEPROVIDER_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 
 #include <darabonba/Exception.hpp>
 
+#include <alibabacloud/credential/provider/ProfileRegistry.hpp>
 #include <alibabacloud/credential/provider/Provider.hpp>
+#include <alibabacloud/credential/provider/PublishedValue.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
@@ -27,6 +32,12 @@ namespace Credential {
  * Difference from ProfileProvider:
  * - CLIProfileProvider: Specialized for CLI config files, supports JSON and INI formats
  * - ProfileProvider: General purpose config file provider (maintains backward compatibility)
+ *
+ * Profiles are looked up in a ProfileRegistry, which parses each file once
+ * and shares one provider per profile between all CLIProfileProviders. The
+ * provider in use is revalidated against the registry at most once per its
+ * revalidation interval. A replaced provider lives on until the threads that
+ * called it last call this provider again.
  */
 class CLIProfileProvider : public Provider {
 public:
@@ -43,6 +54,16 @@ public:
    * @param profileName Profile name (e.g. "default", "production")
    */
   explicit CLIProfileProvider(const std::string& profileName);
+
+  /**
+   * @brief Constructor with profile name and registry
+   *
+   * @param profileName Profile name
+   * @param registry Registry to look the profile up in, instead of
+   *                 ProfileRegistry::getDefault()
+   */
+  CLIProfileProvider(const std::string& profileName,
+                     std::shared_ptr<ProfileRegistry> registry);
   
   /**
    * @brief Destructor
@@ -58,22 +79,24 @@ public:
    * @brief Get credential (const version)
    */
   virtual const Models::CredentialModel& getCredential() const override;
+
+  /**
+   * @brief Get an immutable snapshot of the current credential
+   */
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override;
   
   /**
    * @brief Get provider name
    */
   std::string getProviderName() const override;
 
-protected:
   /**
-   * @brief Create actual credential provider
-   * 
-   * Create corresponding Provider based on config file content
-   * 
-   * @return Credential provider pointer
+   * @brief Generation of the provider in use, advanced past the replaced
+   *        provider's when the registry hands out another one
    */
-  std::unique_ptr<Provider> createProvider() const;
-  
+  virtual uint64_t getGeneration() const override;
+
+protected:
   /**
    * @brief Get CLI config file path
    * 
@@ -85,32 +108,17 @@ protected:
    * @return Config file path
    */
   static std::string getCliProfilePath();
-  
-  /**
-   * @brief Parse JSON format config file
-   * 
-   * @param filePath File path
-   * @param profileName Profile name
-   * @return Config object
-   */
-  static std::shared_ptr<Models::Config> parseJsonProfile(
-      const std::string& filePath,
-      const std::string& profileName);
-  
-  /**
-   * @brief Parse INI format config file
-   * 
-   * @param filePath File path
-   * @param profileName Profile name
-   * @return Config object
-   */
-  static std::shared_ptr<Models::Config> parseIniProfile(
-      const std::string& filePath,
-      const std::string& profileName);
 
 private:
+  const Provider &provider() const;
+
   std::string profileName_;                        // Profile name
-  mutable std::unique_ptr<Provider> provider_;     // Actual credential provider
+  std::shared_ptr<ProfileRegistry> registry_;      // Shared profile index
+  mutable PublishedValue<Provider> provider_;      // Actual credential provider
+  mutable std::atomic<int64_t> revalidateAt_{0};   // Steady clock, ms
+  mutable std::mutex lookupMutex_;                 // Guards stores to provider_
+  // Added to the provider's generation, stored after provider_
+  mutable std::atomic<uint64_t> generationBase_{0};
 };
 
 } // namespace Credential
@@ -8,12 +8,12 @@
 
 #include <alibabacloud/credential/Constant.hpp>
 #include <alibabacloud/credential/Model.hpp>
-#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
 
-class CloudSSOCredentialsProvider : public NeedFreshProvider,
+class CloudSSOCredentialsProvider : public RefreshableProvider,
                                      std::enable_shared_from_this<CloudSSOCredentialsProvider> {
 public:
   CloudSSOCredentialsProvider(std::shared_ptr<Models::Config> config)
@@ -23,16 +23,14 @@ public:
         regionId_(config->getRegionId()),
         connectTimeout_(config->hasConnectTimeout() ? config->getConnectTimeout() : 10000),
         readTimeout_(config->hasTimeout() ? config->getTimeout() : 5000) {
-    credential_.setType(Constant::CLOUD_SSO);
+    setHttpTransport(config->getHttpTransport());
   }
 
   CloudSSOCredentialsProvider(const std::string &roleName,
                                const std::string &regionId = "cn-hangzhou")
-      : roleName_(roleName), regionId_(regionId) {
-    credential_.setType(Constant::CLOUD_SSO);
-  }
+      : roleName_(roleName), regionId_(regionId) {}
 
-  virtual ~CloudSSOCredentialsProvider() {}
+  virtual ~CloudSSOCredentialsProvider() { shutdown(); }
   
   /**
    * @brief Get provider name
@@ -40,12 +38,16 @@ public:
   std::string getProviderName() const override { return Constant::CLOUD_SSO; }
 
 private:
-  virtual bool refreshCredential() const override;
+  virtual RefreshResult doRefresh() const override;
+
+  virtual std::string getCacheKey() const override {
+    return CredentialFileCache::makeKey(
+        {getProviderName(), roleName_, regionId_, CLOUD_SSO_ENDPOINT});
+  }
 
   static const std::string CLOUD_SSO_ENDPOINT;
   static const std::string CLOUD_SSO_FETCH_ERROR_MSG;
 
-  mutable Models::CredentialModel credential_;
   std::string roleName_;
   std::string regionId_ = "cn-hangzhou";
   int64_t connectTimeout_ = 10000;  // Connection timeout in milliseconds
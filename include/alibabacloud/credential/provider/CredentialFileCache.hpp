@@ -0,0 +1,102 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_CREDENTIALFILECACHE_HPP_
+#define ALIBABACLOUD_CREDENTIAL_CREDENTIALFILECACHE_HPP_
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+
+#include <alibabacloud/credential/Model.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Opt-in persistent cache of refreshed credentials
+ *
+ * Lets a new process start from the credential an earlier process fetched
+ * instead of a network round trip. Each provider identity (see makeKey())
+ * maps to one file named after the SHA-256 of the key, in a directory
+ * created with mode 0700. Files are written atomically with mode 0600, and
+ * files not owned by the current user or readable by others are ignored.
+ *
+ * With encryption enabled the file is sealed with AES-256-GCM under a key
+ * derived from the machine id and user id, so a copied file is useless on
+ * another host or account.
+ *
+ * Enabled with environment variables:
+ * - ALIBABA_CLOUD_CREDENTIALS_CACHE_DIR: cache directory
+ * - ALIBABA_CLOUD_CREDENTIALS_CACHE_ENCRYPTED: "true" to encrypt files
+ *
+ * Not supported on Windows, where load() and store() always fail.
+ */
+class CredentialFileCache {
+public:
+  struct Options {
+    std::string directory;  // Cache directory, created if missing
+    bool encrypt = false;   // Seal files with a host-derived key
+  };
+
+  /**
+   * @brief A cached credential and its refresh times (seconds timestamps)
+   */
+  struct Entry {
+    Models::CredentialModel credential;
+    int64_t staleTime = 0;
+    int64_t prefetchTime = 0;
+  };
+
+  /**
+   * @brief Shared cache configured from the environment, nullptr if disabled
+   */
+  static std::shared_ptr<CredentialFileCache> getDefault();
+
+  /**
+   * @brief Build a cache key from the parts identifying a provider
+   *
+   * Parts are length-prefixed so different splits never collide. Secrets
+   * may be included; only their hash reaches the file system.
+   */
+  static std::string makeKey(std::initializer_list<std::string> parts);
+
+  explicit CredentialFileCache(const Options &options);
+
+  /**
+   * @brief Read the entry of `key`
+   *
+   * @return false if missing, insecure, corrupt or sealed for another host
+   */
+  bool load(const std::string &key, Entry &entry) const;
+
+  /**
+   * @brief Replace the entry of `key`; errors are swallowed
+   *
+   * @return false if the entry could not be written
+   */
+  bool store(const std::string &key, const Entry &entry) const;
+
+  /**
+   * @brief Remove the entry of `key`
+   */
+  void remove(const std::string &key) const;
+
+  /**
+   * @brief Hex SHA-256 of a key, safe to use in file and object names
+   */
+  static std::string hashKey(const std::string &key);
+
+  /**
+   * @brief Path of the file holding `key`
+   */
+  std::string getPath(const std::string &key) const;
+
+  const Options &getOptions() const { return options_; }
+
+private:
+  Options options_;
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
@@ -1,111 +1,217 @@
 #ifndef ALIBABACLOUD_CREDENTIAL_DEFAULTPROVIDER_HPP_
 #define ALIBABACLOUD_CREDENTIAL_DEFAULTPROVIDER_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <darabonba/Exception.hpp>
 
+#include <alibabacloud/credential/EnvironmentSource.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
 #include <alibabacloud/credential/Model.hpp>
+#include <alibabacloud/credential/internal/Clock.hpp>
 #include <alibabacloud/credential/provider/Provider.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
+/**
+ * @brief Default credentials provider chain
+ *
+ * Tries environment variables, OIDC, the profile file, ECS metadata and the
+ * credentials URI in that order. The first provider that succeeds is
+ * memoized, so steady-state reads are a direct call on it. A provider that
+ * fails is skipped for an exponential backoff (INITIAL_BACKOFF_MS doubling
+ * up to MAX_BACKOFF_MS) before it is probed again; once a failed provider
+ * ranked above the memoized one is due, one caller walks the chain again so
+ * a source that appears later still takes priority, while the others keep
+ * reading the memoized provider. With reuseLastProviderEnabled the memoized
+ * provider is kept until it fails.
+ *
+ * With parallel resolution enabled (config parallelResolutionEnabled or
+ * ALIBABA_CLOUD_CREDENTIALS_PARALLEL_RESOLUTION set to true), resolution
+ * probes all due providers concurrently and picks the highest-priority one
+ * that succeeds once every provider before it has failed, so a cold start
+ * waits for the slowest probe rather than the sum of all timeouts. Probes of
+ * lower-priority providers are not waited for once a winner is known; they
+ * finish in the background, bounded by their providers' own timeouts, and
+ * keep the provider they probe alive. A provider still being probed that way
+ * is not probed again.
+ *
+ * The chain is configured from one EnvironmentSource, which the environment
+ * variable and ECS providers read as well: by default a snapshot of the
+ * process environment taken at construction. The OIDC, ECS and URL
+ * providers send their requests through the config's httpTransport.
+ */
 class DefaultProvider : public Provider {
 public:
-  DefaultProvider();
-  explicit DefaultProvider(std::shared_ptr<Models::Config> config);
+  static constexpr int64_t INITIAL_BACKOFF_MS = 1000;  // After a first failure
+  static constexpr int64_t MAX_BACKOFF_MS = 300000;
 
-  virtual ~DefaultProvider() = default;
+  /**
+   * @param environment Variables the chain is configured from, nullptr for a
+   *                    snapshot of the process environment taken now
+   */
+  explicit DefaultProvider(
+      std::shared_ptr<const EnvironmentSource> environment = nullptr);
+  explicit DefaultProvider(
+      std::shared_ptr<Models::Config> config,
+      std::shared_ptr<const EnvironmentSource> environment = nullptr);
 
   virtual Models::CredentialModel &getCredential() override {
-    // If reuse enabled and we have a cached successful provider
-    if (reuseLastProviderEnabled_ && lastSuccessfulProvider_) {
-      try {
-        return lastSuccessfulProvider_->getCredential();
-      } catch (Darabonba::Exception&) {
-        // Cache failed, continue trying all providers
-        lastSuccessfulProvider_ = nullptr;
-      }
-    }
-
-    for (auto &provider : providers_) {
-      if (provider) {
-        try {
-          auto& credential = provider->getCredential();
-          if (reuseLastProviderEnabled_) {
-            lastSuccessfulProvider_ = provider.get();
-          }
-          return credential;
-        } catch (Darabonba::Exception& e) {
-          continue;
-        }
-      }
-    }
-    throw Darabonba::Exception("Can't get the credential.");
+    return const_cast<Models::CredentialModel &>(
+        static_cast<const DefaultProvider *>(this)->getCredential());
   }
-  
+
   virtual const Models::CredentialModel &getCredential() const override {
-    // If reuse enabled and we have a cached successful provider
-    if (reuseLastProviderEnabled_ && lastSuccessfulProvider_) {
+    Provider *provider = cachedProvider();
+    if (provider != nullptr) {
       try {
-        return lastSuccessfulProvider_->getCredential();
-      } catch (Darabonba::Exception&) {
-        // Cache failed, continue trying all providers
-        lastSuccessfulProvider_ = nullptr;
+        return provider->getCredential();
+      } catch (Darabonba::Exception &) {
+        markFailed(provider);
       }
     }
+    return resolve()->getCredential();
+  }
 
-    for (auto &provider : providers_) {
-      if (provider) {
-        try {
-          auto& credential = provider->getCredential();
-          if (reuseLastProviderEnabled_) {
-            lastSuccessfulProvider_ = provider.get();
-          }
-          return credential;
-        } catch (Darabonba::Exception& e) {
-          continue;
-        }
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    Provider *provider = cachedProvider();
+    if (provider != nullptr) {
+      try {
+        return provider->getSnapshot();
+      } catch (Darabonba::Exception &) {
+        markFailed(provider);
       }
     }
-    throw Darabonba::Exception("Can't get the credential.");
+    return resolve()->getSnapshot();
   }
-  
+
   /**
-   * @brief Get provider name
+   * @brief Name of the provider that supplies the credential
+   *
+   * Resolves the chain if no provider has succeeded yet.
    */
   std::string getProviderName() const override {
-    // If reuse enabled and we have a cached successful provider
-    if (reuseLastProviderEnabled_ && lastSuccessfulProvider_) {
-      try {
-        return lastSuccessfulProvider_->getProviderName();
-      } catch (Darabonba::Exception&) {
-        // Cache failed, continue trying all providers
-        lastSuccessfulProvider_ = nullptr;
+    Provider *provider = nullptr;
+    try {
+      provider = cachedProvider();
+      if (provider == nullptr) {
+        provider = resolve();
       }
+    } catch (Darabonba::Exception &) {
+      throw Darabonba::Exception("Can't get the provider name.");
     }
+    return provider->getProviderName();
+  }
 
-    for (auto &provider : providers_) {
-      if (provider) {
-        try {
-          auto name = provider->getProviderName();
-          if (reuseLastProviderEnabled_) {
-            lastSuccessfulProvider_ = provider.get();
-          }
-          return name;
-        } catch (Darabonba::Exception& e) {
-          continue;
-        }
-      }
-    }
-    throw Darabonba::Exception("Can't get the provider name.");
+  /**
+   * @brief Generation of the memoized provider, advanced past the previous
+   *        winner's when resolution picks another provider
+   *
+   * @return 0 until the chain has been resolved
+   */
+  virtual uint64_t getGeneration() const override {
+    // The base is stored after the winner: a reader seeing the new base also
+    // sees the new winner
+    const uint64_t base = generationBase_.load(std::memory_order_acquire);
+    const Provider *provider = generationProvider_.load(std::memory_order_acquire);
+    return provider != nullptr ? base + provider->getGeneration() : 0;
   }
 
 protected:
-  std::vector<std::unique_ptr<Provider>> providers_;
+  /**
+   * @brief Probe the due providers and memoize the winner
+   *
+   * @return Highest-priority provider that succeeded
+   * @throw Darabonba::Exception if every provider failed or is backing off
+   */
+  Provider *resolve() const;
+
+  std::vector<std::shared_ptr<Provider>> providers_;  // Shared with probes
   bool reuseLastProviderEnabled_ = false;
-  mutable Provider* lastSuccessfulProvider_ = nullptr;
+  bool parallelResolutionEnabled_ = false;
+  // Atomic: request threads read it while another thread resolves
+  mutable std::atomic<Provider *> lastSuccessfulProvider_{nullptr};
+
+private:
+  /**
+   * @brief Negative cache entry of one provider
+   */
+  struct ProbeState {
+    int64_t retryAt = 0;  // Steady clock ms before which it is skipped
+    int failures = 0;     // Consecutive failures
+  };
+
+  /**
+   * @brief Whether a provider ranked above the memoized one is due for a
+   *        retry
+   */
+  bool reprobeDue() const {
+    if (reuseLastProviderEnabled_) {
+      return false;
+    }
+    // INT64_MAX: the winner ranks first or nothing above it failed, so the
+    // steady state reads no clock
+    const int64_t reprobeAt = reprobeAt_.load(std::memory_order_relaxed);
+    return reprobeAt != INT64_MAX && Internal::nowMs() >= reprobeAt;
+  }
+
+  /**
+   * @brief Memoized provider, nullptr if the chain must be resolved
+   *
+   * When a retry is due, the caller that gets resolveMutex_ re-probes the
+   * chain; callers arriving meanwhile keep the memoized provider instead of
+   * waiting for the probes.
+   *
+   * @throw Darabonba::Exception if the re-probe finds no provider
+   */
+  Provider *cachedProvider() const {
+    Provider *provider = lastSuccessfulProvider_.load(std::memory_order_acquire);
+    if (provider == nullptr || !reprobeDue()) {
+      return provider;
+    }
+    std::unique_lock<std::mutex> lock(resolveMutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      return provider;
+    }
+    if (!reprobeDue()) {
+      // Resolved by the previous lock holder
+      return lastSuccessfulProvider_.load(std::memory_order_acquire);
+    }
+    return probeChain();
+  }
+
+  /**
+   * @brief Append the providers `environment` configures, in priority order
+   */
+  void addProviders(const std::shared_ptr<const EnvironmentSource> &environment,
+                    const std::shared_ptr<HttpTransport> &transport);
+  void markFailed(Provider *provider) const;
+  Provider *probeChain() const;  // Requires resolveMutex_
+  void recordFailure(size_t index, int64_t now) const;
+  int probeInOrder(const std::vector<bool> &due) const;
+  int probeInParallel(const std::vector<bool> &due) const;
+
+  mutable std::mutex resolveMutex_;  // One resolution at a time
+  mutable std::vector<ProbeState> probeStates_;  // Guarded by resolveMutex_
+  mutable std::atomic<int64_t> reprobeAt_{0};  // First retry ranked above the winner
+  // Last winner, kept while the chain is re-resolved; stored under resolveMutex_
+  mutable std::atomic<const Provider *> generationProvider_{nullptr};
+  mutable std::atomic<uint64_t> generationBase_{0};  // Stored after generationProvider_
+  /**
+   * @brief Providers being probed by detached threads, shared with them
+   */
+  struct RunningProbes {
+    std::mutex mutex;
+    std::vector<bool> running;  // By provider index
+  };
+
+  const std::shared_ptr<RunningProbes> runningProbes_ =
+      std::make_shared<RunningProbes>();
 };
 } // namespace Credential
 
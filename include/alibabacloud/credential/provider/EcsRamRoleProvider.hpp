@@ -2,10 +2,13 @@
 #define ALIBABACLOUD_CREDENTIAL_EcsRamRoleProvider_HPP_
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/EnvironmentSource.hpp>
 #include <alibabacloud/credential/Model.hpp>
 #include <alibabacloud/credential/provider/RefreshableProvider.hpp>
 
@@ -31,6 +34,7 @@ public:
   static constexpr int DEFAULT_METADATA_TOKEN_DURATION = 21600;  // 6 hours
   static constexpr int DEFAULT_CONNECT_TIMEOUT = 1000;            // 1 second
   static constexpr int DEFAULT_READ_TIMEOUT = 1000;               // 1 second
+  static constexpr int METADATA_TOKEN_RENEW_BEFORE = 600;         // Seconds before the token TTL
 
   /**
    * @brief Construct with config
@@ -39,12 +43,14 @@ public:
    * @param asyncUpdateEnabled Enable async update (default true, corresponds to Python async_update_enabled)
    * @param behavior Stale value policy (default ALLOW, corresponds to Python)
    * @param strategy Refresh strategy (default NonBlocking, corresponds to Python)
+   * @param environment Variables to read, nullptr for the process environment
    */
   EcsRamRoleProvider(
       std::shared_ptr<Models::Config> config,
       bool asyncUpdateEnabled = true,
       StaleValueBehavior behavior = StaleValueBehavior::ALLOW_,
-      std::shared_ptr<PrefetchStrategy> strategy = std::make_shared<NonBlockingPrefetch>());
+      std::shared_ptr<PrefetchStrategy> strategy = std::make_shared<NonBlockingPrefetch>(),
+      std::shared_ptr<const EnvironmentSource> environment = nullptr);
 
   /**
    * @brief Construct with role name
@@ -54,15 +60,17 @@ public:
    * @param asyncUpdateEnabled Enable async update
    * @param behavior Stale value policy
    * @param strategy Refresh strategy
+   * @param environment Variables to read, nullptr for the process environment
    */
   EcsRamRoleProvider(
       const std::string& roleName = "",
       bool disableIMDSv1 = false,
       bool asyncUpdateEnabled = true,
       StaleValueBehavior behavior = StaleValueBehavior::ALLOW_,
-      std::shared_ptr<PrefetchStrategy> strategy = std::make_shared<NonBlockingPrefetch>());
+      std::shared_ptr<PrefetchStrategy> strategy = std::make_shared<NonBlockingPrefetch>(),
+      std::shared_ptr<const EnvironmentSource> environment = nullptr);
 
-  virtual ~EcsRamRoleProvider() = default;
+  virtual ~EcsRamRoleProvider() { shutdown(); }
 
   /**
    * @brief Get provider name (corresponds to Python get_provider_name)
@@ -75,6 +83,11 @@ protected:
    */
   virtual RefreshResult doRefresh() const override;
 
+  virtual std::string getCacheKey() const override {
+    // Not roleName_: doRefresh() fills it in when the role is discovered
+    return CredentialFileCache::makeKey({getProviderName(), configuredRoleName_});
+  }
+
   /**
    * @brief Calculate stale_time (corresponds to Python _get_stale_time)
    * 
@@ -87,11 +100,33 @@ protected:
   /**
    * @brief Calculate prefetch_time (corresponds to Python _get_prefetch_time)
    *
-   * Python logic:
    * - If expiration < 0: return now + 5 minutes
-   * - Otherwise: return now + 60 minutes
+   * - Otherwise: the RefreshPolicy prefetch time, adapted to refresh latency
+   *   and no later than getStaleTime()
+   */
+  int64_t getPrefetchTime(int64_t expiration) const;
+
+  /**
+   * @brief IMDSv2 token shared by role discovery and credential fetches
+   *
+   * Cached until METADATA_TOKEN_RENEW_BEFORE seconds before its TTL, so a
+   * steady-state refresh sends no token request. Empty when falling back to
+   * IMDSv1; that is not cached.
+   */
+  std::string getMetadataToken() const;
+
+  /**
+   * @brief Drop the cached IMDSv2 token
+   */
+  void invalidateMetadataToken() const;
+
+  /**
+   * @brief Request a new IMDSv2 token (corresponds to Python _get_metadata_token)
+   *
+   * @return Empty to fall back to IMDSv1
+   * @throw Darabonba::Exception if the request fails and IMDSv1 is disabled
    */
-  static int64_t getPrefetchTime(int64_t expiration);
+  virtual std::string fetchMetadataToken() const;
 
 private:
   /**
@@ -100,9 +135,14 @@ private:
   std::string getRoleName() const;
 
   /**
-   * @brief Get IMDSv2 Token (corresponds to Python _get_metadata_token)
+   * @brief GET `url` from the metadata service with the IMDSv2 token
+   *
+   * A 401 means the token was rejected: it is dropped and the request sent
+   * once more with a new one.
+   *
+   * @return HTTP status code; the response body is stored in `body`
    */
-  std::string getMetadataToken() const;
+  int getMetadata(const std::string &url, std::string &body) const;
 
   // URL constants
   static const std::string URL_IN_ECS_META_DATA;
@@ -115,11 +155,16 @@ private:
 
   // Member variables
   mutable std::string roleName_;           // Role name
+  std::string configuredRoleName_;         // Role name before discovery
   mutable bool disableIMDSv1_;             // Disable IMDSv1
   mutable std::atomic<bool> shouldRefresh_; // Refresh flag (corresponds to Python _should_refresh)
   bool asyncUpdateEnabled_;                 // Enable async update
   int64_t connectTimeout_;                  // Connection timeout
   int64_t readTimeout_;                     // Read timeout
+
+  mutable std::mutex metadataTokenMutex_;   // Held while a token is fetched
+  mutable std::string metadataToken_;       // Guarded by metadataTokenMutex_
+  mutable int64_t metadataTokenRenewAt_ = 0; // Steady clock ms, 0 if none cached
 };
 
 } // namespace Credential
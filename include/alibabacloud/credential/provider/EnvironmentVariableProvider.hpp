@@ -1,54 +1,93 @@
 #ifndef ALIBABACLOUD_CREDENTIAL_ENVIRONMENTVARIABLEPROVIDER_HPP_
 #define ALIBABACLOUD_CREDENTIAL_ENVIRONMENTVARIABLEPROVIDER_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
 
 #include <darabonba/Exception.hpp>
 
 #include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/EnvironmentSource.hpp>
 #include <alibabacloud/credential/Model.hpp>
 #include <alibabacloud/credential/provider/Provider.hpp>
+#include <alibabacloud/credential/provider/PublishedValue.hpp>
 namespace AlibabaCloud {
 
 namespace Credential {
 
+/**
+ * @brief Credential from ALIBABA_CLOUD_ACCESS_KEY_ID,
+ *        ALIBABA_CLOUD_ACCESS_KEY_SECRET and ALIBABA_CLOUD_SECURITY_TOKEN
+ *
+ * The variables are read from an EnvironmentSource and the access key or STS
+ * provider built from them is kept, so a call is a version check and a
+ * direct read of that provider. It is rebuilt only after the source is
+ * reloaded with different variables; a failure is cached the same way. A
+ * replaced provider lives on until the threads that called it last call
+ * this provider again.
+ */
 class EnvironmentVariableProvider : public Provider {
 public:
-  EnvironmentVariableProvider() = default;
+  /**
+   * @param environment Variables to read, nullptr for a snapshot of the
+   *                    process environment taken now
+   */
+  explicit EnvironmentVariableProvider(
+      std::shared_ptr<const EnvironmentSource> environment = nullptr)
+      : environment_(environment ? std::move(environment)
+                                 : EnvironmentSource::fromProcess()) {}
   virtual ~EnvironmentVariableProvider() {}
 
+  EnvironmentVariableProvider(const EnvironmentVariableProvider &) = delete;
+  EnvironmentVariableProvider &
+  operator=(const EnvironmentVariableProvider &) = delete;
+
   virtual Models::CredentialModel &getCredential() override {
-    provider_ = createProvider();
-    if (provider_ == nullptr) {
-      throw Darabonba::Exception("Can't create the ProfileProvider.");
-    }
-    return provider_->getCredential();
+    return const_cast<Models::CredentialModel &>(provider().getCredential());
   }
 
   virtual const Models::CredentialModel &getCredential() const override {
-    provider_ = createProvider();
-    if (provider_ == nullptr) {
-      throw Darabonba::Exception("Can't create the ProfileProvider.");
-    }
-    return provider_->getCredential();
+    return provider().getCredential();
   }
-  
+
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    return provider().getSnapshot();
+  }
+
   /**
    * @brief Get provider name
    */
   std::string getProviderName() const override {
-    provider_ = createProvider();
-    if (provider_ == nullptr) {
-      throw Darabonba::Exception("Can't create the ProfileProvider.");
-    }
-    return provider_->getProviderName();
+    return provider().getProviderName();
   }
 
+  /**
+   * @brief Generation of the provider in use, advanced past the replaced
+   *        provider's when the variables change
+   */
+  virtual uint64_t getGeneration() const override;
+
 protected:
-  static std::unique_ptr<Provider> createProvider();
+  static std::unique_ptr<Provider>
+  createProvider(const EnvironmentSource &environment);
+
+private:
+  struct Loaded {
+    uint64_t version = 0;
+    std::unique_ptr<Provider> provider;  // nullptr if the variables are unusable
+    std::string error;
+    uint64_t generationBase = 0;  // Added to the provider's generation
+  };
+
+  const Provider &provider() const;
+  const Loaded *current() const;
 
-  mutable std::unique_ptr<Provider> provider_ = nullptr;
-  mutable Models::CredentialModel credential_;
+  std::shared_ptr<const EnvironmentSource> environment_;
+  mutable PublishedValue<Loaded> loaded_;  // Stored under loadMutex_
+  mutable std::mutex loadMutex_;
 };
 
 } // namespace Credential
@@ -1,42 +1,206 @@
 #ifndef ALIBABACLOUD_CREDENTIAL_NEEDFRESHPROVIDER_HPP_
 #define ALIBABACLOUD_CREDENTIAL_NEEDFRESHPROVIDER_HPP_
 
+#include <atomic>
 #include <ctime>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <iomanip>
 
+#include <alibabacloud/credential/provider/CredentialFileCache.hpp>
 #include <alibabacloud/credential/provider/Provider.hpp>
+#include <alibabacloud/credential/provider/PublishedValue.hpp>
+#include <alibabacloud/credential/provider/RefreshPolicy.hpp>
 namespace AlibabaCloud {
 namespace Credential {
+/**
+ * @brief Base class for providers that refresh synchronously near expiration
+ *
+ * Refreshes are single-flight: one caller runs refreshCredential() while the
+ * others keep reading the last published credential if it has not expired
+ * yet, or wait for the in-flight refresh otherwise. refreshCredential() fills
+ * credential_ under the refresh lock; readers only ever see an immutable copy
+ * published after the refresh completed, pinned until their next call.
+ *
+ * Timing follows a RefreshPolicy: a refresh is required once the credential
+ * is stale, and attempted early from the policy's prefetch time. A failed
+ * early refresh keeps serving the still valid credential.
+ */
 class NeedFreshProvider : public Provider {
 public:
   NeedFreshProvider() = default;
   NeedFreshProvider(long long expiration) : expiration_(expiration) {}
+  explicit NeedFreshProvider(std::shared_ptr<const RefreshPolicy> refreshPolicy)
+      : refreshPolicy_(refreshPolicy != nullptr ? std::move(refreshPolicy)
+                                                : RefreshPolicy::getDefault()) {}
   virtual ~NeedFreshProvider() {}
 
   virtual Models::CredentialModel &getCredential() override {
-    refresh();
-    return credential_;
+    return const_cast<Models::CredentialModel &>(
+        static_cast<const NeedFreshProvider *>(this)->getCredential());
+  }
+  virtual const Models::CredentialModel &getCredential() const override {
+    return current()->credential;
+  }
+
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    return current()->snapshot;
+  }
+
+  /**
+   * @brief Generation of the published credential (no refresh, no lock)
+   */
+  virtual uint64_t getGeneration() const override {
+    return generation_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Use a persistent cache (default CredentialFileCache::getDefault())
+   *
+   * Must be called before the first getCredential(); nullptr disables it.
+   */
+  void setCredentialFileCache(std::shared_ptr<CredentialFileCache> fileCache) {
+    fileCache_ = std::move(fileCache);
   }
-   virtual const Models::CredentialModel &getCredential() const override {
-     refresh();
-     return credential_;
-   }
 
 protected:
   virtual bool needFresh() const {
-    auto now = static_cast<decltype(expiration_)>(time(nullptr));
-    return expiration_ - now <= 180;
+    auto now = static_cast<int64_t>(time(nullptr));
+    return refreshPolicy_->needsRefresh(now, refreshedAt_.load(), expiration_);
   }
 
   virtual bool refreshCredential() const = 0;
 
+  /**
+   * @brief Identity keying this provider's CredentialFileCache entry
+   *
+   * Empty, the default, disables the file cache.
+   */
+  virtual std::string getCacheKey() const { return ""; }
+
   virtual void refresh() const {
-    if (needFresh()) {
+    if (!needFresh()) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(refreshMutex_, std::defer_lock);
+    auto now = static_cast<int64_t>(time(nullptr));
+    if (published_.load() != nullptr && expiration_ > now) {
+      // Still valid: serve it rather than queueing behind another refresh
+      if (!lock.try_lock()) {
+        return;
+      }
+    } else {
+      lock.lock();
+    }
+    // Double check: another caller may have refreshed while we waited
+    if (!needFresh()) {
+      return;
+    }
+    const bool stale = now >= refreshPolicy_->getStaleTime(expiration_);
+    if (published_.load() == nullptr && loadFileCache()) {
+      publish();
+      return;
+    }
+    try {
       refreshCredential();
+    } catch (...) {
+      if (stale || published_.load() == nullptr) {
+        throw;
+      }
+      // Early refresh failed: keep the valid credential and retry after
+      // another share of its remaining lifetime
+      refreshedAt_ = now;
+      return;
+    }
+    publish();
+    storeFileCache();
+  }
+
+private:
+  /**
+   * @brief A published credential and its snapshot
+   */
+  struct Published {
+    explicit Published(const Models::CredentialModel &cred, int64_t expiration)
+        : credential(cred),
+          snapshot(std::make_shared<const CredentialSnapshot>(cred, expiration)) {}
+    const Models::CredentialModel credential;
+    const std::shared_ptr<const CredentialSnapshot> snapshot;
+  };
+
+  /**
+   * @brief Load a still valid credential_ from the file cache
+   */
+  bool loadFileCache() const {
+    if (fileCache_ == nullptr) {
+      return false;
+    }
+    const std::string key = getCacheKey();
+    CredentialFileCache::Entry entry;
+    if (key.empty() || !fileCache_->load(key, entry) ||
+        static_cast<int64_t>(time(nullptr)) >= entry.staleTime) {
+      return false;
+    }
+    credential_ = entry.credential;
+    expiration_ = entry.staleTime + refreshPolicy_->getOptions().staleLeadSeconds;
+    return true;
+  }
+
+  /**
+   * @brief Write the refreshed credential_ to the file cache
+   */
+  void storeFileCache() const {
+    if (fileCache_ == nullptr) {
+      return;
+    }
+    const std::string key = getCacheKey();
+    if (key.empty()) {
+      return;
+    }
+    CredentialFileCache::Entry entry;
+    entry.credential = credential_;
+    entry.staleTime = refreshPolicy_->getStaleTime(expiration_);
+    entry.prefetchTime = refreshPolicy_->getPrefetchTime(
+        static_cast<int64_t>(time(nullptr)), expiration_);
+    fileCache_->store(key, entry);
+  }
+
+  /**
+   * @brief Refresh if needed and return the published credential
+   */
+  const Published *current() const {
+    refresh();
+    const Published *current = published_.pin();
+    if (current == nullptr) {
+      std::lock_guard<std::mutex> lock(refreshMutex_);
+      if (published_.load() == nullptr) {
+        publish();
+      }
+      current = published_.pin();
+    }
+    return current;
+  }
+
+  /**
+   * @brief Publish a copy of credential_ (caller holds refreshMutex_)
+   */
+  void publish() const {
+    const std::shared_ptr<const Published> previous = published_.load();
+    auto next = std::make_shared<const Published>(credential_, expiration_.load());
+    refreshedAt_ = static_cast<int64_t>(time(nullptr));
+    published_.store(next);
+    // Bump after publishing so a reader that sees the new generation also
+    // sees the new credential
+    if (previous == nullptr ||
+        !sameKeyMaterial(previous->credential, next->credential)) {
+      generation_.fetch_add(1, std::memory_order_release);
+      bumpEpoch();
     }
   }
 
+protected:
+
   static int64_t strtotime(const std::string &gmt) {
 #ifndef _WIN32
     tm tm{};
@@ -79,8 +243,16 @@ protected:
 #endif
   }
 
-  mutable Models::CredentialModel credential_;
-  mutable int64_t expiration_ = 0;
+  mutable Models::CredentialModel credential_;  // Written by refreshCredential()
+  mutable std::atomic<int64_t> expiration_{0};
+  std::shared_ptr<const RefreshPolicy> refreshPolicy_ = RefreshPolicy::getDefault();
+  std::shared_ptr<CredentialFileCache> fileCache_ = CredentialFileCache::getDefault();
+
+private:
+  mutable PublishedValue<Published> published_;  // Stored under refreshMutex_
+  mutable std::atomic<uint64_t> generation_{0};  // Bumped on new key material
+  mutable std::atomic<int64_t> refreshedAt_{0};  // Last refresh attempt, 0 if none
+  mutable std::mutex refreshMutex_;
 };
 } // namespace Credential
 } // namespace AlibabaCloud
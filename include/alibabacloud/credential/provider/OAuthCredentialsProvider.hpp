@@ -8,12 +8,12 @@
 
 #include <alibabacloud/credential/Constant.hpp>
 #include <alibabacloud/credential/Model.hpp>
-#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
 
-class OAuthCredentialsProvider : public NeedFreshProvider,
+class OAuthCredentialsProvider : public RefreshableProvider,
                                   std::enable_shared_from_this<OAuthCredentialsProvider> {
 public:
   OAuthCredentialsProvider(std::shared_ptr<Models::Config> config)
@@ -29,7 +29,7 @@ public:
         regionId_(config->getRegionId()),
         connectTimeout_(config->hasConnectTimeout() ? config->getConnectTimeout() : 10000),
         readTimeout_(config->hasTimeout() ? config->getTimeout() : 5000) {
-    credential_.setType(Constant::OAUTH);
+    setHttpTransport(config->getHttpTransport());
   }
 
   OAuthCredentialsProvider(const std::string &clientId,
@@ -37,11 +37,9 @@ public:
                             const std::string &tokenEndpoint,
                             const std::string &regionId = "cn-hangzhou")
       : clientId_(clientId), clientSecret_(clientSecret),
-        tokenEndpoint_(tokenEndpoint), regionId_(regionId) {
-    credential_.setType(Constant::OAUTH);
-  }
+        tokenEndpoint_(tokenEndpoint), regionId_(regionId) {}
 
-  virtual ~OAuthCredentialsProvider() {}
+  virtual ~OAuthCredentialsProvider() { shutdown(); }
   
   /**
    * @brief Get provider name
@@ -49,11 +47,15 @@ public:
   std::string getProviderName() const override { return Constant::OAUTH; }
 
 private:
-  virtual bool refreshCredential() const override;
+  virtual RefreshResult doRefresh() const override;
+
+  virtual std::string getCacheKey() const override {
+    return CredentialFileCache::makeKey(
+        {getProviderName(), clientId_, tokenEndpoint_, regionId_});
+  }
 
   static const std::string OAUTH_FETCH_ERROR_MSG;
 
-  mutable Models::CredentialModel credential_;
   std::string clientId_;
   std::string clientSecret_;
   std::string tokenEndpoint_;
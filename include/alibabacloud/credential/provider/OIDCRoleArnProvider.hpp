@@ -1,51 +1,37 @@
 #ifndef ALIBABACLOUD_CREDENTIAL_OIDCROLEARNPROVIDER_HPP_
 #define ALIBABACLOUD_CREDENTIAL_OIDCROLEARNPROVIDER_HPP_
 
-#include <darabonba/Env.hpp>
+#include <memory>
 
 #include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/EnvironmentSource.hpp>
 #include <alibabacloud/credential/Model.hpp>
-#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/TokenFile.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
 #include <alibabacloud/credential/provider/Provider.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
 
-class OIDCRoleArnProvider : public NeedFreshProvider,
+/**
+ * @brief Credential from AssumeRoleWithOIDC
+ *
+ * The OIDC token is read from the token file once and kept in memory; a
+ * TokenFile reloads it in the background when the file is rotated, so a
+ * refresh does not read the disk. With setRefreshOnTokenRotation(true) a
+ * rotation also fetches a new credential right away instead of at the
+ * prefetch time.
+ */
+class OIDCRoleArnProvider : public RefreshableProvider,
                            std::enable_shared_from_this<OIDCRoleArnProvider>{
 public:
-  OIDCRoleArnProvider(std::shared_ptr<Models::Config> config)
-      : roleArn_(config->hasRoleArn() && !config->getRoleArn().empty()
-                     ? config->getRoleArn()
-                     : Darabonba::Env::getEnv(Constant::ENV_ROLE_ARN)),
-        oidcProviderArn_(config->hasOidcProviderArn() && !config->getOidcProviderArn().empty()
-                             ? config->getOidcProviderArn()
-                             : Darabonba::Env::getEnv(Constant::ENV_OIDC_PROVIDER_ARN)),
-        oidcTokenFilePath_(config->hasOidcTokenFilePath() && !config->getOidcTokenFilePath().empty()
-                               ? config->getOidcTokenFilePath()
-                               : Darabonba::Env::getEnv(Constant::ENV_OIDC_TOKEN_FILE)),
-        roleSessionName_(config->hasRoleSessionName() && !config->getRoleSessionName().empty()
-                             ? config->getRoleSessionName()
-                             : (Darabonba::Env::getEnv(Constant::ENV_ROLE_SESSION_NAME).empty()
-                                    ? "defaultSessionName"
-                                    : Darabonba::Env::getEnv(Constant::ENV_ROLE_SESSION_NAME))),
-        policy_(config->hasPolicy()
-                    ? std::make_shared<std::string>(config->getPolicy())
-                    : nullptr),
-        durationSeconds_(config->getDurationSeconds()),
-        regionId_(config->hasStsRegionId() && !config->getStsRegionId().empty()
-                      ? config->getStsRegionId()
-                      : (Darabonba::Env::getEnv(Constant::ENV_STS_REGION).empty()
-                             ? config->getRegionId()
-                             : Darabonba::Env::getEnv(Constant::ENV_STS_REGION))),
-        stsEndpoint_(config->getStsEndpoint()),
-        enableVpc_(config->hasEnableVpc()
-                       ? config->getEnableVpc()
-                       : (Darabonba::Env::getEnv(Constant::ENV_VPC_ENDPOINT_ENABLED) == "true")),
-        connectTimeout_(config->hasConnectTimeout() ? config->getConnectTimeout() : 10000),
-        readTimeout_(config->hasTimeout() ? config->getTimeout() : 5000) {
-    credential_.setType(Constant::OIDC_ROLE_ARN);
-  }
+  /**
+   * @param environment Variables read for settings the config leaves empty,
+   *                    nullptr for a snapshot of the process environment
+   */
+  explicit OIDCRoleArnProvider(
+      std::shared_ptr<Models::Config> config,
+      std::shared_ptr<const EnvironmentSource> environment = nullptr);
 
   OIDCRoleArnProvider(const std::string &roleArn,
                       const std::string &oidcProviderArn,
@@ -59,19 +45,39 @@ public:
         oidcTokenFilePath_(oidcTokenFilePath),
         roleSessionName_(roleSessionName), policy_(policy),
         durationSeconds_(durationSeconds), regionId_(regionId),
-        stsEndpoint_(stsEndpoint) {
-    credential_.setType(Constant::OIDC_ROLE_ARN);
+        stsEndpoint_(stsEndpoint), tokenFile_(new TokenFile(oidcTokenFilePath_)) {}
+  virtual ~OIDCRoleArnProvider() {
+    // No rotation may queue a refresh once shutdown() drained them
+    tokenFile_->setListener(nullptr);
+    shutdown();
+  }
+
+  /**
+   * @brief Fetch a new credential in the background as soon as the token
+   *        file is rotated (default off)
+   */
+  void setRefreshOnTokenRotation(bool enabled) {
+    if (enabled) {
+      tokenFile_->setListener([this]() { requestRefresh(); });
+    } else {
+      tokenFile_->setListener(nullptr);
+    }
   }
-  virtual ~OIDCRoleArnProvider() = default;
-  
+
   /**
    * @brief Get provider name
    */
   std::string getProviderName() const override { return Constant::OIDC_ROLE_ARN; }
 
 protected:
-  virtual bool refreshCredential() const override;
-  mutable Models::CredentialModel credential_;
+  virtual RefreshResult doRefresh() const override;
+
+  virtual std::string getCacheKey() const override {
+    return CredentialFileCache::makeKey(
+        {getProviderName(), roleArn_, oidcProviderArn_, oidcTokenFilePath_,
+         roleSessionName_, policy_ ? *policy_ : "",
+         std::to_string(durationSeconds_), stsEndpoint_});
+  }
 
   std::string roleArn_;
   std::string oidcProviderArn_;
@@ -84,6 +90,7 @@ protected:
   bool enableVpc_ = false;
   int64_t connectTimeout_ = 10000;  // Connection timeout in milliseconds
   int64_t readTimeout_ = 5000;      // Read timeout in milliseconds
+  std::unique_ptr<TokenFile> tokenFile_;  // Token at oidcTokenFilePath_
 };
 } // namespace Credential
 } // namespace AlibabaCloud
@@ -1,50 +1,114 @@
 #ifndef ALIBABACLOUD_CREDENTIAL_PROFILEPROVIDER_HPP_
 #define ALIBABACLOUD_CREDENTIAL_PROFILEPROVIDER_HPP_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
 
 #include <darabonba/Exception.hpp>
 
+#include <alibabacloud/credential/FileStamp.hpp>
 #include <alibabacloud/credential/provider/Provider.hpp>
+#include <alibabacloud/credential/provider/PublishedValue.hpp>
 namespace AlibabaCloud {
 namespace Credential {
+
+/**
+ * @brief Provider configured by a section of the credentials INI file
+ *
+ * The file is parsed once and the provider built from the section is kept,
+ * so a refreshing provider (ecs_ram_role, ram_role_arn, ...) keeps its cached
+ * credential across calls. At most once per revalidation interval the file is
+ * stat'ed; the section is parsed again and a new provider built only when
+ * the path, the section name or the file's (device, inode, mtime, size)
+ * changed. A failure to load is cached under the same key, so a missing or
+ * disabled profile is not re-read on every call either.
+ *
+ * A replaced provider lives on until the threads that called it last call
+ * this provider again, so references it returned stay valid until then.
+ */
 class ProfileProvider : public Provider {
 public:
+  static constexpr int64_t DEFAULT_REVALIDATE_INTERVAL_MS = 1000;  // 1 second
+
+  /**
+   * @param revalidateIntervalMs Minimum time between two checks of the file,
+   *                             0 to check on every call
+   */
+  explicit ProfileProvider(
+      int64_t revalidateIntervalMs = DEFAULT_REVALIDATE_INTERVAL_MS)
+      : revalidateIntervalMs_(revalidateIntervalMs) {}
+
+  ProfileProvider(const ProfileProvider &) = delete;
+  ProfileProvider &operator=(const ProfileProvider &) = delete;
 
   virtual Models::CredentialModel &getCredential() override {
-    provider_ = createProvider();
-    if (provider_ == nullptr) {
-      throw Darabonba::Exception("Can't create the ProfileProvider.");
-    }
-    return provider_->getCredential();
+    return const_cast<Models::CredentialModel &>(provider().getCredential());
   }
 
   virtual const Models::CredentialModel &getCredential() const override {
-    provider_ = createProvider();
-    if (provider_ == nullptr) {
-      throw Darabonba::Exception("Can't create the ProfileProvider.");
-    }
-    return provider_->getCredential();
+    return provider().getCredential();
   }
-  
+
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    return provider().getSnapshot();
+  }
+
   /**
    * @brief Get provider name
    */
   std::string getProviderName() const override {
-    provider_ = createProvider();
-    if (provider_ == nullptr) {
-      throw Darabonba::Exception("Can't create the ProfileProvider.");
-    }
-    return provider_->getProviderName();
+    return provider().getProviderName();
   }
 
+  /**
+   * @brief Generation of the provider in use, advanced past the replaced
+   *        provider's when the profile is reloaded
+   */
+  virtual uint64_t getGeneration() const override;
+
 protected:
-  static std::unique_ptr<Provider> createProvider();
+  /**
+   * @brief Build the provider configured by `sectionName` of `filePath`
+   *
+   * @return nullptr if the section configures no usable credential
+   */
+  static std::unique_ptr<Provider> createProvider(const std::string &filePath,
+                                                  const std::string &sectionName);
+
+  /**
+   * @brief Credentials file in use: ALIBABA_CLOUD_CREDENTIALS_FILE or the
+   *        default profile path
+   */
+  static std::string getFilePath();
+
+  /**
+   * @brief Section in use: the client type or ALIBABA_CLOUD_PROFILE
+   */
+  static std::string getSectionName();
+
+private:
+  struct Loaded {
+    std::string filePath;
+    std::string sectionName;
+    FileStamp stamp;
+    std::unique_ptr<Provider> provider;  // nullptr if loading failed
+    std::string error;
+    uint64_t generationBase = 0;  // Added to the provider's generation
+  };
+
+  const Provider &provider() const;
+  const Loaded *current() const;
 
-  mutable std::unique_ptr<Provider> provider_ = nullptr;
+  int64_t revalidateIntervalMs_;
+  mutable PublishedValue<Loaded> loaded_;  // Stored under loadMutex_
+  mutable std::atomic<int64_t> revalidateAt_{0};  // Steady clock, ms
+  mutable std::mutex loadMutex_;
 };
 
 } // namespace Credential
 } // namespace AlibabaCloud
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,90 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_PROFILEREGISTRY_HPP_
+#define ALIBABACLOUD_CREDENTIAL_PROFILEREGISTRY_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <alibabacloud/credential/Model.hpp>
+#include <alibabacloud/credential/provider/Provider.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Index of the profiles of CLI configuration files
+ *
+ * A file is read with ProfileFile and its profiles (JSON `profiles` entries
+ * or INI sections) indexed by name in one pass, once per version of the
+ * file; a profile's settings are copied out of the index the first time it
+ * is asked for. The provider of a profile is built on first use and shared by every CLIProfileProvider asking for
+ * it, so a refreshing provider fetches its credential once per process.
+ *
+ * At most once per revalidation interval the file is stat'ed. When its
+ * (device, inode, mtime, size) changed it is parsed again, and only the
+ * profiles whose settings changed get a new provider; the others keep
+ * theirs along with its cached credential.
+ */
+class ProfileRegistry {
+public:
+  static constexpr int64_t DEFAULT_REVALIDATE_INTERVAL_MS = 1000;  // 1 second
+
+  /**
+   * @brief Registry shared by the process
+   */
+  static std::shared_ptr<ProfileRegistry> getDefault();
+
+  /**
+   * @param revalidateIntervalMs Minimum time between two checks of a file,
+   *                             0 to check on every lookup
+   */
+  explicit ProfileRegistry(
+      int64_t revalidateIntervalMs = DEFAULT_REVALIDATE_INTERVAL_MS);
+  ~ProfileRegistry();
+
+  ProfileRegistry(const ProfileRegistry &) = delete;
+  ProfileRegistry &operator=(const ProfileRegistry &) = delete;
+
+  /**
+   * @brief Shared provider of `profileName` in `filePath`
+   *
+   * @throw Darabonba::Exception if the file can't be read or parsed, or the
+   *        profile is missing or configures no usable credential
+   */
+  std::shared_ptr<Provider> getProvider(const std::string &filePath,
+                                        const std::string &profileName);
+
+  /**
+   * @brief Settings of `profileName` in `filePath`
+   *
+   * @throw Darabonba::Exception as getProvider()
+   */
+  std::shared_ptr<const Models::Config> getConfig(const std::string &filePath,
+                                                  const std::string &profileName);
+
+  int64_t getRevalidateIntervalMs() const { return revalidateIntervalMs_; }
+
+  /**
+   * @brief Forget all files; providers already handed out stay valid
+   */
+  void clear();
+
+private:
+  struct Profile;
+  struct File;
+
+  Profile &lookup(const std::string &filePath, const std::string &profileName);
+  static void reload(File &file, const std::string &filePath);
+  static Profile loadProfile(const File &file, const std::string &profileName);
+
+  int64_t revalidateIntervalMs_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<File>> files_;  // By path
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
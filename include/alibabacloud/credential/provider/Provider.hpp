@@ -1,9 +1,13 @@
 #ifndef ALIBABACLOUD_CREDENTIAL_PROVIDER_HPP_
 #define ALIBABACLOUD_CREDENTIAL_PROVIDER_HPP_
 
+#include <atomic>
+#include <cstdint>
+#include <future>
 #include <memory>
 #include <string>
 
+#include <alibabacloud/credential/CredentialSnapshot.hpp>
 #include <alibabacloud/credential/Model.hpp>
 
 namespace AlibabaCloud {
@@ -15,12 +19,95 @@ public:
 
   virtual Models::CredentialModel &getCredential() = 0;
   virtual const Models::CredentialModel &getCredential() const = 0;
-  
+
+  /**
+   * @brief Get an immutable snapshot of the current credential
+   *
+   * The snapshot stays valid and unchanged after the provider refreshes.
+   * The default implementation copies getCredential(); providers that cache
+   * credentials override it to share one snapshot per refresh.
+   */
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const {
+    return std::make_shared<const CredentialSnapshot>(getCredential());
+  }
+
+  /**
+   * @brief Start loading the credential in the background
+   *
+   * Runs getSnapshot() on a new thread, so the first fetch (chain resolution,
+   * STS or metadata calls) overlaps the caller's own initialization and the
+   * warm-ups of several providers run in parallel. The future holds the
+   * snapshot or rethrows the fetch error.
+   *
+   * The provider must outlive the warm-up: destroying the last copy of the
+   * future waits for it to finish. Client::warmUp() keeps its provider alive.
+   */
+  virtual std::shared_future<std::shared_ptr<const CredentialSnapshot>>
+  warmUp() const {
+    return std::async(std::launch::async, [this] { return getSnapshot(); })
+        .share();
+  }
+
+  /**
+   * @brief Get the credential generation
+   *
+   * The generation increases each time the provider installs new key
+   * material, so state derived from a credential (signing keys, header
+   * prefixes) can be revalidated with one integer comparison. Read the
+   * generation before the credential: a refresh in between then shows up
+   * as a new generation on the next check.
+   *
+   * @return Generation number, 0 if the provider does not track generations
+   *         or has not loaded a credential yet
+   */
+  virtual uint64_t getGeneration() const { return 0; }
+
+  /**
+   * @brief Process-wide credential epoch
+   *
+   * Bumped whenever any provider installs new key material. Caches layered
+   * over providers (see ThreadLocalCachedProvider) compare it to detect that
+   * some credential changed.
+   */
+  static uint64_t getEpoch() { return epoch_.load(std::memory_order_acquire); }
+
   /**
    * @brief Get provider name
    * @return Provider name string
    */
   virtual std::string getProviderName() const = 0;
+
+protected:
+  /**
+   * @brief Whether two credentials carry the same keys and tokens
+   */
+  static bool sameKeyMaterial(const Models::CredentialModel &lhs,
+                              const Models::CredentialModel &rhs) {
+    return lhs.getAccessKeyId() == rhs.getAccessKeyId() &&
+           lhs.getAccessKeySecret() == rhs.getAccessKeySecret() &&
+           lhs.getSecurityToken() == rhs.getSecurityToken() &&
+           lhs.getBearerToken() == rhs.getBearerToken();
+  }
+
+  /**
+   * @brief Record that new key material was installed
+   */
+  static void bumpEpoch() { epoch_.fetch_add(1, std::memory_order_release); }
+
+  /**
+   * @brief Generation offset for a wrapper that replaces the provider it
+   *        forwards to
+   *
+   * @param base Offset used with the replaced provider
+   * @param replaced Replaced provider, nullptr if there was none
+   * @return Offset past every generation reported so far
+   */
+  static uint64_t nextGenerationBase(uint64_t base, const Provider *replaced) {
+    return base + (replaced != nullptr ? replaced->getGeneration() : 0) + 1;
+  }
+
+private:
+  static std::atomic<uint64_t> epoch_;
 };
 } // namespace Credential
 } // namespace AlibabaCloud
@@ -0,0 +1,109 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_PUBLISHEDVALUE_HPP_
+#define ALIBABACLOUD_CREDENTIAL_PUBLISHEDVALUE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Per-thread owners of the values handed out by PublishedValue::pin()
+ *        and of ThreadLocalCachedProvider's copies
+ *
+ * Each thread keeps one slot per owner it used, holding the value it
+ * returned last. Slots of destroyed owners are dropped when the
+ * thread's table has grown past SWEEP_THRESHOLD (or twice its size after the
+ * previous sweep); slots of live ones are never evicted.
+ */
+class PinnedValues {
+public:
+  static constexpr size_t SWEEP_THRESHOLD = 16;  // Slots before the first sweep
+
+  struct Slot {
+    uint64_t owner = 0;    // Owner id, never reused
+    uint64_t version = 0;  // Publish count when `value` was loaded
+    std::shared_ptr<const void> value;
+    std::weak_ptr<const void> alive;  // Expires with the owner
+  };
+
+  /**
+   * @brief The calling thread's slot for `owner`, added if missing
+   *
+   * The reference is valid until the thread's next slot() call.
+   */
+  static Slot &slot(uint64_t owner, const std::shared_ptr<const void> &alive);
+
+  /**
+   * @brief A new owner id
+   */
+  static uint64_t nextOwner();
+};
+
+/**
+ * @brief A value replaced as a whole and read without taking a lock
+ *
+ * Writers store a new std::shared_ptr; a replaced value is destroyed once
+ * nobody holds it any more. load() hands shared ownership to the caller.
+ *
+ * pin() serves APIs returning references (Provider::getCredential()): the
+ * calling thread keeps the value it returned alive in its PinnedValues slot
+ * until its next pin() of the same PublishedValue, however many values are
+ * stored meanwhile. A warm pin() is an atomic load of the publish count and
+ * a thread-local lookup; it copies the shared_ptr only after a store.
+ */
+template <typename T> class PublishedValue {
+public:
+  PublishedValue()
+      : id_(PinnedValues::nextOwner()), alive_(std::make_shared<char>()) {}
+
+  PublishedValue(const PublishedValue &) = delete;
+  PublishedValue &operator=(const PublishedValue &) = delete;
+
+  /**
+   * @brief The current value, nullptr if none was stored
+   */
+  std::shared_ptr<const T> load() const { return std::atomic_load(&value_); }
+
+  /**
+   * @brief Replace the current value
+   */
+  void store(std::shared_ptr<const T> value) {
+    std::atomic_store(&value_, std::move(value));
+    // Counted after the store: a reader seeing the new count loads the new
+    // value
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+  /**
+   * @brief The current value, kept alive for the calling thread until its
+   *        next pin() of this PublishedValue
+   *
+   * @return nullptr if no value was stored
+   */
+  const T *pin() const {
+    const uint64_t version = version_.load(std::memory_order_acquire);
+    PinnedValues::Slot &slot = PinnedValues::slot(id_, alive_);
+    if (slot.version == version && slot.value != nullptr) {
+      return static_cast<const T *>(slot.value.get());
+    }
+    // Released only after the slot is no longer used: destroying the old
+    // value may pin other values and grow the table
+    std::shared_ptr<const void> previous = std::move(slot.value);
+    slot.value = load();
+    slot.version = version;
+    return static_cast<const T *>(slot.value.get());
+  }
+
+private:
+  std::shared_ptr<const T> value_;  // Accessed with std::atomic_load/store
+  std::atomic<uint64_t> version_{0};  // Number of stores
+  const uint64_t id_;
+  const std::shared_ptr<const void> alive_;  // Watched by PinnedValues slots
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
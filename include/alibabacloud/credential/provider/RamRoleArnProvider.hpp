@@ -7,12 +7,12 @@
 
 #include <alibabacloud/credential/Constant.hpp>
 #include <alibabacloud/credential/Model.hpp>
-#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
 
-class RamRoleArnProvider : public NeedFreshProvider,
+class RamRoleArnProvider : public RefreshableProvider,
                            std::enable_shared_from_this<RamRoleArnProvider> {
 public:
   RamRoleArnProvider(std::shared_ptr<Models::Config> config)
@@ -32,10 +32,10 @@ public:
                        ? config->getEnableVpc()
                        : (Darabonba::Env::getEnv(Constant::ENV_VPC_ENDPOINT_ENABLED) == "true")),
         connectTimeout_(config->hasConnectTimeout() ? config->getConnectTimeout() : 10000),
-        readTimeout_(config->hasTimeout() ? config->getTimeout() : 5000) {
-    credential_.setAccessKeyId(config->getAccessKeyId())
-        .setAccessKeySecret(config->getAccessKeySecret())
-        .setType(Constant::RAM_ROLE_ARN);
+        readTimeout_(config->hasTimeout() ? config->getTimeout() : 5000),
+        accessKeyId_(config->getAccessKeyId()),
+        accessKeySecret_(config->getAccessKeySecret()) {
+    setHttpTransport(config->getHttpTransport());
   }
 
   RamRoleArnProvider(const std::string &accessKeyId,
@@ -48,13 +48,10 @@ public:
                      const std::string &stsEndpoint = "sts.aliyuncs.com")
       : roleArn_(roleArn), roleSessionName_(roleSessionName), policy_(policy),
         durationSeconds_(durationSeconds_), regionId_(regionId),
-        stsEndpoint_(stsEndpoint) {
-    credential_.setAccessKeyId(accessKeyId)
-        .setAccessKeySecret(accessKeySecret)
-        .setType(Constant::RAM_ROLE_ARN);
-  }
+        stsEndpoint_(stsEndpoint), accessKeyId_(accessKeyId),
+        accessKeySecret_(accessKeySecret) {}
 
-  virtual ~RamRoleArnProvider() {}
+  virtual ~RamRoleArnProvider() { shutdown(); }
   
   /**
    * @brief Get provider name
@@ -62,9 +59,14 @@ public:
   std::string getProviderName() const override { return Constant::RAM_ROLE_ARN; }
 
 private:
-  virtual bool refreshCredential() const override;
+  virtual RefreshResult doRefresh() const override;
+
+  virtual std::string getCacheKey() const override {
+    return CredentialFileCache::makeKey(
+        {getProviderName(), accessKeyId_, roleArn_, roleSessionName_,
+         policy_ ? *policy_ : "", std::to_string(durationSeconds_), stsEndpoint_});
+  }
 
-  mutable Models::CredentialModel credential_;
   std::string roleArn_;
   std::string roleSessionName_;
   std::shared_ptr<std::string> policy_ = nullptr;
@@ -74,6 +76,8 @@ private:
   bool enableVpc_ = false;
   int64_t connectTimeout_ = 10000;  // Connection timeout in milliseconds
   int64_t readTimeout_ = 5000;      // Read timeout in milliseconds
+  std::string accessKeyId_;         // Long-term key used to sign AssumeRole
+  std::string accessKeySecret_;
 };
 
 } // namespace Credential
@@ -0,0 +1,118 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_REFRESHEXECUTOR_HPP_
+#define ALIBABACLOUD_CREDENTIAL_REFRESHEXECUTOR_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Process-wide executor for background credential refreshes
+ *
+ * A fixed pool of worker threads drains a FIFO queue of refresh tasks. Each
+ * task is tagged with an owner (normally the provider instance); at most one
+ * task per owner is queued at any time, so a provider hammered by request
+ * threads inside its prefetch window schedules a single refresh.
+ *
+ * Worker threads run at reduced scheduling priority and may be pinned to a
+ * CPU set so refresh work does not compete with request threads. An
+ * exception escaping a task is passed to Options::onTaskError, or dropped
+ * if none is set; the library never writes to the process's streams.
+ *
+ * Defaults can be set with environment variables:
+ * - ALIBABA_CLOUD_REFRESH_THREADS: worker thread count (default 2)
+ * - ALIBABA_CLOUD_REFRESH_CPUS: comma separated CPU ids to pin workers to
+ */
+class RefreshExecutor {
+public:
+  struct Options {
+    size_t threadCount = 2;        // Number of worker threads
+    std::vector<int> cpuAffinity;  // CPUs workers may run on (empty: any)
+    bool lowPriority = true;       // Lower worker scheduling priority
+    // Called on the worker with the exception a task threw
+    std::function<void(std::exception_ptr)> onTaskError;
+  };
+
+  /**
+   * @brief Get the shared executor instance
+   */
+  static RefreshExecutor &getInstance();
+
+  /**
+   * @brief Replace the executor options
+   *
+   * Running workers finish their current task and are restarted with the new
+   * options; queued tasks are kept.
+   */
+  static void configure(const Options &options);
+
+  /**
+   * @brief Options derived from the environment
+   */
+  static Options defaultOptions();
+
+  explicit RefreshExecutor(const Options &options);
+  ~RefreshExecutor();
+
+  RefreshExecutor(const RefreshExecutor &) = delete;
+  RefreshExecutor &operator=(const RefreshExecutor &) = delete;
+
+  /**
+   * @brief Queue a task
+   *
+   * @param owner Deduplication key; nullptr disables deduplication
+   * @param task Work to run on a worker thread
+   * @return false if a task for the same owner is already queued
+   */
+  bool submit(const void *owner, std::function<void()> task);
+
+  /**
+   * @brief Drop queued tasks of an owner and wait for its running task
+   *
+   * Must be called before the owner is destroyed.
+   */
+  void cancel(const void *owner);
+
+  /**
+   * @brief Number of tasks waiting for a worker
+   */
+  size_t pendingCount() const;
+
+  /**
+   * @brief Number of worker threads
+   */
+  size_t threadCount() const;
+
+private:
+  void start(const Options &options);
+  void stop();
+  void workerLoop();
+  void applyThreadSettings() const;
+
+  Options options_;
+  std::vector<std::thread> workers_;
+  std::deque<std::pair<const void *, std::function<void()>>> queue_;
+  std::set<const void *> queuedOwners_;
+  std::map<const void *, std::thread::id> runningOwners_;
+  bool stopping_ = false;
+
+  mutable std::mutex mutex_;
+  std::condition_variable queueCond_;
+  std::condition_variable idleCond_;
+  std::mutex configureMutex_;
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
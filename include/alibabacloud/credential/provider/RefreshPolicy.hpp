@@ -0,0 +1,97 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_REFRESHPOLICY_HPP_
+#define ALIBABACLOUD_CREDENTIAL_REFRESHPOLICY_HPP_
+
+#include <cstdint>
+#include <memory>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief When a provider should refresh a credential
+ *
+ * A credential fetched at `now` that expires at `expiration` becomes stale
+ * staleLeadSeconds before it expires. Background refresh starts after
+ * prefetchFraction of its lifetime, clamped to the min/max refresh interval
+ * and to the stale time, and then moved earlier by a per-process jitter of
+ * up to jitterFraction of that delay. The jitter is derived from the host
+ * name and process id, so processes started together spread their STS calls
+ * instead of refreshing in waves, while one process keeps a stable schedule.
+ *
+ * By default a credential is refreshed within the last 10% of the time to its
+ * stale time; a lower prefetchFraction refreshes earlier and calls STS more
+ * often.
+ *
+ * Defaults can be set with environment variables:
+ * - ALIBABA_CLOUD_REFRESH_PREFETCH_FRACTION (default 1.0)
+ * - ALIBABA_CLOUD_REFRESH_JITTER_FRACTION (default 0.1)
+ * - ALIBABA_CLOUD_REFRESH_MIN_INTERVAL: seconds (default 60)
+ * - ALIBABA_CLOUD_REFRESH_MAX_INTERVAL: seconds (default 0, no limit)
+ */
+class RefreshPolicy {
+public:
+  struct Options {
+    double prefetchFraction = 1.0;            // Share of lifetime before prefetch
+    double jitterFraction = 0.1;              // Jitter band around the prefetch delay
+    int64_t minRefreshIntervalSeconds = 60;   // Lower bound of the prefetch delay
+    int64_t maxRefreshIntervalSeconds = 0;    // Upper bound of the delay, 0: none
+    int64_t staleLeadSeconds = 180;           // Stop serving this long before expiry
+    uint64_t jitterSeed = 0;                  // 0: derive from host name and pid
+  };
+
+  /**
+   * @brief Shared policy built from defaultOptions()
+   */
+  static std::shared_ptr<const RefreshPolicy> getDefault();
+
+  /**
+   * @brief Options derived from the environment
+   */
+  static Options defaultOptions();
+
+  RefreshPolicy() : RefreshPolicy(Options()) {}
+  explicit RefreshPolicy(const Options &options);
+
+  /**
+   * @brief Time after which the credential must not be served any more
+   */
+  int64_t getStaleTime(int64_t expiration) const {
+    return expiration - options_.staleLeadSeconds;
+  }
+
+  /**
+   * @brief Time at which a background refresh should start
+   *
+   * @param now Time the credential was fetched
+   * @param expiration Credential expiration time
+   */
+  int64_t getPrefetchTime(int64_t now, int64_t expiration) const;
+
+  /**
+   * @brief Whether a credential fetched at `fetchedAt` needs a refresh at `now`
+   *
+   * @param fetchedAt Fetch time, 0 if unknown (only expiry is checked then)
+   */
+  bool needsRefresh(int64_t now, int64_t fetchedAt, int64_t expiration) const {
+    if (now >= getStaleTime(expiration)) {
+      return true;
+    }
+    return fetchedAt > 0 && now >= getPrefetchTime(fetchedAt, expiration);
+  }
+
+  /**
+   * @brief This process's jitter in [-1, 1]
+   */
+  double getJitter() const { return jitter_; }
+
+  const Options &getOptions() const { return options_; }
+
+private:
+  Options options_;
+  double jitter_;
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_REFRESHSTATS_HPP_
+#define ALIBABACLOUD_CREDENTIAL_REFRESHSTATS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Latency and failure statistics of a provider's refreshes
+ *
+ * Keeps the last LATENCY_SAMPLES refresh latencies (successful or not) and
+ * an exponentially weighted failure rate. From them it derives how long
+ * before the stale time a background refresh has to start so that it, and
+ * the retries a flaky endpoint needs, complete before a request thread
+ * would block on a synchronous refresh.
+ *
+ * Only one thread records at a time (the provider's refresh lock); the
+ * derived values can be read from any thread.
+ */
+class RefreshStats {
+public:
+  static constexpr size_t LATENCY_SAMPLES = 128;          // Latency ring size
+  static constexpr double FAILURE_RATE_ALPHA = 0.2;       // EWMA weight of a new outcome
+  static constexpr int64_t MIN_PREFETCH_LEAD_SECONDS = 10;    // Lead for fast, healthy refreshes
+  static constexpr int64_t MAX_PREFETCH_LEAD_SECONDS = 1800;  // Upper bound of the lead
+  static constexpr int MAX_EXPECTED_ATTEMPTS = 10;        // Retries budgeted for
+
+  RefreshStats() = default;
+  RefreshStats(const RefreshStats &) = delete;
+  RefreshStats &operator=(const RefreshStats &) = delete;
+
+  void recordSuccess(std::chrono::milliseconds latency) { record(latency, false); }
+  void recordFailure(std::chrono::milliseconds latency) { record(latency, true); }
+
+  /**
+   * @brief 99th percentile of the recorded latencies, 0 without samples
+   */
+  int64_t getP99LatencyMillis() const {
+    return p99LatencyMillis_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Smoothed share of failed refreshes in [0, 1]
+   */
+  double getFailureRate() const {
+    return failureRate_.load(std::memory_order_relaxed);
+  }
+
+  size_t getSampleCount() const {
+    return sampleCount_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Seconds before the stale time a prefetch has to start
+   *
+   * Budgets twice the p99 latency for each attempt needed to succeed with
+   * 99% probability at the current failure rate.
+   */
+  int64_t getPrefetchLeadSeconds() const;
+
+private:
+  void record(std::chrono::milliseconds latency, bool failed);
+
+  int64_t samples_[LATENCY_SAMPLES] = {};  // Milliseconds, written by recorder only
+  size_t next_ = 0;
+  std::atomic<size_t> sampleCount_{0};
+  std::atomic<int64_t> p99LatencyMillis_{0};
+  std::atomic<double> failureRate_{0.0};
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
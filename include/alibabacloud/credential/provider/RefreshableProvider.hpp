@@ -1,6 +1,7 @@
 #ifndef ALIBABACLOUD_CREDENTIAL_REFRESHABLEPROVIDER_HPP_
 #define ALIBABACLOUD_CREDENTIAL_REFRESHABLEPROVIDER_HPP_
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -18,7 +19,14 @@
 #include <cstring>
 #endif
 
+#include <alibabacloud/credential/HttpTransport.hpp>
+#include <alibabacloud/credential/provider/CredentialFileCache.hpp>
 #include <alibabacloud/credential/provider/Provider.hpp>
+#include <alibabacloud/credential/provider/PublishedValue.hpp>
+#include <alibabacloud/credential/provider/RefreshExecutor.hpp>
+#include <alibabacloud/credential/provider/RefreshPolicy.hpp>
+#include <alibabacloud/credential/provider/RefreshStats.hpp>
+#include <alibabacloud/credential/provider/SharedCredentialCache.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
@@ -26,16 +34,19 @@ namespace Credential {
 /**
  * @brief Refresh result wrapper class
  * 
- * Contains credential value, expiration time and prefetch time
+ * Contains credential value, expiration time and prefetch time, plus an
+ * immutable snapshot of the credential shared by every getSnapshot() caller
  */
 struct RefreshResult {
   Models::CredentialModel credential;
   int64_t staleTime = 0;     // Expiration time (seconds timestamp)
   int64_t prefetchTime = 0;  // Prefetch time (seconds timestamp)
+  std::shared_ptr<const CredentialSnapshot> snapshot;
   
   RefreshResult() = default;
   RefreshResult(const Models::CredentialModel& cred, int64_t stale, int64_t prefetch)
-      : credential(cred), staleTime(stale), prefetchTime(prefetch) {}
+      : credential(cred), staleTime(stale), prefetchTime(prefetch),
+        snapshot(std::make_shared<const CredentialSnapshot>(cred, stale)) {}
 };
 
 /**
@@ -61,24 +72,43 @@ class PrefetchStrategy {
 public:
   virtual ~PrefetchStrategy() = default;
   virtual void prefetch(std::function<void()> action) = 0;
+
+  /**
+   * @brief Prefetch on behalf of an owner (normally the provider)
+   *
+   * Strategies may use the owner to deduplicate or cancel pending work.
+   */
+  virtual void prefetch(const void* owner, std::function<void()> action) {
+    (void)owner;
+    prefetch(std::move(action));
+  }
+
+  /**
+   * @brief Drop pending work of an owner and wait for running work
+   */
+  virtual void cancel(const void* owner) { (void)owner; }
 };
 
 /**
- * @brief Non-blocking prefetch strategy (async refresh in background thread)
+ * @brief Non-blocking prefetch strategy (async refresh on the shared RefreshExecutor)
  */
 class NonBlockingPrefetch : public PrefetchStrategy {
 public:
+  NonBlockingPrefetch() : executor_(RefreshExecutor::getInstance()) {}
+  explicit NonBlockingPrefetch(RefreshExecutor& executor) : executor_(executor) {}
+
   void prefetch(std::function<void()> action) override {
-    // Execute refresh in detached thread
-    std::thread([action]() {
-      try {
-        action();
-      } catch (const std::exception& e) {
-        // Log error but don't throw exception
-        std::cerr << "NonBlockingPrefetch error: " << e.what() << std::endl;
-      }
-    }).detach();
+    executor_.submit(nullptr, std::move(action));
   }
+
+  void prefetch(const void* owner, std::function<void()> action) override {
+    executor_.submit(owner, std::move(action));
+  }
+
+  void cancel(const void* owner) override { executor_.cancel(owner); }
+
+private:
+  RefreshExecutor& executor_;
 };
 
 /**
@@ -86,6 +116,7 @@ public:
  */
 class OneCallerBlocksPrefetch : public PrefetchStrategy {
 public:
+  using PrefetchStrategy::prefetch;
   void prefetch(std::function<void()> action) override {
     action();  // Synchronous execution
   }
@@ -100,6 +131,13 @@ public:
  * - 15 minutes expiration time window
  * - Failure retry and stale value handling
  * - Configurable refresh strategy (blocking/non-blocking)
+ *
+ * The cached RefreshResult is immutable once published in a PublishedValue.
+ * Readers pin it without taking a lock while the cache is warm; only the
+ * thread that performs a refresh takes refreshMutex_ and stores a new one.
+ * A reference returned by getCredential() stays valid until the calling
+ * thread's next call on this provider, however many refreshes happen
+ * meanwhile.
  */
 class RefreshableProvider : public Provider {
 public:
@@ -107,21 +145,26 @@ public:
   static constexpr int64_t STALE_TIME_WINDOW = 15 * 60;      // 15 minutes stale window
   static constexpr int64_t PREFETCH_THRESHOLD = 180;          // 180 seconds prefetch threshold
   static constexpr int64_t REFRESH_BLOCKING_MAX_WAIT_MS = 10000;  // Max wait 10 seconds (in milliseconds)
+  static constexpr int64_t SHARED_CACHE_POLL_MS = 20;          // Wait step for another process's refresh
 
   /**
    * @brief 构造函数
    * 
    * @param staleValueBehavior 过期值处理策略
    * @param prefetchStrategy 预取策略（默认非阻塞）
+   * @param refreshPolicy Refresh timing (default RefreshPolicy::getDefault())
    */
   explicit RefreshableProvider(
       StaleValueBehavior staleValueBehavior = StaleValueBehavior::STRICT_,
       std::shared_ptr<PrefetchStrategy> prefetchStrategy = 
-          std::make_shared<NonBlockingPrefetch>())
+          std::make_shared<NonBlockingPrefetch>(),
+      std::shared_ptr<const RefreshPolicy> refreshPolicy = nullptr)
       : staleValueBehavior_(staleValueBehavior),
         prefetchStrategy_(prefetchStrategy),
+        refreshPolicy_(refreshPolicy != nullptr ? std::move(refreshPolicy)
+                                                : RefreshPolicy::getDefault()),
         consecutiveRefreshFailures_(0),
-        cachedValue_(nullptr) {}
+        prefetchPending_(false) {}
 
   virtual ~RefreshableProvider() {
     shutdown();
@@ -136,21 +179,53 @@ public:
   }
 
   virtual const Models::CredentialModel& getCredential() const override {
-    std::lock_guard<std::mutex> lock(accessMutex_);
-    
-    if (cacheIsStale()) {
-      // Cache expired, synchronous refresh
-      refreshCache();
-    } else if (shouldInitiateCachePrefetch()) {
-      // About to expire, async prefetch refresh
-      prefetchCache();
-    }
-    
-    if (!cachedValue_) {
-      throw std::runtime_error("No cached credential available");
-    }
-    
-    return cachedValue_->credential;
+    return currentValue()->credential;
+  }
+
+  /**
+   * @brief Get the snapshot of the current credential (thread safe)
+   */
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    return currentValue()->snapshot;
+  }
+
+  /**
+   * @brief Generation of the published credential (no refresh, no lock)
+   */
+  virtual uint64_t getGeneration() const override {
+    return generation_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Latency and failure statistics of doRefresh()
+   */
+  const RefreshStats& getRefreshStats() const { return refreshStats_; }
+
+  /**
+   * @brief Use a persistent cache (default CredentialFileCache::getDefault())
+   *
+   * Must be called before the first getCredential(); nullptr disables it.
+   */
+  void setCredentialFileCache(std::shared_ptr<CredentialFileCache> fileCache) {
+    fileCache_ = std::move(fileCache);
+  }
+
+  /**
+   * @brief Share refreshes with other processes of this host
+   *
+   * Default from ALIBABA_CLOUD_CREDENTIALS_SHARED_MEMORY. Requires a
+   * getCacheKey(); must be called before the first getCredential().
+   */
+  void setSharedCacheEnabled(bool enabled) { sharedCacheEnabled_ = enabled; }
+
+  /**
+   * @brief Send the requests of doRefresh() through `transport`
+   *
+   * Must be called before the first getCredential(); nullptr restores
+   * HttpTransport::getDefault().
+   */
+  void setHttpTransport(std::shared_ptr<HttpTransport> transport) {
+    httpTransport_ = std::move(transport);
   }
 
 protected:
@@ -161,6 +236,22 @@ protected:
    */
   virtual RefreshResult doRefresh() const = 0;
 
+  /**
+   * @brief Transport for the requests of doRefresh()
+   */
+  HttpTransport &getHttpTransport() const {
+    return httpTransport_ != nullptr ? *httpTransport_
+                                     : *HttpTransport::getDefault();
+  }
+
+  /**
+   * @brief Identity keying this provider's CredentialFileCache entry
+   *
+   * Must cover everything that selects the credential (role, session name,
+   * policy, endpoint, ...). Empty, the default, disables the file cache.
+   */
+  virtual std::string getCacheKey() const { return ""; }
+
   /**
    * @brief Time utility: convert GMT time string to timestamp
    * 
@@ -232,67 +323,321 @@ protected:
         std::chrono::system_clock::now().time_since_epoch()).count();
   }
 
-private:
   /**
-   * @brief Check if cache is stale
+   * @brief Refresh timing used by this provider
+   */
+  const RefreshPolicy& getRefreshPolicy() const { return *refreshPolicy_; }
+
+  /**
+   * @brief Move a prefetch time earlier if refreshes are slow or flaky
+   *
+   * Keeps at least RefreshStats::getPrefetchLeadSeconds() between the
+   * prefetch and the stale time, but never schedules before now. The delay
+   * is scaled rather than clamped: clamping would move every process whose
+   * jittered prefetch time falls within the lead to the same instant.
    */
-  bool cacheIsStale() const {
-    if (!cachedValue_) {
-      return true;
+  int64_t adaptPrefetchTime(int64_t prefetchTime, int64_t staleTime) const {
+    const int64_t now = getCurrentTime();
+    const int64_t latest = staleTime - refreshStats_.getPrefetchLeadSeconds();
+    if (prefetchTime <= now || latest <= now) {
+      return now;
     }
-    return getCurrentTime() >= cachedValue_->staleTime;
+    const double scale =
+        static_cast<double>(latest - now) /
+        static_cast<double>(std::max(staleTime, prefetchTime) - now);
+    const double delay = static_cast<double>(prefetchTime - now) * scale;
+    return std::min(latest, now + static_cast<int64_t>(delay));
   }
 
   /**
-   * @brief Check if prefetch should be initiated
+   * @brief Build a RefreshResult for a credential expiring at `expiration`
+   *
+   * Stale and prefetch times come from the provider's RefreshPolicy; the
+   * prefetch is moved earlier when observed refresh latency requires it.
    */
-  bool shouldInitiateCachePrefetch() const {
-    if (!cachedValue_) {
-      return true;
+  RefreshResult makeRefreshResult(const Models::CredentialModel& credential,
+                                  int64_t expiration) const {
+    const int64_t now = getCurrentTime();
+    const int64_t staleTime = refreshPolicy_->getStaleTime(expiration);
+    return RefreshResult(
+        credential, staleTime,
+        adaptPrefetchTime(refreshPolicy_->getPrefetchTime(now, expiration),
+                          staleTime));
+  }
+
+  /**
+   * @brief Refresh in the background now, ahead of the prefetch time
+   *
+   * For subclasses that learn the credential source changed (a rotated
+   * token, ...). No-op until a credential has been fetched once.
+   */
+  void requestRefresh() const {
+    if (cachedValue_.load() == nullptr) {
+      return;
     }
-    return getCurrentTime() >= cachedValue_->prefetchTime;
+    refreshRequested_.store(true, std::memory_order_release);
+    prefetchCache();
+  }
+
+  /**
+   * @brief Stop background refresh
+   *
+   * Drops queued prefetches and waits for a running one. Subclasses call this
+   * from their destructor so no refresh runs against a partly destroyed object.
+   */
+  void shutdown() {
+    prefetchStrategy_->cancel(this);
+  }
+
+private:
+  /**
+   * @brief Clears the prefetch-pending flag when a prefetch finishes
+   */
+  struct PendingFlagReset {
+    explicit PendingFlagReset(std::atomic<bool>& flag) : flag_(flag) {}
+    ~PendingFlagReset() { flag_.store(false); }
+    std::atomic<bool>& flag_;
+  };
+
+  /**
+   * @brief Gives a won refresher lease up when the refresh attempt ends
+   */
+  struct LeaseRelease {
+    explicit LeaseRelease(SharedCredentialCache* shared) : shared_(shared) {}
+    ~LeaseRelease() {
+      if (shared_ != nullptr) {
+        shared_->releaseLease();
+      }
+    }
+    SharedCredentialCache* shared_;
+  };
+
+  /**
+   * @brief Get the published snapshot, refreshing it first if needed
+   *
+   * Hit path: one pin and one clock read, no locking. The result stays
+   * valid until the calling thread's next call.
+   */
+  const RefreshResult* currentValue() const {
+    const RefreshResult* current = cachedValue_.pin();
+    const int64_t now = getCurrentTime();
+
+    if (current == nullptr || now >= current->staleTime) {
+      // Cache expired, synchronous refresh
+      refreshCache();
+      current = cachedValue_.pin();
+    } else if (now >= current->prefetchTime) {
+      // About to expire, async prefetch refresh
+      prefetchCache();
+    }
+
+    if (current == nullptr) {
+      throw std::runtime_error("No cached credential available");
+    }
+    return current;
   }
 
   /**
    * @brief Async prefetch refresh
+   *
+   * At most one prefetch is handed to the strategy at a time, so threads that
+   * keep hitting the prefetch window do not queue redundant refreshes.
    */
   void prefetchCache() const {
-    prefetchStrategy_->prefetch([this]() {
-      refreshCache();
-    });
+    if (prefetchPending_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    bool expected = false;
+    if (!prefetchPending_.compare_exchange_strong(expected, true)) {
+      return;
+    }
+    try {
+      prefetchStrategy_->prefetch(this, [this]() {
+        PendingFlagReset reset(prefetchPending_);
+        refreshCache();
+      });
+    } catch (...) {
+      prefetchPending_.store(false);
+      throw;
+    }
   }
 
   /**
    * @brief Synchronous refresh cache (with lock protection)
+   *
+   * Publishes the result of the refresh attempt in cachedValue_.
    */
   void refreshCache() const {
     std::unique_lock<std::timed_mutex> lock(refreshMutex_, std::defer_lock);
-    
+
     // Try to acquire lock, wait max REFRESH_BLOCKING_MAX_WAIT_MS milliseconds
     if (!lock.try_lock_for(std::chrono::milliseconds(REFRESH_BLOCKING_MAX_WAIT_MS))) {
-      // Lock timeout, return using existing cache
+      // Lock timeout, keep using existing cache
       return;
     }
 
     // Double check: another thread may have already refreshed
-    if (!cacheIsStale() && !shouldInitiateCachePrefetch()) {
+    const std::shared_ptr<const RefreshResult> current = cachedValue_.load();
+    const bool requested =
+        refreshRequested_.exchange(false, std::memory_order_acq_rel);
+    if (current != nullptr && !requested) {
+      const int64_t now = getCurrentTime();
+      if (now < current->staleTime && now < current->prefetchTime) {
+        return;
+      }
+    }
+
+    // A new process starts from the persistent cache when it can
+    std::shared_ptr<const RefreshResult> next =
+        current == nullptr ? loadFileCache() : nullptr;
+    SharedCredentialCache* shared = next == nullptr ? sharedCache() : nullptr;
+    bool leased = false;
+    if (shared != nullptr) {
+      next = loadSharedCache(*shared, current.get(), leased);
+    }
+    // Also when handleFetchedFailure() rethrows
+    LeaseRelease release(leased ? shared : nullptr);
+    if (next == nullptr) {
+      const auto started = std::chrono::steady_clock::now();
+      try {
+        RefreshResult result = doRefresh();
+        refreshStats_.recordSuccess(elapsedSince(started));
+        storeFileCache(result);
+        if (shared != nullptr) {
+          shared->write(toCacheEntry(result));
+        }
+        next = std::make_shared<const RefreshResult>(
+            handleFetchedSuccess(result, current.get()));
+      } catch (const std::exception&) {
+        refreshStats_.recordFailure(elapsedSince(started));
+        next = std::make_shared<const RefreshResult>(
+            handleFetchedFailure(current.get()));
+      }
+    }
+    cachedValue_.store(next);
+    // Bump after publishing so a reader that sees the new generation also
+    // sees the new credential
+    if (current == nullptr ||
+        !sameKeyMaterial(current->credential, next->credential)) {
+      generation_.fetch_add(1, std::memory_order_release);
+      bumpEpoch();
+    }
+  }
+
+  /**
+   * @brief A still valid credential from the file cache, nullptr otherwise
+   */
+  std::shared_ptr<const RefreshResult> loadFileCache() const {
+    if (fileCache_ == nullptr) {
+      return nullptr;
+    }
+    const std::string key = getCacheKey();
+    CredentialFileCache::Entry entry;
+    if (key.empty() || !fileCache_->load(key, entry) ||
+        getCurrentTime() >= entry.staleTime) {
+      return nullptr;
+    }
+    return std::make_shared<const RefreshResult>(
+        entry.credential, entry.staleTime,
+        std::min(entry.prefetchTime, entry.staleTime));
+  }
+
+  /**
+   * @brief Write a freshly fetched credential to the file cache
+   */
+  void storeFileCache(const RefreshResult& result) const {
+    if (fileCache_ == nullptr || getCurrentTime() >= result.staleTime) {
       return;
     }
+    const std::string key = getCacheKey();
+    if (key.empty()) {
+      return;
+    }
+    fileCache_->store(key, toCacheEntry(result));
+  }
 
-    try {
-      RefreshResult result = doRefresh();
-      cachedValue_ = std::make_shared<RefreshResult>(
-          handleFetchedSuccess(result));
-    } catch (const std::exception& ex) {
-      cachedValue_ = std::make_shared<RefreshResult>(
-          handleFetchedFailure(ex));
+  static CredentialFileCache::Entry toCacheEntry(const RefreshResult& result) {
+    CredentialFileCache::Entry entry;
+    entry.credential = result.credential;
+    entry.staleTime = result.staleTime;
+    entry.prefetchTime = result.prefetchTime;
+    return entry;
+  }
+
+  /**
+   * @brief The host-wide record of this provider, opened on first use
+   */
+  SharedCredentialCache* sharedCache() const {
+    if (!sharedCacheEnabled_) {
+      return nullptr;
+    }
+    if (!sharedCacheOpened_) {
+      sharedCacheOpened_ = true;
+      const std::string key = getCacheKey();
+      if (!key.empty()) {
+        sharedCache_ = SharedCredentialCache::open(key);
+      }
+    }
+    return sharedCache_.get();
+  }
+
+  /**
+   * @brief Take the credential from the host-wide record if possible
+   *
+   * Returns nullptr when this process should call doRefresh() itself: it
+   * won the refresher lease (`leased` is set), or no other process produced
+   * a usable credential within REFRESH_BLOCKING_MAX_WAIT_MS.
+   */
+  std::shared_ptr<const RefreshResult> loadSharedCache(
+      SharedCredentialCache& shared, const RefreshResult* current,
+      bool& leased) const {
+    CredentialFileCache::Entry entry;
+    int64_t now = getCurrentTime();
+    // Another process refreshed recently
+    if (shared.read(entry) && now < entry.prefetchTime) {
+      return std::make_shared<const RefreshResult>(
+          entry.credential, entry.staleTime, entry.prefetchTime);
     }
+    if (shared.tryAcquireLease(now)) {
+      leased = true;
+      return nullptr;
+    }
+
+    // Another process is refreshing: keep serving what is still valid and
+    // look at the record again shortly
+    const auto deadline = std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(REFRESH_BLOCKING_MAX_WAIT_MS);
+    do {
+      now = getCurrentTime();
+      if (shared.read(entry) && now < entry.staleTime) {
+        return std::make_shared<const RefreshResult>(
+            entry.credential, entry.staleTime,
+            std::max(now + 1, std::min(entry.prefetchTime, entry.staleTime)));
+      }
+      if (current != nullptr && now < current->staleTime) {
+        return std::make_shared<const RefreshResult>(
+            current->credential, current->staleTime, now + 1);
+      }
+      if (shared.tryAcquireLease(now)) {
+        leased = true;
+        return nullptr;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(SHARED_CACHE_POLL_MS));
+    } while (std::chrono::steady_clock::now() < deadline);
+    return nullptr;
+  }
+
+  static std::chrono::milliseconds elapsedSince(
+      std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
   }
 
   /**
    * @brief Handle successful refresh
    */
-  RefreshResult handleFetchedSuccess(const RefreshResult& value) const {
+  RefreshResult handleFetchedSuccess(const RefreshResult& value,
+                                     const RefreshResult* current) const {
     consecutiveRefreshFailures_ = 0;
     int64_t now = getCurrentTime();
 
@@ -307,70 +652,88 @@ private:
     }
 
     // Case 3: credential expired, try using cache
-    if (!cachedValue_) {
+    if (current == nullptr) {
       throw std::runtime_error("Retrieved expired credential and no cached value available");
     }
 
-    if (now < cachedValue_->staleTime) {
+    if (now < current->staleTime) {
       // Cache not expired, use cache
-      return *cachedValue_;
+      return *current;
     }
 
     // Decide how to handle expired cache based on policy
     if (staleValueBehavior_ == StaleValueBehavior::STRICT_) {
       // Strict mode: return cache but set very short expiration (1 second)
-      return RefreshResult(cachedValue_->credential, now + 1, cachedValue_->prefetchTime);
+      return RefreshResult(current->credential, now + 1, current->prefetchTime);
     } else {
       // Allow mode: extend expiration time with random jitter
       int64_t jitter = (rand() % 20000 + 50000) / 1000;  // 50-70 seconds
-      return RefreshResult(cachedValue_->credential, now + jitter, cachedValue_->prefetchTime);
+      return RefreshResult(current->credential, now + jitter, current->prefetchTime);
     }
   }
 
   /**
    * @brief Handle refresh failure
+   *
+   * Called from the catch block in refreshCache(); rethrows the original
+   * exception so callers see its real type and message.
    */
-  RefreshResult handleFetchedFailure(const std::exception& ex) const {
-    if (!cachedValue_) {
-      throw ex;  // No cache, throw exception
+  RefreshResult handleFetchedFailure(const RefreshResult* current) const {
+    if (current == nullptr) {
+      throw;  // No cache, throw exception
     }
 
     int64_t now = getCurrentTime();
-    if (now < cachedValue_->staleTime) {
-      return *cachedValue_;  // Cache not expired, return cache
-    }
-
     consecutiveRefreshFailures_++;
 
+    if (now < current->staleTime) {
+      // Cache not expired, return cache and retry the prefetch after a
+      // backoff rather than on the next call
+      return RefreshResult(current->credential, current->staleTime,
+                           std::min(current->staleTime, now + backoffSeconds()));
+    }
+
     if (staleValueBehavior_ == StaleValueBehavior::STRICT_) {
-      throw ex;  // Strict mode: throw exception
+      throw;  // Strict mode: throw exception
     } else {
       // Allow mode: extend expiration time with exponential backoff
-      int64_t backoffMillis = std::max(10000LL, (1LL << (consecutiveRefreshFailures_ - 1)) * 100);
-      int64_t jitter = (rand() % (backoffMillis / 2)) + backoffMillis;
-      int64_t newStaleTime = now + jitter / 1000;
+      int64_t newStaleTime = now + backoffSeconds();
       
-      return RefreshResult(cachedValue_->credential, newStaleTime, cachedValue_->prefetchTime);
+      return RefreshResult(current->credential, newStaleTime, current->prefetchTime);
     }
   }
 
   /**
-   * @brief Stop background refresh
+   * @brief Exponential backoff with jitter after consecutive failures
+   *
+   * At least 10 seconds, plus up to half of the backoff as jitter.
    */
-  void shutdown() {
-    // Clean up resources
+  int64_t backoffSeconds() const {
+    const int failures = std::min(consecutiveRefreshFailures_.load(), 31);
+    int64_t backoffMillis = std::max(10000LL, (1LL << (failures - 1)) * 100);
+    int64_t jitter = (rand() % (backoffMillis / 2)) + backoffMillis;
+    return jitter / 1000;
   }
 
 private:
   // Member variables
   StaleValueBehavior staleValueBehavior_;
   std::shared_ptr<PrefetchStrategy> prefetchStrategy_;
+  std::shared_ptr<const RefreshPolicy> refreshPolicy_;
+  mutable RefreshStats refreshStats_;  // Recorded under refreshMutex_
+  std::shared_ptr<CredentialFileCache> fileCache_ = CredentialFileCache::getDefault();
+  bool sharedCacheEnabled_ = SharedCredentialCache::enabledByDefault();
+  std::shared_ptr<HttpTransport> httpTransport_;  // nullptr for the default
+  mutable bool sharedCacheOpened_ = false;  // Guarded by refreshMutex_
+  mutable std::shared_ptr<SharedCredentialCache> sharedCache_;
   
   mutable std::atomic<int> consecutiveRefreshFailures_;
-  mutable std::shared_ptr<RefreshResult> cachedValue_;
-  
+  mutable std::atomic<bool> prefetchPending_;  // A prefetch is queued or running
+  mutable std::atomic<bool> refreshRequested_{false};  // By requestRefresh()
+  mutable PublishedValue<RefreshResult> cachedValue_;  // Stored under refreshMutex_
+  mutable std::atomic<uint64_t> generation_{0};  // Bumped on new key material
+
   mutable std::timed_mutex refreshMutex_;  // Refresh lock
-  mutable std::mutex accessMutex_;   // Access lock
 };
 
 } // namespace Credential
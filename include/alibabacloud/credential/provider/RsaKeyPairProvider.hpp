@@ -5,20 +5,20 @@
 
 #include <alibabacloud/credential/Constant.hpp>
 #include <alibabacloud/credential/Model.hpp>
-#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
 
-class RsaKeyPairProvider : public NeedFreshProvider,
+class RsaKeyPairProvider : public RefreshableProvider,
                            std::enable_shared_from_this<RsaKeyPairProvider> {
 public:
   RsaKeyPairProvider(std::shared_ptr<Models::Config> config)
       : durationSeconds_(config->getDurationSeconds()),
-        regionId_(config->getRegionId()), stsEndpoint_(config->getStsEndpoint()) {
-    credential_.setAccessKeyId(config->getAccessKeyId())
-        .setAccessKeySecret(config->getAccessKeySecret())
-        .setType(Constant::RSA_KEY_PAIR);
+        regionId_(config->getRegionId()), stsEndpoint_(config->getStsEndpoint()),
+        accessKeyId_(config->getAccessKeyId()),
+        accessKeySecret_(config->getAccessKeySecret()) {
+    setHttpTransport(config->getHttpTransport());
   }
   RsaKeyPairProvider(const std::string &accessKeyId,
                      const std::string &accessKeySecret,
@@ -26,13 +26,10 @@ public:
                      const std::string &regionId = "cn-hangzhou",
                      const std::string &stsEndpoint = "sts.aliyuncs.com")
       : durationSeconds_(durationSeconds), regionId_(regionId),
-        stsEndpoint_(stsEndpoint) {
-    credential_.setAccessKeyId(accessKeyId)
-        .setAccessKeySecret(accessKeySecret)
-        .setType(Constant::RSA_KEY_PAIR);
-  }
+        stsEndpoint_(stsEndpoint), accessKeyId_(accessKeyId),
+        accessKeySecret_(accessKeySecret) {}
 
-  virtual ~RsaKeyPairProvider() {}
+  virtual ~RsaKeyPairProvider() { shutdown(); }
   
   /**
    * @brief Get provider name
@@ -40,11 +37,19 @@ public:
   std::string getProviderName() const override { return Constant::RSA_KEY_PAIR; }
 
 protected:
-  virtual bool refreshCredential() const override ;
+  virtual RefreshResult doRefresh() const override;
+
+  virtual std::string getCacheKey() const override {
+    return CredentialFileCache::makeKey(
+        {getProviderName(), accessKeyId_, regionId_,
+         std::to_string(durationSeconds_), stsEndpoint_});
+  }
 
   int64_t durationSeconds_ = 3600;
   std::string regionId_ = "cn-hangzhou";
   std::string stsEndpoint_ = "sts.aliyuncs.com";
+  std::string accessKeyId_;      // Key pair public key id
+  std::string accessKeySecret_;  // Key pair private key
 };
 
 } // namespace Credential
@@ -0,0 +1,101 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_SHAREDCREDENTIALCACHE_HPP_
+#define ALIBABACLOUD_CREDENTIAL_SHAREDCREDENTIALCACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <alibabacloud/credential/provider/CredentialFileCache.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Credential record shared by the processes of a host
+ *
+ * One POSIX shared memory segment per provider key (see
+ * CredentialFileCache::makeKey()), created with mode 0600 so only processes
+ * of the same user attach. The record is protected by a seqlock: readers
+ * copy it without taking any lock and retry if a write overlapped.
+ *
+ * Writers are elected with a lease stored in the record: a process that
+ * wants to refresh calls tryAcquireLease() and only the winner calls the
+ * remote service and write()s the result. The lease expires on its own, so
+ * a refresher that crashes is replaced after at most LEASE_SECONDS, and a
+ * write left half done by it is overwritten by the next lease holder.
+ *
+ * Enabled for all providers with ALIBABA_CLOUD_CREDENTIALS_SHARED_MEMORY=true.
+ * Not supported on Windows, where open() returns nullptr.
+ */
+class SharedCredentialCache {
+public:
+  static constexpr int64_t LEASE_SECONDS = 30;        // Refresher lease
+  static constexpr size_t MAX_CREDENTIAL_SIZE = 8192;  // Serialized fields
+
+  /**
+   * @brief Whether the environment enables the shared cache
+   */
+  static bool enabledByDefault();
+
+  /**
+   * @brief Attach to (or create) the segment of `key`
+   *
+   * @return nullptr if shared memory is unavailable
+   */
+  static std::shared_ptr<SharedCredentialCache> open(const std::string &key);
+
+  /**
+   * @brief Remove the segment of `key`; attached processes keep their mapping
+   */
+  static void unlink(const std::string &key);
+
+  ~SharedCredentialCache();
+
+  SharedCredentialCache(const SharedCredentialCache &) = delete;
+  SharedCredentialCache &operator=(const SharedCredentialCache &) = delete;
+
+  /**
+   * @brief Copy the record (no lock, bounded retries)
+   *
+   * @return false if empty or constantly being written
+   */
+  bool read(CredentialFileCache::Entry &entry) const;
+
+  /**
+   * @brief Replace the record; the caller should hold the lease
+   *
+   * @return false if the credential does not fit or another write is running
+   */
+  bool write(const CredentialFileCache::Entry &entry);
+
+  /**
+   * @brief Become the refresher for LEASE_SECONDS
+   *
+   * Succeeds if the lease is free, expired or already held by this instance.
+   */
+  bool tryAcquireLease(int64_t now);
+
+  /**
+   * @brief Give the lease up early so another process may refresh
+   */
+  void releaseLease();
+
+  /**
+   * @brief Number of completed writes, changes whenever the record does
+   */
+  uint64_t getVersion() const;
+
+private:
+  struct Record;
+
+  SharedCredentialCache(Record *record, uint32_t ownerId);
+
+  Record *record_;
+  uint32_t ownerId_;  // Nonzero, identifies this instance in the lease
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
@@ -17,6 +17,7 @@ public:
         .setAccessKeySecret(config->getAccessKeySecret())
         .setSecurityToken(config->getSecurityToken())
         .setType(Constant::STS);
+    snapshot_ = std::make_shared<const CredentialSnapshot>(credential_);
   }
   StsProvider(const std::string &accessKeyId,
               const std::string &accessKeySecret,
@@ -25,6 +26,7 @@ public:
         .setAccessKeySecret(accessKeySecret)
         .setSecurityToken(securityToken)
         .setType(Constant::STS);
+    snapshot_ = std::make_shared<const CredentialSnapshot>(credential_);
   }
 
   virtual ~StsProvider() {}
@@ -33,6 +35,12 @@ public:
   virtual const Models::CredentialModel &getCredential() const override {
     return credential_;
   }
+
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    return snapshot_;
+  }
+
+  virtual uint64_t getGeneration() const override { return 1; }  // Never rotates
   
   /**
    * @brief Get provider name
@@ -41,6 +49,7 @@ public:
 
 protected:
   mutable Models::CredentialModel credential_;
+  std::shared_ptr<const CredentialSnapshot> snapshot_;
 };
 } // namespace Credential
 
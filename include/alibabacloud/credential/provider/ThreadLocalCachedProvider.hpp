@@ -0,0 +1,88 @@
+#ifndef ALIBABACLOUD_CREDENTIAL_THREADLOCALCACHEDPROVIDER_HPP_
+#define ALIBABACLOUD_CREDENTIAL_THREADLOCALCACHEDPROVIDER_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <alibabacloud/credential/provider/Provider.hpp>
+#include <alibabacloud/credential/provider/PublishedValue.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+/**
+ * @brief Opt-in per-thread cache over any Provider
+ *
+ * Each thread keeps its own copy of the wrapped provider's credential,
+ * tagged with the process-wide epoch (Provider::getEpoch()). A warm read
+ * loads the epoch, compares it with the tag and counts down a thread-local
+ * read budget. It writes no shared cache line, and the epoch's line is only
+ * written when key material changes, so reads scale with the number of
+ * cores.
+ *
+ * A thread goes back to the wrapped provider when any provider installs new
+ * key material (epoch change) or after revalidateInterval, which also lets
+ * the wrapped provider schedule its own prefetch and refresh. The clock is
+ * read only once the read budget runs out: every read for a thread that
+ * reads rarely, up to every 64th for a busy one. A busy thread that goes
+ * quiet therefore may serve its copy for up to 64 more reads before it
+ * revalidates.
+ *
+ * References returned by getCredential() point to the calling thread's copy
+ * and stay valid until that thread's next call on this provider, whatever
+ * other providers it calls meanwhile. The copies are held in the thread's
+ * PinnedValues table and released once this provider is destroyed.
+ */
+class ThreadLocalCachedProvider : public Provider {
+public:
+  static constexpr int64_t DEFAULT_REVALIDATE_INTERVAL_MS = 1000;  // 1 second
+
+  explicit ThreadLocalCachedProvider(
+      std::shared_ptr<Provider> provider,
+      std::chrono::milliseconds revalidateInterval =
+          std::chrono::milliseconds(DEFAULT_REVALIDATE_INTERVAL_MS));
+  virtual ~ThreadLocalCachedProvider() = default;
+
+  ThreadLocalCachedProvider(const ThreadLocalCachedProvider &) = delete;
+  ThreadLocalCachedProvider &operator=(const ThreadLocalCachedProvider &) = delete;
+
+  virtual Models::CredentialModel &getCredential() override;
+  virtual const Models::CredentialModel &getCredential() const override;
+
+  /**
+   * @brief Get the snapshot cached by the calling thread
+   *
+   * Copying the shared_ptr touches the snapshot's shared reference count;
+   * use getCredential() on the hottest paths.
+   */
+  virtual std::shared_ptr<const CredentialSnapshot> getSnapshot() const override;
+
+  virtual uint64_t getGeneration() const override {
+    return provider_->getGeneration();
+  }
+
+  std::string getProviderName() const override {
+    return provider_->getProviderName();
+  }
+
+private:
+  struct Entry;
+
+  /**
+   * @brief The calling thread's entry, reloaded if the epoch or deadline passed
+   */
+  Entry &entry() const;
+  void reload(Entry &entry, uint64_t epoch) const;
+
+  std::shared_ptr<Provider> provider_;
+  std::chrono::steady_clock::duration revalidateInterval_;
+  const uint64_t id_;  // Never reused, keys the thread-local entries
+  const std::shared_ptr<const void> alive_;  // Watched by PinnedValues slots
+};
+
+} // namespace Credential
+} // namespace AlibabaCloud
+
+#endif
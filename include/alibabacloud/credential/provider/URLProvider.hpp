@@ -6,30 +6,29 @@
 #include <darabonba/Exception.hpp>
 #include <alibabacloud/credential/Constant.hpp>
 #include <alibabacloud/credential/Model.hpp>
-#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
 
-class URLProvider : public NeedFreshProvider,
+class URLProvider : public RefreshableProvider,
                     std::enable_shared_from_this<URLProvider> {
 public:
 
   URLProvider(std::shared_ptr<Models::Config> config) : url_(config->getCredentialsURL()),
       connectTimeout_(config->hasConnectTimeout() ? config->getConnectTimeout() : 10000),
       readTimeout_(config->hasTimeout() ? config->getTimeout() : 5000) {
-    credential_.setType(Constant::URL_STS);
+    setHttpTransport(config->getHttpTransport());
   }
 
   URLProvider(const std::string &url) : url_(url) {
     if (url.empty()) {
       throw Darabonba::Exception("URL cannot be empty");
     }
-    credential_.setType(Constant::URL_STS);
   }
 
 
-  virtual ~URLProvider() {}
+  virtual ~URLProvider() { shutdown(); }
   
   /**
    * @brief Get provider name
@@ -37,10 +36,13 @@ public:
   std::string getProviderName() const override { return Constant::URL_STS; }
 
 protected:
-  virtual bool refreshCredential() const override;
+  virtual RefreshResult doRefresh() const override;
+
+  virtual std::string getCacheKey() const override {
+    return CredentialFileCache::makeKey({getProviderName(), url_});
+  }
 
   std::string url_;
-  mutable Models::CredentialModel credential_;
   int64_t connectTimeout_ = 10000;  // Connection timeout in milliseconds
   int64_t readTimeout_ = 5000;      // Read timeout in milliseconds
 };
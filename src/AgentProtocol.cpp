@@ -0,0 +1,250 @@
+#include <cstring>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <darabonba/Env.hpp>
+#include <darabonba/Exception.hpp>
+
+#include <alibabacloud/credential/AgentProtocol.hpp>
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/internal/Socket.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+// C++11 requires out-of-class definition for constexpr static members
+constexpr uint8_t AgentProtocol::VERSION;
+constexpr size_t AgentProtocol::HEADER_SIZE;
+constexpr uint32_t AgentProtocol::MAX_PAYLOAD_SIZE;
+
+namespace {
+
+const char MAGIC_0 = 'A';
+const char MAGIC_1 = 'C';
+
+void putInt(std::string &out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+uint64_t getInt(const std::string &in, size_t offset, int bytes) {
+  uint64_t value = 0;
+  for (int i = 0; i < bytes; ++i) {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(in[offset + i]))
+             << (8 * i);
+  }
+  return value;
+}
+
+void putField(std::string &out, StringView field) {
+  if (field.size() > 0xffff) {
+    throw Darabonba::Exception("Credential field too large for the agent protocol");
+  }
+  putInt(out, field.size(), 2);
+  out.append(field.data(), field.size());
+}
+
+} // namespace
+
+std::string AgentProtocol::getDefaultSocketPath() {
+  auto path = Darabonba::Env::getEnv(Constant::ENV_CREDENTIALS_AGENT_SOCKET);
+  if (!path.empty()) {
+    return path;
+  }
+#ifndef _WIN32
+  // Never directly in /tmp, where any user could bind the socket first
+  const auto runtimeDirectory = Darabonba::Env::getEnv("XDG_RUNTIME_DIR");
+  if (!runtimeDirectory.empty()) {
+    return runtimeDirectory + "/alibabacloud-credential-agent.sock";
+  }
+  return "/tmp/alibabacloud-credential-agent-" + std::to_string(getuid()) +
+         "/agent.sock";
+#else
+  return "";
+#endif
+}
+
+std::string AgentProtocol::encodeFrame(MessageType type,
+                                       const std::string &payload) {
+  std::string frame;
+  frame.reserve(HEADER_SIZE + payload.size());
+  frame.push_back(MAGIC_0);
+  frame.push_back(MAGIC_1);
+  frame.push_back(static_cast<char>(VERSION));
+  frame.push_back(static_cast<char>(type));
+  putInt(frame, payload.size(), 4);
+  frame += payload;
+  return frame;
+}
+
+std::string AgentProtocol::encodeCredential(const CredentialSnapshot &snapshot,
+                                            uint64_t generation) {
+  std::string payload;
+  putInt(payload, generation, 8);
+  putInt(payload, static_cast<uint64_t>(snapshot.getExpiration()), 8);
+  putField(payload, snapshot.getAccessKeyId());
+  putField(payload, snapshot.getAccessKeySecret());
+  putField(payload, snapshot.getSecurityToken());
+  putField(payload, snapshot.getBearerToken());
+  putField(payload, snapshot.getType());
+  putField(payload, snapshot.getProviderName());
+  return payload;
+}
+
+bool AgentProtocol::decodeCredential(const std::string &payload,
+                                     Credential &out) {
+  if (payload.size() < 16) {
+    return false;
+  }
+  Credential decoded;
+  decoded.generation = getInt(payload, 0, 8);
+  decoded.expiration = static_cast<int64_t>(getInt(payload, 8, 8));
+  std::string fields[6];
+  size_t offset = 16;
+  for (auto &field : fields) {
+    if (payload.size() < offset + 2) {
+      return false;
+    }
+    const size_t length = static_cast<size_t>(getInt(payload, offset, 2));
+    offset += 2;
+    if (payload.size() < offset + length) {
+      return false;
+    }
+    field.assign(payload, offset, length);
+    offset += length;
+  }
+  if (!fields[0].empty()) decoded.credential.setAccessKeyId(fields[0]);
+  if (!fields[1].empty()) decoded.credential.setAccessKeySecret(fields[1]);
+  if (!fields[2].empty()) decoded.credential.setSecurityToken(fields[2]);
+  if (!fields[3].empty()) decoded.credential.setBearerToken(fields[3]);
+  if (!fields[4].empty()) decoded.credential.setType(fields[4]);
+  if (!fields[5].empty()) decoded.credential.setProviderName(fields[5]);
+  out = std::move(decoded);
+  return true;
+}
+
+size_t AgentProtocol::decodeFrame(const std::string &buffer, Message &message) {
+  if (buffer.size() < HEADER_SIZE) {
+    return 0;
+  }
+  if (buffer[0] != MAGIC_0 || buffer[1] != MAGIC_1 ||
+      static_cast<uint8_t>(buffer[2]) != VERSION) {
+    throw Darabonba::Exception("Invalid credential agent frame header");
+  }
+  const uint32_t length = static_cast<uint32_t>(getInt(buffer, 4, 4));
+  if (length > MAX_PAYLOAD_SIZE) {
+    throw Darabonba::Exception("Credential agent frame too large");
+  }
+  if (buffer.size() < HEADER_SIZE + length) {
+    return 0;
+  }
+  message.type = static_cast<MessageType>(static_cast<uint8_t>(buffer[3]));
+  message.payload.assign(buffer, HEADER_SIZE, length);
+  return HEADER_SIZE + length;
+}
+
+#ifndef _WIN32
+
+bool AgentProtocol::writeFrame(int fd, const std::string &frame) {
+  size_t done = 0;
+  while (done < frame.size()) {
+    ssize_t n = send(fd, frame.data() + done, frame.size() - done, MSG_NOSIGNAL);
+    if (n <= 0) {
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+static bool readExactly(int fd, char *out, size_t size) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = recv(fd, out + done, size - done, 0);
+    if (n <= 0) {
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool AgentProtocol::readFrame(int fd, Message &message) {
+  std::string buffer(HEADER_SIZE, '\0');
+  if (!readExactly(fd, &buffer[0], HEADER_SIZE)) {
+    return false;
+  }
+  const uint32_t length = static_cast<uint32_t>(getInt(buffer, 4, 4));
+  if (length > MAX_PAYLOAD_SIZE) {
+    return false;
+  }
+  buffer.resize(HEADER_SIZE + length);
+  if (length > 0 && !readExactly(fd, &buffer[HEADER_SIZE], length)) {
+    return false;
+  }
+  try {
+    return decodeFrame(buffer, message) == buffer.size();
+  } catch (const Darabonba::Exception &) {
+    return false;
+  }
+}
+
+int AgentProtocol::connectTo(const std::string &socketPath, int64_t timeoutMs) {
+  sockaddr_un address;
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    return -1;
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  if (!Internal::prepareSocket(fd)) {
+    close(fd);
+    return -1;
+  }
+  if (timeoutMs > 0) {
+    timeval timeout;
+    timeout.tv_sec = static_cast<time_t>(timeoutMs / 1000);
+    timeout.tv_usec = static_cast<suseconds_t>((timeoutMs % 1000) * 1000);
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  }
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+  if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+bool AgentProtocol::isTrustedPeer(int fd) {
+#ifdef SO_PEERCRED
+  ucred peer;
+  socklen_t length = sizeof(peer);
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &length) != 0) {
+    return false;
+  }
+  const uid_t uid = peer.uid;
+#else
+  uid_t uid;
+  gid_t gid;
+  if (getpeereid(fd, &uid, &gid) != 0) {
+    return false;
+  }
+#endif
+  return uid == getuid() || uid == 0;
+}
+
+#endif
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -0,0 +1,392 @@
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <darabonba/Exception.hpp>
+
+#include <alibabacloud/credential/AgentServer.hpp>
+#include <alibabacloud/credential/internal/Socket.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+// C++11 requires out-of-class definition for constexpr static members
+constexpr int64_t AgentServer::DEFAULT_POLL_INTERVAL_MS;
+constexpr size_t AgentServer::MAX_PENDING_BYTES;
+
+/**
+ * @brief A connected client of the event loop
+ */
+struct AgentServer::Client {
+  int fd = -1;
+  std::string buffer;   // Bytes of an incomplete request
+  std::string pending;  // Response bytes the socket did not take yet
+  bool subscribed = false;
+  std::shared_ptr<const std::string> sent;  // Last frame pushed
+};
+
+AgentServer::AgentServer(std::shared_ptr<Provider> provider,
+                         std::string socketPath, int64_t pollIntervalMs)
+    : provider_(std::move(provider)), socketPath_(std::move(socketPath)),
+      pollIntervalMs_(pollIntervalMs > 0 ? pollIntervalMs
+                                         : DEFAULT_POLL_INTERVAL_MS) {}
+
+AgentServer::~AgentServer() { stop(); }
+
+bool AgentServer::pollProvider() {
+  std::shared_ptr<const CredentialSnapshot> snapshot;
+  std::string failure;
+  try {
+    snapshot = provider_->getSnapshot();
+  } catch (const std::exception &e) {
+    failure = e.what();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (snapshot == nullptr) {
+    // Keep serving the last credential; report the error only if there is none
+    if (snapshot_ == nullptr) {
+      frame_ = std::make_shared<const std::string>(AgentProtocol::encodeFrame(
+          AgentProtocol::MessageType::FAILURE, failure));
+    }
+    return false;
+  }
+  if (snapshot == snapshot_) {
+    return false;
+  }
+  const bool rotated =
+      snapshot_ == nullptr ||
+      snapshot->getAccessKeyId() != snapshot_->getAccessKeyId() ||
+      snapshot->getAccessKeySecret() != snapshot_->getAccessKeySecret() ||
+      snapshot->getSecurityToken() != snapshot_->getSecurityToken() ||
+      snapshot->getBearerToken() != snapshot_->getBearerToken();
+  if (!rotated && snapshot->getExpiration() == snapshot_->getExpiration()) {
+    snapshot_ = snapshot;
+    return false;
+  }
+  const uint64_t generation = rotated
+      ? generation_.fetch_add(1, std::memory_order_acq_rel) + 1
+      : generation_.load(std::memory_order_acquire);
+  try {
+    frame_ = std::make_shared<const std::string>(AgentProtocol::encodeFrame(
+        AgentProtocol::MessageType::CREDENTIAL,
+        AgentProtocol::encodeCredential(*snapshot, generation)));
+  } catch (const std::exception &e) {
+    frame_ = std::make_shared<const std::string>(AgentProtocol::encodeFrame(
+        AgentProtocol::MessageType::FAILURE, e.what()));
+    return false;
+  }
+  snapshot_ = snapshot;
+  return true;
+}
+
+std::shared_ptr<const std::string> AgentServer::currentFrame() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return frame_;
+}
+
+#ifndef _WIN32
+
+static std::string systemError(const std::string &what) {
+  return what + ": " + std::strerror(errno);
+}
+
+/**
+ * @brief Create the socket's directory with mode 0700 if it is missing
+ *
+ * @throw Darabonba::Exception if the directory belongs to another user:
+ *        whoever owns it could replace the socket
+ */
+static void prepareSocketDirectory(const std::string &socketPath) {
+  const size_t slash = socketPath.rfind('/');
+  const std::string directory =
+      slash == std::string::npos ? "."
+                                 : slash == 0 ? "/" : socketPath.substr(0, slash);
+  if (mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+    throw Darabonba::Exception(
+        systemError("Failed to create agent socket directory " + directory));
+  }
+  struct stat status;
+  if (lstat(directory.c_str(), &status) != 0) {
+    throw Darabonba::Exception(
+        systemError("Failed to check agent socket directory " + directory));
+  }
+  if (!S_ISDIR(status.st_mode) ||
+      (status.st_uid != getuid() && status.st_uid != 0)) {
+    throw Darabonba::Exception("Agent socket directory " + directory +
+                               " is not a directory of this user");
+  }
+}
+
+void AgentServer::start() {
+  if (listenFd_ >= 0) {
+    return;
+  }
+  sockaddr_un address;
+  if (socketPath_.size() >= sizeof(address.sun_path)) {
+    throw Darabonba::Exception("Credential agent socket path too long: " +
+                               socketPath_);
+  }
+  prepareSocketDirectory(socketPath_);
+  int existing = AgentProtocol::connectTo(socketPath_, 100);
+  if (existing >= 0) {
+    ::close(existing);
+    throw Darabonba::Exception("A credential agent already serves " +
+                               socketPath_);
+  }
+  pollProvider();
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || !Internal::prepareSocket(fd)) {
+    const std::string message = systemError("Failed to create agent socket");
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    throw Darabonba::Exception(message);
+  }
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, socketPath_.c_str(), socketPath_.size());
+  ::unlink(socketPath_.c_str());  // Left behind by an agent that died
+  if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+      chmod(socketPath_.c_str(), 0600) != 0 || listen(fd, SOMAXCONN) != 0) {
+    const std::string message =
+        systemError("Failed to listen on " + socketPath_);
+    ::close(fd);
+    ::unlink(socketPath_.c_str());
+    throw Darabonba::Exception(message);
+  }
+  const bool piped = pipe(wakeFds_) == 0;
+  if (!piped || !Internal::setCloseOnExec(wakeFds_[0]) ||
+      !Internal::setCloseOnExec(wakeFds_[1]) ||
+      !Internal::addStatusFlags(wakeFds_[0], O_NONBLOCK) ||
+      !Internal::addStatusFlags(wakeFds_[1], O_NONBLOCK)) {
+    const std::string message = systemError("Failed to create agent pipe");
+    if (piped) {
+      ::close(wakeFds_[0]);
+      ::close(wakeFds_[1]);
+    }
+    wakeFds_[0] = wakeFds_[1] = -1;
+    ::close(fd);
+    ::unlink(socketPath_.c_str());
+    throw Darabonba::Exception(message);
+  }
+  listenFd_ = fd;
+  stopping_ = false;
+  serveThread_ = std::thread(&AgentServer::serve, this);
+  watchThread_ = std::thread(&AgentServer::watch, this);
+}
+
+void AgentServer::stop() {
+  if (listenFd_ < 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  stopCondition_.notify_all();
+  const char wake = 0;
+  (void)!::write(wakeFds_[1], &wake, 1);
+  serveThread_.join();
+  watchThread_.join();
+  ::close(listenFd_);
+  ::close(wakeFds_[0]);
+  ::close(wakeFds_[1]);
+  listenFd_ = -1;
+  wakeFds_[0] = wakeFds_[1] = -1;
+  ::unlink(socketPath_.c_str());
+}
+
+void AgentServer::watch() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopCondition_.wait_for(lock,
+                                  std::chrono::milliseconds(pollIntervalMs_),
+                                  [this] { return stopping_; })) {
+    lock.unlock();
+    if (pollProvider()) {
+      const char wake = 1;
+      (void)!::write(wakeFds_[1], &wake, 1);
+    }
+    lock.lock();
+  }
+}
+
+bool AgentServer::flush(Client &client) {
+  while (!client.pending.empty()) {
+    ssize_t n = ::send(client.fd, client.pending.data(), client.pending.size(),
+                       MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      // A full socket buffer is retried once poll() reports it writable
+      return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+    client.pending.erase(0, static_cast<size_t>(n));
+  }
+  return true;
+}
+
+bool AgentServer::send(Client &client,
+                       const std::shared_ptr<const std::string> &frame) {
+  if (client.pending.size() + frame->size() > MAX_PENDING_BYTES) {
+    return false;
+  }
+  client.pending += *frame;
+  client.sent = frame;
+  return flush(client);
+}
+
+bool AgentServer::handle(Client &client) {
+  char data[4096];
+  ssize_t n = recv(client.fd, data, sizeof(data), 0);
+  if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+    return true;
+  }
+  if (n <= 0) {
+    return false;
+  }
+  client.buffer.append(data, static_cast<size_t>(n));
+  for (;;) {
+    AgentProtocol::Message request;
+    size_t consumed = 0;
+    try {
+      consumed = AgentProtocol::decodeFrame(client.buffer, request);
+    } catch (const Darabonba::Exception &) {
+      return false;
+    }
+    if (consumed == 0) {
+      return true;
+    }
+    client.buffer.erase(0, consumed);
+    if (request.type == AgentProtocol::MessageType::SUBSCRIBE) {
+      client.subscribed = true;
+    } else if (request.type != AgentProtocol::MessageType::GET) {
+      return false;
+    }
+    if (!send(client, currentFrame())) {
+      return false;
+    }
+  }
+}
+
+void AgentServer::serve() {
+  std::vector<std::unique_ptr<Client>> clients;
+  std::vector<pollfd> fds;
+  for (;;) {
+    fds.clear();
+    fds.push_back(pollfd{wakeFds_[0], POLLIN, 0});
+    fds.push_back(pollfd{listenFd_, POLLIN, 0});
+    for (const auto &client : clients) {
+      const short events = client->pending.empty() ? POLLIN : POLLIN | POLLOUT;
+      fds.push_back(pollfd{client->fd, events, 0});
+    }
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    if (fds[0].revents & POLLIN) {
+      char drain[64];
+      while (::read(wakeFds_[0], drain, sizeof(drain)) > 0) {
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+          break;
+        }
+      }
+      // Push the rotated credential to subscribers
+      auto frame = currentFrame();
+      for (auto &client : clients) {
+        if (client->subscribed && client->sent != frame &&
+            !send(*client, frame)) {
+          ::close(client->fd);
+          client->fd = -1;
+        }
+      }
+    }
+
+    for (size_t i = 2; i < fds.size(); ++i) {
+      Client &client = *clients[i - 2];
+      const short revents = fds[i].revents;
+      if (client.fd < 0 || revents == 0) {
+        continue;
+      }
+      bool open = !(revents & POLLOUT) || flush(client);
+      if (open && (revents & ~POLLOUT) != 0) {
+        open = handle(client);
+      }
+      if (!open) {
+        ::close(client.fd);
+        client.fd = -1;
+      }
+    }
+
+    if (fds[1].revents & POLLIN) {
+      int fd = accept(listenFd_, nullptr, nullptr);
+      // Non-blocking, so a client that stops reading cannot stall the others
+      if (fd >= 0 && (!Internal::prepareSocket(fd) ||
+                      !Internal::addStatusFlags(fd, O_NONBLOCK))) {
+        ::close(fd);
+        fd = -1;
+      }
+      if (fd >= 0) {
+        std::unique_ptr<Client> client(new Client());
+        client->fd = fd;
+        clients.push_back(std::move(client));
+      }
+    }
+
+    for (size_t i = 0; i < clients.size();) {
+      if (clients[i]->fd < 0) {
+        clients[i] = std::move(clients.back());
+        clients.pop_back();
+      } else {
+        ++i;
+      }
+    }
+  }
+  for (const auto &client : clients) {
+    if (client->fd >= 0) {
+      ::close(client->fd);
+    }
+  }
+}
+
+#else
+
+void AgentServer::start() {
+  throw Darabonba::Exception("The credential agent is not supported on Windows");
+}
+
+void AgentServer::stop() {}
+
+void AgentServer::watch() {}
+
+void AgentServer::serve() {}
+
+bool AgentServer::flush(Client &) { return false; }
+
+bool AgentServer::send(Client &, const std::shared_ptr<const std::string> &) {
+  return false;
+}
+
+bool AgentServer::handle(Client &) { return false; }
+
+#endif
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -5,6 +5,7 @@
 #include <darabonba/http/Request.hpp>
 
 #include <alibabacloud/credential/AuthUtil.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
@@ -161,5 +162,12 @@ AuthUtil::getNewRequest(const std::string &url,
   return req;
 }
 
+HttpRequest AuthUtil::getNewHttpRequest(const std::string &url,
+                                        const std::string &customUserAgent) {
+  HttpRequest req(url);
+  req.headers["User-Agent"] = getUserAgent(customUserAgent);
+  return req;
+}
+
 } // namespace Credential
 } // namespace AlibabaCloud
\ No newline at end of file
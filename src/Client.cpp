@@ -11,6 +11,7 @@
 #include <alibabacloud/credential/provider/RsaKeyPairProvider.hpp>
 #include <alibabacloud/credential/provider/StsProvider.hpp>
 #include <alibabacloud/credential/provider/URLProvider.hpp>
+#include <thread>
 #include <utility>
 
 namespace AlibabaCloud {
@@ -38,6 +39,24 @@ Client::Client(std::shared_ptr<Models::Config> config)
 Client::Client(std::shared_ptr<Provider> provider)
     : provider_(std::move(provider)) {}
 
+std::shared_future<std::shared_ptr<const CredentialSnapshot>>
+Client::warmUp() const {
+  // A detached thread owning a reference to the provider: unlike one from
+  // std::async, a future from a promise does not block when discarded
+  typedef std::shared_ptr<const CredentialSnapshot> Result;
+  auto promise = std::make_shared<std::promise<Result>>();
+  std::shared_future<Result> future = promise->get_future().share();
+  std::shared_ptr<Provider> provider = provider_;
+  std::thread([provider, promise] {
+    try {
+      promise->set_value(provider->getSnapshot());
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+  }).detach();
+  return future;
+}
+
 std::shared_ptr<Provider>
 Client::makeProvider(std::shared_ptr<Models::Config> config) {
   if (config == nullptr) {
@@ -32,6 +32,29 @@ const std::string Constant::ENV_VPC_ENDPOINT_ENABLED =
     "ALIBABA_CLOUD_VPC_ENDPOINT_ENABLED";
 const std::string Constant::ENV_CLI_PROFILE_DISABLED =
     "ALIBABA_CLOUD_CLI_PROFILE_DISABLED";
+const std::string Constant::ENV_REFRESH_THREADS =
+    "ALIBABA_CLOUD_REFRESH_THREADS";
+const std::string Constant::ENV_REFRESH_CPUS = "ALIBABA_CLOUD_REFRESH_CPUS";
+const std::string Constant::ENV_REFRESH_PREFETCH_FRACTION =
+    "ALIBABA_CLOUD_REFRESH_PREFETCH_FRACTION";
+const std::string Constant::ENV_REFRESH_JITTER_FRACTION =
+    "ALIBABA_CLOUD_REFRESH_JITTER_FRACTION";
+const std::string Constant::ENV_REFRESH_MIN_INTERVAL =
+    "ALIBABA_CLOUD_REFRESH_MIN_INTERVAL";
+const std::string Constant::ENV_REFRESH_MAX_INTERVAL =
+    "ALIBABA_CLOUD_REFRESH_MAX_INTERVAL";
+const std::string Constant::ENV_CREDENTIALS_CACHE_DIR =
+    "ALIBABA_CLOUD_CREDENTIALS_CACHE_DIR";
+const std::string Constant::ENV_CREDENTIALS_CACHE_ENCRYPTED =
+    "ALIBABA_CLOUD_CREDENTIALS_CACHE_ENCRYPTED";
+const std::string Constant::ENV_CREDENTIALS_SHARED_MEMORY =
+    "ALIBABA_CLOUD_CREDENTIALS_SHARED_MEMORY";
+const std::string Constant::ENV_CREDENTIALS_AGENT_SOCKET =
+    "ALIBABA_CLOUD_CREDENTIALS_AGENT_SOCKET";
+const std::string Constant::ENV_CREDENTIALS_PARALLEL_RESOLUTION =
+    "ALIBABA_CLOUD_CREDENTIALS_PARALLEL_RESOLUTION";
+const std::string Constant::ENV_CREDENTIALS_HTTP_TRANSPORT =
+    "ALIBABA_CLOUD_CREDENTIALS_HTTP_TRANSPORT";
 
 // OIDC Environment Variables
 const std::string Constant::ENV_ROLE_ARN = "ALIBABA_CLOUD_ROLE_ARN";
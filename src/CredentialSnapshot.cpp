@@ -0,0 +1,67 @@
+#include <cstring>
+
+#include <alibabacloud/credential/CredentialSnapshot.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+CredentialSnapshot::CredentialSnapshot(
+    const Models::CredentialModel &credential, int64_t expiration)
+    : expiration_(expiration) {
+  const std::string fields[FIELD_COUNT] = {
+      credential.getAccessKeyId(),  credential.getAccessKeySecret(),
+      credential.getSecurityToken(), credential.getBearerToken(),
+      credential.getType(),          credential.getProviderName(),
+  };
+
+  size_t total = 0;
+  for (const auto &value : fields) {
+    total += value.size();
+  }
+  size_ = static_cast<uint32_t>(total);
+  buffer_.reset(new char[total > 0 ? total : 1]);
+
+  uint32_t offset = 0;
+  for (int i = 0; i < FIELD_COUNT; ++i) {
+    const auto length = static_cast<uint32_t>(fields[i].size());
+    if (length > 0) {
+      std::memcpy(buffer_.get() + offset, fields[i].data(), length);
+    }
+    slots_[i].offset = offset;
+    slots_[i].length = length;
+    offset += length;
+  }
+}
+
+CredentialSnapshot::CredentialSnapshot(const CredentialSnapshot &other)
+    : buffer_(new char[other.size_ > 0 ? other.size_ : 1]),
+      size_(other.size_), expiration_(other.expiration_) {
+  std::memcpy(buffer_.get(), other.buffer_.get(), size_);
+  std::memcpy(slots_, other.slots_, sizeof(slots_));
+}
+
+Models::CredentialModel CredentialSnapshot::toCredentialModel() const {
+  Models::CredentialModel credential;
+  if (!getAccessKeyId().empty()) {
+    credential.setAccessKeyId(std::string(getAccessKeyId()));
+  }
+  if (!getAccessKeySecret().empty()) {
+    credential.setAccessKeySecret(std::string(getAccessKeySecret()));
+  }
+  if (!getSecurityToken().empty()) {
+    credential.setSecurityToken(std::string(getSecurityToken()));
+  }
+  if (!getBearerToken().empty()) {
+    credential.setBearerToken(std::string(getBearerToken()));
+  }
+  if (!getType().empty()) {
+    credential.setType(std::string(getType()));
+  }
+  if (!getProviderName().empty()) {
+    credential.setProviderName(std::string(getProviderName()));
+  }
+  return credential;
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
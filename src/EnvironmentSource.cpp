@@ -0,0 +1,94 @@
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#ifdef __APPLE__
+#include <crt_externs.h>
+#elif !defined(_WIN32)
+extern char **environ;
+#endif
+
+#include <alibabacloud/credential/EnvironmentSource.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+static char **processEnviron() {
+#if defined(__APPLE__)
+  return *_NSGetEnviron();
+#elif defined(_WIN32)
+  return _environ;
+#else
+  return environ;
+#endif
+}
+
+static bool isCaptured(const char *entry, size_t nameLength) {
+  static const char prefix[] = "ALIBABA_CLOUD_";
+  static const char *const homeVariables[] = {"HOME", "USERPROFILE",
+                                              "HOMEDRIVE", "HOMEPATH"};
+  if (nameLength >= sizeof(prefix) - 1 &&
+      std::strncmp(entry, prefix, sizeof(prefix) - 1) == 0) {
+    return true;
+  }
+  for (const char *name : homeVariables) {
+    if (std::strlen(name) == nameLength &&
+        std::strncmp(entry, name, nameLength) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+EnvironmentSource::Variables EnvironmentSource::capture() {
+  Variables variables;
+  char **entries = processEnviron();
+  for (; entries != nullptr && *entries != nullptr; ++entries) {
+    const char *entry = *entries;
+    const char *equals = std::strchr(entry, '=');
+    if (equals == nullptr) {
+      continue;
+    }
+    const size_t nameLength = static_cast<size_t>(equals - entry);
+    if (isCaptured(entry, nameLength)) {
+      variables[std::string(entry, nameLength)] = equals + 1;
+    }
+  }
+  return variables;
+}
+
+std::shared_ptr<EnvironmentSource> EnvironmentSource::fromProcess() {
+  return std::shared_ptr<EnvironmentSource>(
+      new EnvironmentSource(capture(), true));
+}
+
+EnvironmentSource::EnvironmentSource(Variables variables)
+    : EnvironmentSource(std::move(variables), false) {}
+
+EnvironmentSource::EnvironmentSource(Variables variables, bool fromProcess)
+    : fromProcess_(fromProcess), variables_(std::move(variables)) {}
+
+std::string EnvironmentSource::get(const std::string &name,
+                                   const std::string &defaultValue) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = variables_.find(name);
+  return it == variables_.end() ? defaultValue : it->second;
+}
+
+void EnvironmentSource::reload() {
+  if (fromProcess_) {
+    reload(capture());
+  }
+}
+
+void EnvironmentSource::reload(Variables variables) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (variables == variables_) {
+    return;
+  }
+  variables_ = std::move(variables);
+  version_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -0,0 +1,31 @@
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <alibabacloud/credential/FileStamp.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+FileStamp FileStamp::of(const std::string &path) {
+  FileStamp stamp;
+  struct stat st;
+  if (path.empty() || stat(path.c_str(), &st) != 0) {
+    return stamp;
+  }
+  stamp.device = static_cast<uint64_t>(st.st_dev);
+  stamp.inode = static_cast<uint64_t>(st.st_ino);
+  stamp.size = static_cast<int64_t>(st.st_size);
+#if defined(_WIN32)
+  stamp.mtimeNs = static_cast<int64_t>(st.st_mtime) * 1000000000;
+#elif defined(__APPLE__)
+  stamp.mtimeNs = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 +
+                  st.st_mtimespec.tv_nsec;
+#else
+  stamp.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                  st.st_mtim.tv_nsec;
+#endif
+  return stamp;
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+#include <curl/curl.h>
+#include <darabonba/Exception.hpp>
+
+#include <alibabacloud/credential/HttpConnectionPool.hpp>
+#include <alibabacloud/credential/internal/Clock.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+// Pool key: lowercase scheme://host:port of a URL
+static std::string endpointOf(const std::string &url) {
+  auto schemeEnd = url.find("://");
+  std::string scheme = "http";
+  size_t hostStart = 0;
+  if (schemeEnd != std::string::npos) {
+    scheme = url.substr(0, schemeEnd);
+    hostStart = schemeEnd + 3;
+  }
+  const auto hostEnd = url.find_first_of("/?#", hostStart);
+  std::string authority = url.substr(
+      hostStart, hostEnd == std::string::npos ? std::string::npos
+                                              : hostEnd - hostStart);
+  std::string endpoint = scheme + "://" + authority;
+  std::transform(endpoint.begin(), endpoint.end(), endpoint.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  if (authority.find(':') == std::string::npos ||
+      authority.back() == ']') {  // Bracketed IPv6 address without a port
+    endpoint += scheme == "https" ? ":443" : ":80";
+  }
+  return endpoint;
+}
+
+static std::string urlOf(const HttpRequest &request) {
+  if (request.query.empty()) {
+    return request.url;
+  }
+  const char separator =
+      request.url.find('?') == std::string::npos ? '?' : '&';
+  return request.url + separator + std::string(request.query);
+}
+
+static size_t appendBody(char *data, size_t size, size_t count, void *body) {
+  static_cast<std::string *>(body)->append(data, size * count);
+  return size * count;
+}
+
+HttpConnectionPool &HttpConnectionPool::getInstance() {
+  static HttpConnectionPool instance{Options()};
+  return instance;
+}
+
+HttpConnectionPool::HttpConnectionPool(const Options &options)
+    : options_(options) {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+  // Before options_ releases the session cache the handles are attached to
+  for (auto &entry : idle_) {
+    for (auto &idle : entry.second) {
+      curl_easy_cleanup(idle.handle);
+    }
+  }
+  curl_global_cleanup();
+}
+
+size_t HttpConnectionPool::idleConnections() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = 0;
+  for (const auto &entry : idle_) {
+    count += entry.second.size();
+  }
+  return count;
+}
+
+HttpConnectionPool::Stats HttpConnectionPool::getStats() const {
+  Stats stats;
+  stats.connectionsOpened = connectionsOpened_.load();
+  stats.connectionsReused = connectionsReused_.load();
+  return stats;
+}
+
+void *HttpConnectionPool::acquire(const std::string &endpoint) {
+  closeExpired(Internal::nowMs());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_.find(endpoint);
+    if (it != idle_.end() && !it->second.empty()) {
+      // The most recently used connection is the least likely to be closed
+      void *handle = it->second.back().handle;
+      it->second.pop_back();
+      return handle;
+    }
+  }
+  CURL *handle = curl_easy_init();
+  if (handle == nullptr) {
+    throw Darabonba::Exception("Can't create an HTTP connection");
+  }
+  return handle;
+}
+
+void HttpConnectionPool::release(const std::string &endpoint, void *handle) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &idle = idle_[endpoint];
+    if (idle.size() < options_.maxIdlePerEndpoint) {
+      idle.push_back(Idle{handle, Internal::nowMs()});
+      return;
+    }
+  }
+  curl_easy_cleanup(handle);
+}
+
+void HttpConnectionPool::closeExpired(int64_t now) {
+  std::vector<void *> expired;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = idle_.begin(); it != idle_.end();) {
+      auto &idle = it->second;
+      while (!idle.empty() &&
+             now - idle.front().idleSinceMs >= options_.idleTimeoutMs) {
+        expired.push_back(idle.front().handle);
+        idle.pop_front();
+      }
+      it = idle.empty() ? idle_.erase(it) : std::next(it);
+    }
+  }
+  // Closing may block on a TLS shutdown: not under the lock
+  for (void *handle : expired) {
+    curl_easy_cleanup(handle);
+  }
+}
+
+HttpResponse HttpConnectionPool::send(const HttpRequest &request) {
+  const std::string endpoint = endpointOf(request.url);
+  const std::string url = urlOf(request);
+  CURL *handle = acquire(endpoint);
+
+  // Reset keeps the connection (and TLS session) of the handle
+  curl_easy_reset(handle);
+  curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(handle, CURLOPT_MAXCONNECTS, 1L);
+  curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+  if (options_.sessionCache != nullptr) {
+    curl_easy_setopt(handle, CURLOPT_SHARE,
+                     options_.sessionCache->getHandle());
+  }
+  if (!options_.caFile.empty()) {
+    curl_easy_setopt(handle, CURLOPT_CAINFO, options_.caFile.c_str());
+  }
+#if LIBCURL_VERSION_NUM >= 0x074100
+  // Don't send on a connection the server may already have dropped
+  curl_easy_setopt(
+      handle, CURLOPT_MAXAGE_CONN,
+      static_cast<long>(std::max<int64_t>(1, options_.idleTimeoutMs / 1000)));
+#endif
+  if (request.connectTimeoutMs > 0) {
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS,
+                     static_cast<long>(request.connectTimeoutMs));
+  }
+  if (request.readTimeoutMs > 0) {
+    curl_easy_setopt(
+        handle, CURLOPT_TIMEOUT_MS,
+        static_cast<long>(request.connectTimeoutMs + request.readTimeoutMs));
+  }
+
+  if (request.method == "GET") {
+    curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+  } else {
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE,
+                     static_cast<long>(request.body.size()));
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.body.data());
+    if (request.method != "POST") {
+      curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+    }
+  }
+
+  struct curl_slist *headers = nullptr;
+  for (const auto &header : request.headers) {
+    headers = curl_slist_append(headers,
+                                (header.first + ": " + header.second).c_str());
+  }
+  headers = curl_slist_append(headers, "Expect:");
+  curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+
+  HttpResponse response;
+  curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, appendBody);
+  curl_easy_setopt(handle, CURLOPT_WRITEDATA, &response.body);
+
+  const CURLcode code = curl_easy_perform(handle);
+  curl_easy_setopt(handle, CURLOPT_HTTPHEADER, nullptr);
+  curl_slist_free_all(headers);
+  if (code != CURLE_OK) {
+    curl_easy_cleanup(handle);
+    throw Darabonba::Exception(std::string(curl_easy_strerror(code)) +
+                               " requesting " + request.url);
+  }
+
+  long statusCode = 0;
+  long connects = 0;
+  curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &statusCode);
+  curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+  if (connects > 0) {
+    ++connectionsOpened_;
+  } else {
+    ++connectionsReused_;
+  }
+  response.statusCode = static_cast<int>(statusCode);
+
+  release(endpoint, handle);
+  return response;
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
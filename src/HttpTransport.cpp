@@ -0,0 +1,76 @@
+#include <chrono>
+
+#include <darabonba/Core.hpp>
+#include <darabonba/Env.hpp>
+
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/HttpConnectionPool.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+static std::shared_ptr<HttpTransport> makeDefaultTransport() {
+  if (Darabonba::Env::getEnv(Constant::ENV_CREDENTIALS_HTTP_TRANSPORT) ==
+      "darabonba") {
+    return std::make_shared<DarabonbaHttpTransport>();
+  }
+  // Not owning: the pool lives as long as the process
+  return std::shared_ptr<HttpTransport>(&HttpConnectionPool::getInstance(),
+                                        [](HttpTransport *) {});
+}
+
+std::shared_ptr<HttpTransport> HttpTransport::getDefault() {
+  static std::shared_ptr<HttpTransport> instance = makeDefaultTransport();
+  return instance;
+}
+
+HttpResponse DarabonbaHttpTransport::send(const HttpRequest &request) {
+  Darabonba::Http::Request req(request.url);
+  req.setMethod(request.method);
+  for (const auto &header : request.headers) {
+    req.getHeaders()[header.first] = header.second;
+  }
+  if (!request.query.empty()) {
+    req.setQuery(request.query);
+  }
+  if (!request.body.empty()) {
+    req.setBody(request.body);
+  }
+
+  Darabonba::RuntimeOptions runtime;
+  if (request.connectTimeoutMs > 0) {
+    runtime.setConnectTimeout(request.connectTimeoutMs);
+  }
+  if (request.readTimeoutMs > 0) {
+    runtime.setReadTimeout(request.readTimeoutMs);
+  }
+  auto future = Darabonba::Core::doAction(req, runtime);
+  auto resp = future.get();
+
+  HttpResponse response;
+  response.statusCode = resp->getStatusCode();
+  response.body = Darabonba::Stream::readAsString(resp->getBody());
+  return response;
+}
+
+HttpResponse TimedHttpTransport::send(const HttpRequest &request) {
+  const auto begin = std::chrono::steady_clock::now();
+  const auto elapsedUs = [&begin]() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - begin)
+        .count();
+  };
+  HttpResponse response;
+  try {
+    response = transport_->send(request);
+  } catch (...) {
+    listener_(request, 0, elapsedUs());
+    throw;
+  }
+  listener_(request, response.statusCode, elapsedUs());
+  return response;
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
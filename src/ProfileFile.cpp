@@ -0,0 +1,495 @@
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <darabonba/Exception.hpp>
+
+#include <alibabacloud/credential/ProfileFile.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+static bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static StringView trim(const char *begin, const char *end) {
+  while (begin < end && isSpace(*begin)) {
+    ++begin;
+  }
+  while (end > begin && isSpace(end[-1])) {
+    --end;
+  }
+  return StringView(begin, static_cast<size_t>(end - begin));
+}
+
+static void appendUtf8(std::string &out, unsigned long code) {
+  if (code < 0x80) {
+    out.push_back(static_cast<char>(code));
+  } else if (code < 0x800) {
+    out.push_back(static_cast<char>(0xc0 | (code >> 6)));
+    out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+  } else if (code < 0x10000) {
+    out.push_back(static_cast<char>(0xe0 | (code >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+  } else {
+    out.push_back(static_cast<char>(0xf0 | (code >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+  }
+}
+
+// Four hex digits at `p`, -1 if malformed
+static long hex4(const char *p, const char *end) {
+  if (end - p < 4) {
+    return -1;
+  }
+  long value = 0;
+  for (int i = 0; i < 4; ++i) {
+    const char c = p[i];
+    value <<= 4;
+    if (c >= '0' && c <= '9') {
+      value |= c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      value |= c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      value |= c - 'A' + 10;
+    } else {
+      return -1;
+    }
+  }
+  return value;
+}
+
+// Decode the content of a JSON string (between the quotes)
+static std::string unescape(StringView raw) {
+  std::string out;
+  out.reserve(raw.size());
+  const char *p = raw.data(), *end = raw.data() + raw.size();
+  while (p < end) {
+    if (*p != '\\' || p + 1 == end) {
+      out.push_back(*p++);
+      continue;
+    }
+    const char c = p[1];
+    p += 2;
+    switch (c) {
+    case 'b': out.push_back('\b'); break;
+    case 'f': out.push_back('\f'); break;
+    case 'n': out.push_back('\n'); break;
+    case 'r': out.push_back('\r'); break;
+    case 't': out.push_back('\t'); break;
+    case 'u': {
+      long code = hex4(p, end);
+      if (code < 0) {
+        out.append("\\u");
+        break;
+      }
+      p += 4;
+      // Surrogate pair
+      if (code >= 0xd800 && code < 0xdc00 && end - p >= 6 && p[0] == '\\' &&
+          p[1] == 'u') {
+        const long low = hex4(p + 2, end);
+        if (low >= 0xdc00 && low < 0xe000) {
+          code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+          p += 6;
+        }
+      }
+      appendUtf8(out, static_cast<unsigned long>(code));
+      break;
+    }
+    default: out.push_back(c); break;  // '"', '\\', '/'
+    }
+  }
+  return out;
+}
+
+std::string ProfileFile::Field::str() const {
+  return escaped ? unescape(value) : std::string(value.data(), value.size());
+}
+
+namespace {
+
+/**
+ * @brief Forward-only JSON reader that slices strings out of the input
+ */
+class JsonScanner {
+public:
+  JsonScanner(const char *begin, const char *end) : p_(begin), end_(end) {}
+
+  char peek() {
+    skipSpace();
+    return p_ < end_ ? *p_ : '\0';
+  }
+
+  bool consume(char c) {
+    if (peek() != c) {
+      return false;
+    }
+    ++p_;
+    return true;
+  }
+
+  void expect(char c) {
+    if (!consume(c)) {
+      fail(std::string("expected '") + c + "'");
+    }
+  }
+
+  // Raw content of the string at the cursor
+  StringView string(bool &escaped) {
+    expect('"');
+    const char *begin = p_;
+    escaped = false;
+    for (;;) {
+      const void *quote = std::memchr(p_, '"', static_cast<size_t>(end_ - p_));
+      if (quote == nullptr) {
+        fail("unterminated string");
+      }
+      const char *q = static_cast<const char *>(quote);
+      if (std::memchr(p_, '\\', static_cast<size_t>(q - p_)) != nullptr) {
+        escaped = true;
+      }
+      // The quote is escaped if preceded by an odd number of backslashes
+      const char *b = q;
+      while (b > begin && b[-1] == '\\') {
+        --b;
+      }
+      p_ = q + 1;
+      if ((q - b) % 2 == 0) {
+        return StringView(begin, static_cast<size_t>(q - begin));
+      }
+    }
+  }
+
+  void skipValue(int depth = 0) {
+    if (depth > MAX_DEPTH) {
+      fail("nesting too deep");
+    }
+    bool escaped;
+    switch (peek()) {
+    case '"':
+      string(escaped);
+      return;
+    case '{':
+      ++p_;
+      if (consume('}')) {
+        return;
+      }
+      do {
+        string(escaped);
+        expect(':');
+        skipValue(depth + 1);
+      } while (consume(','));
+      expect('}');
+      return;
+    case '[':
+      ++p_;
+      if (consume(']')) {
+        return;
+      }
+      do {
+        skipValue(depth + 1);
+      } while (consume(','));
+      expect(']');
+      return;
+    default: {
+      // Number, true, false or null
+      const char *begin = p_;
+      while (p_ < end_ && !isSpace(*p_) && *p_ != ',' && *p_ != '}' &&
+             *p_ != ']' && *p_ != ':') {
+        ++p_;
+      }
+      if (p_ == begin) {
+        fail("expected a value");
+      }
+    }
+    }
+  }
+
+  [[noreturn]] void fail(const std::string &what) {
+    throw Darabonba::Exception("Failed to parse JSON profile: " + what);
+  }
+
+private:
+  static constexpr int MAX_DEPTH = 64;
+
+  void skipSpace() {
+    while (p_ < end_ && isSpace(*p_)) {
+      ++p_;
+    }
+  }
+
+  const char *p_;
+  const char *end_;
+};
+
+bool sameText(StringView raw, bool escaped, StringView text) {
+  if (!escaped) {
+    return raw == text;
+  }
+  const std::string decoded = unescape(raw);
+  return StringView(decoded) == text;
+}
+
+} // namespace
+
+ProfileFile::ProfileFile(const std::string &filePath) {
+#ifndef _WIN32
+  // Read rather than mapped: a mapping faults if another program truncates
+  // the file while it is scanned
+  const int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw Darabonba::Exception("Can't open credential profile: " + filePath);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw Darabonba::Exception("Can't open credential profile: " + filePath);
+  }
+  // Sized from fstat; a file that grew meanwhile is read to its end
+  buffer_.resize(static_cast<size_t>(st.st_size) + 1);
+  size_t size = 0;
+  for (;;) {
+    if (size == buffer_.size()) {
+      buffer_.resize(buffer_.size() * 2);
+    }
+    const ssize_t n = read(fd, &buffer_[size], buffer_.size() - size);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      close(fd);
+      throw Darabonba::Exception("Can't read credential profile: " + filePath);
+    }
+    if (n == 0) {
+      break;
+    }
+    size += static_cast<size_t>(n);
+  }
+  close(fd);
+  buffer_.resize(size);
+#else
+  std::ifstream ifs(filePath, std::ios::binary);
+  if (!ifs.good()) {
+    throw Darabonba::Exception("Can't open credential profile: " + filePath);
+  }
+  std::stringstream content;
+  content << ifs.rdbuf();
+  buffer_ = content.str();
+#endif
+}
+
+bool ProfileFile::isJson() const {
+  const char *p = buffer_.data(), *end = buffer_.data() + buffer_.size();
+  while (p < end && isSpace(*p)) {
+    ++p;
+  }
+  return p < end && *p == '{';
+}
+
+bool ProfileFile::findSection(StringView name, Section &section) const {
+  section.clear();
+  bool found = false, inSection = false;
+  const char *p = buffer_.data(), *end = buffer_.data() + buffer_.size();
+  while (p < end) {
+    if (!inSection) {
+      // Only section headers matter here: jump to the next '[' starting a line
+      const void *bracket = std::memchr(p, '[', static_cast<size_t>(end - p));
+      if (bracket == nullptr) {
+        break;
+      }
+      const char *lineStart = static_cast<const char *>(bracket);
+      while (lineStart > p && (lineStart[-1] == ' ' || lineStart[-1] == '\t')) {
+        --lineStart;
+      }
+      if (lineStart != buffer_.data() && lineStart[-1] != '\n') {
+        p = static_cast<const char *>(bracket) + 1;
+        continue;
+      }
+      p = lineStart;
+    }
+    const void *newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    const char *lineEnd = newline ? static_cast<const char *>(newline) : end;
+    const StringView line = trim(p, lineEnd);
+    p = lineEnd + 1;
+    if (line.empty() || line[0] == '#' || line[0] == ';') {
+      continue;
+    }
+    const char *begin = line.data(), *last = line.data() + line.size();
+    if (line[0] == '[') {
+      const void *close = std::memchr(begin, ']', line.size());
+      inSection =
+          trim(begin + 1, close ? static_cast<const char *>(close) : last) == name;
+      found = found || inSection;
+      continue;
+    }
+    if (!inSection) {
+      continue;
+    }
+    const void *equals = std::memchr(begin, '=', line.size());
+    if (equals == nullptr) {
+      continue;
+    }
+    const char *eq = static_cast<const char *>(equals);
+    Field field;
+    field.key = trim(begin, eq);
+    field.value = trim(eq + 1, last);
+    section.push_back(field);
+  }
+  return found;
+}
+
+void ProfileFile::indexSections(Index &index) const {
+  index.clear();
+  Section *section = nullptr;
+  const char *p = buffer_.data(), *end = buffer_.data() + buffer_.size();
+  while (p < end) {
+    const void *newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    const char *lineEnd = newline ? static_cast<const char *>(newline) : end;
+    const StringView line = trim(p, lineEnd);
+    p = lineEnd + 1;
+    if (line.empty() || line[0] == '#' || line[0] == ';') {
+      continue;
+    }
+    const char *begin = line.data(), *last = line.data() + line.size();
+    if (line[0] == '[') {
+      const void *close = std::memchr(begin, ']', line.size());
+      // Sections of the same name are merged, as in findSection()
+      const StringView name =
+          trim(begin + 1, close ? static_cast<const char *>(close) : last);
+      section = &index[std::string(name.data(), name.size())];
+      continue;
+    }
+    if (section == nullptr) {
+      continue;
+    }
+    const void *equals = std::memchr(begin, '=', line.size());
+    if (equals == nullptr) {
+      continue;
+    }
+    const char *eq = static_cast<const char *>(equals);
+    Field field;
+    field.key = trim(begin, eq);
+    field.value = trim(eq + 1, last);
+    section->push_back(field);
+  }
+}
+
+namespace {
+
+/**
+ * @brief Walk the entries of the `profiles` array of a CLI JSON config
+ *
+ * `onProfile(section, name)` gets the string fields of each entry and its
+ * `name` field (nullptr if none); the walk stops when it returns true.
+ *
+ * @return Whether the walk was stopped
+ */
+template <typename OnProfile>
+bool scanJsonProfiles(const char *begin, const char *end, OnProfile onProfile) {
+  JsonScanner scanner(begin, end);
+  bool escaped;
+  scanner.expect('{');
+  if (!scanner.consume('}')) {
+    do {
+      const StringView key = scanner.string(escaped);
+      scanner.expect(':');
+      if (!sameText(key, escaped, "profiles")) {
+        scanner.skipValue();
+        continue;
+      }
+      if (scanner.peek() != '[') {
+        throw Darabonba::Exception("'profiles' must be an array");
+      }
+      scanner.expect('[');
+      if (scanner.consume(']')) {
+        return false;
+      }
+      ProfileFile::Section section;
+      do {
+        if (scanner.peek() != '{') {
+          scanner.skipValue();
+          continue;
+        }
+        scanner.expect('{');
+        section.clear();
+        size_t name = 0;  // Index of the name field plus one
+        if (!scanner.consume('}')) {
+          do {
+            ProfileFile::Field field;
+            field.key = scanner.string(escaped);
+            scanner.expect(':');
+            if (scanner.peek() != '"') {
+              scanner.skipValue();
+              continue;
+            }
+            field.value = scanner.string(field.escaped);
+            if (!escaped && field.key == "name") {
+              name = section.size() + 1;
+            }
+            section.push_back(field);
+          } while (scanner.consume(','));
+          scanner.expect('}');
+        }
+        if (onProfile(section, name != 0 ? &section[name - 1] : nullptr)) {
+          return true;
+        }
+      } while (scanner.consume(','));
+      scanner.expect(']');
+      return false;
+    } while (scanner.consume(','));
+    scanner.expect('}');
+  }
+  throw Darabonba::Exception("No 'profiles' section in CLI config file");
+}
+
+} // namespace
+
+bool ProfileFile::findJsonProfile(StringView name, Section &section) const {
+  section.clear();
+  return scanJsonProfiles(
+      buffer_.data(), buffer_.data() + buffer_.size(),
+      [&](Section &profile, const Field *profileName) {
+        if (profileName == nullptr ||
+            !sameText(profileName->value, profileName->escaped, name)) {
+          return false;
+        }
+        section.swap(profile);
+        return true;
+      });
+}
+
+void ProfileFile::indexJsonProfiles(Index &index) const {
+  index.clear();
+  scanJsonProfiles(buffer_.data(), buffer_.data() + buffer_.size(),
+                   [&index](Section &profile, const Field *profileName) {
+                     if (profileName != nullptr) {
+                       // The first entry of a name wins, as in findJsonProfile()
+                       index.emplace(profileName->str(), profile);
+                     }
+                     return false;
+                   });
+}
+
+const ProfileFile::Field *ProfileFile::find(const Section &section,
+                                            StringView key) {
+  for (auto it = section.rbegin(); it != section.rend(); ++it) {
+    if (it->key == key) {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -0,0 +1,43 @@
+#include <curl/curl.h>
+#include <darabonba/Exception.hpp>
+
+#include <alibabacloud/credential/TlsSessionCache.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+static void lockShare(CURL *, curl_lock_data, curl_lock_access, void *mutex) {
+  static_cast<std::mutex *>(mutex)->lock();
+}
+
+static void unlockShare(CURL *, curl_lock_data, void *mutex) {
+  static_cast<std::mutex *>(mutex)->unlock();
+}
+
+std::shared_ptr<TlsSessionCache> TlsSessionCache::getDefault() {
+  static std::shared_ptr<TlsSessionCache> instance =
+      std::make_shared<TlsSessionCache>();
+  return instance;
+}
+
+TlsSessionCache::TlsSessionCache() {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+  CURLSH *share = curl_share_init();
+  if (share == nullptr) {
+    curl_global_cleanup();
+    throw Darabonba::Exception("Can't create the TLS session cache");
+  }
+  curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShare);
+  curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+  curl_share_setopt(share, CURLSHOPT_USERDATA, &mutex_);
+  share_ = share;
+}
+
+TlsSessionCache::~TlsSessionCache() {
+  curl_share_cleanup(static_cast<CURLSH *>(share_));
+  curl_global_cleanup();
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
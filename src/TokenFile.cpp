@@ -0,0 +1,240 @@
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#include <darabonba/Exception.hpp>
+
+#include <alibabacloud/credential/TokenFile.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+static std::string directoryOf(const std::string &path) {
+#ifdef _WIN32
+  const auto slash = path.find_last_of("/\\");
+#else
+  const auto slash = path.find_last_of('/');
+#endif
+  if (slash == std::string::npos) {
+    return ".";
+  }
+  return slash == 0 ? path.substr(0, 1) : path.substr(0, slash);
+}
+
+static bool readFile(const std::string &path, std::string &content) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << ifs.rdbuf();
+  content = buffer.str();
+  return true;
+}
+
+#ifndef _WIN32
+static void drain(int fd) {
+  char buffer[4096];
+  while (fd >= 0 && read(fd, buffer, sizeof(buffer)) > 0) {
+  }
+}
+#endif
+
+TokenFileWatcher &TokenFileWatcher::getInstance() {
+  static TokenFileWatcher instance{Options()};
+  return instance;
+}
+
+TokenFileWatcher::TokenFileWatcher(const Options &options) : options_(options) {
+  if (options_.pollIntervalMs <= 0) {
+    options_.pollIntervalMs = 1;
+  }
+#ifdef __linux__
+  if (options_.inotifyEnabled) {
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  }
+#endif
+#ifndef _WIN32
+  if (pipe(wakeFds_) == 0) {
+    for (int fd : wakeFds_) {
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+      fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+  } else {
+    wakeFds_[0] = wakeFds_[1] = -1;
+  }
+#endif
+}
+
+TokenFileWatcher::~TokenFileWatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+#ifndef _WIN32
+  for (int fd : {inotifyFd_, wakeFds_[0], wakeFds_[1]}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
+}
+
+bool TokenFileWatcher::usesInotify() const { return inotifyFd_ >= 0; }
+
+void TokenFileWatcher::add(TokenFile *file) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  files_.insert(file);
+  watchDirectory(directoryOf(file->getPath()));
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&TokenFileWatcher::run, this);
+  }
+}
+
+void TokenFileWatcher::remove(TokenFile *file) {
+  // Waits for a check in progress, which may be of this file
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (files_.erase(file)) {
+    unwatchDirectory(directoryOf(file->getPath()));
+  }
+}
+
+void TokenFileWatcher::watchDirectory(const std::string &directory) {
+  auto it = directories_.find(directory);
+  if (it != directories_.end()) {
+    ++it->second.second;
+    return;
+  }
+  int wd = -1;
+#ifdef __linux__
+  // Watch the directory, not the file: a rotation replaces the file (or the
+  // symlink leading to it) rather than writing to it
+  if (inotifyFd_ >= 0) {
+    wd = inotify_add_watch(inotifyFd_, directory.c_str(),
+                           IN_CREATE | IN_MOVED_TO | IN_CLOSE_WRITE |
+                               IN_MODIFY | IN_ATTRIB | IN_DELETE);
+  }
+#endif
+  directories_[directory] = std::make_pair(wd, static_cast<size_t>(1));
+}
+
+void TokenFileWatcher::unwatchDirectory(const std::string &directory) {
+  auto it = directories_.find(directory);
+  if (it == directories_.end() || --it->second.second > 0) {
+    return;
+  }
+#ifdef __linux__
+  if (it->second.first >= 0) {
+    inotify_rm_watch(inotifyFd_, it->second.first);
+  }
+#endif
+  directories_.erase(it);
+}
+
+void TokenFileWatcher::wake() {
+#ifndef _WIN32
+  if (wakeFds_[1] >= 0) {
+    const char byte = 0;
+    while (write(wakeFds_[1], &byte, 1) < 0 && errno == EINTR) {
+    }
+  }
+#endif
+  wakeCond_.notify_all();
+}
+
+void TokenFileWatcher::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+#ifndef _WIN32
+    lock.unlock();
+    // Sleep until a file system event, a wake-up or the next poll
+    struct pollfd fds[2] = {{wakeFds_[0], POLLIN, 0}, {inotifyFd_, POLLIN, 0}};
+    poll(fds, 2, static_cast<int>(options_.pollIntervalMs));
+    drain(wakeFds_[0]);
+    drain(inotifyFd_);
+    lock.lock();
+#else
+    wakeCond_.wait_for(lock, std::chrono::milliseconds(options_.pollIntervalMs));
+#endif
+    if (stopping_) {
+      break;
+    }
+    for (TokenFile *file : files_) {
+      file->check();
+    }
+  }
+}
+
+TokenFile::TokenFile(const std::string &path, TokenFileWatcher &watcher)
+    : path_(path), watcher_(watcher) {
+  if (!path_.empty()) {
+    watcher_.add(this);
+  }
+}
+
+TokenFile::~TokenFile() { watcher_.remove(this); }
+
+std::shared_ptr<const std::string> TokenFile::getToken() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (token_ != nullptr) {
+    return token_;
+  }
+  // Stat before reading: a change during the read shows up on the next check
+  const FileStamp stamp = FileStamp::of(path_);
+  std::string content;
+  if (!readFile(path_, content)) {
+    throw Darabonba::Exception("Can't open " + path_);
+  }
+  token_ = std::make_shared<const std::string>(std::move(content));
+  stamp_ = stamp;
+  return token_;
+}
+
+void TokenFile::check() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (token_ == nullptr) {
+      return;  // Never read: nothing to keep up to date
+    }
+    const FileStamp stamp = FileStamp::of(path_);
+    if (!stamp.exists() || stamp == stamp_) {
+      return;
+    }
+    std::string content;
+    // An empty file is a rotation caught between truncate and write
+    if (!readFile(path_, content) || content.empty()) {
+      return;
+    }
+    stamp_ = stamp;
+    if (content == *token_) {
+      return;
+    }
+    token_ = std::make_shared<const std::string>(std::move(content));
+  }
+  std::lock_guard<std::mutex> lock(listenerMutex_);
+  if (listener_) {
+    listener_();
+  }
+}
+
+void TokenFile::setListener(std::function<void()> listener) {
+  std::lock_guard<std::mutex> lock(listenerMutex_);
+  listener_ = std::move(listener);
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <darabonba/Exception.hpp>
+
+#include <alibabacloud/credential/provider/AgentProvider.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+// C++11 requires out-of-class definition for constexpr static members
+constexpr int64_t AgentProvider::DEFAULT_TIMEOUT_MS;
+constexpr int64_t AgentProvider::MIN_RECONNECT_MS;
+constexpr int64_t AgentProvider::MAX_RECONNECT_MS;
+
+AgentProvider::AgentProvider(std::string socketPath, int64_t timeoutMs)
+    : socketPath_(std::move(socketPath)),
+      timeoutMs_(timeoutMs > 0 ? timeoutMs : DEFAULT_TIMEOUT_MS) {
+#ifndef _WIN32
+  subscriptionThread_ = std::thread(&AgentProvider::subscribe, this);
+#endif
+}
+
+AgentProvider::~AgentProvider() {
+  {
+    std::lock_guard<std::mutex> lock(subscriptionMutex_);
+    stopping_ = true;
+#ifndef _WIN32
+    if (subscriptionFd_ >= 0) {
+      // Wakes the subscription thread out of its blocking read
+      shutdown(subscriptionFd_, SHUT_RDWR);
+    }
+#endif
+  }
+  stopCondition_.notify_all();
+  if (subscriptionThread_.joinable()) {
+    subscriptionThread_.join();
+  }
+}
+
+Models::CredentialModel &AgentProvider::getCredential() {
+  return const_cast<Models::CredentialModel &>(
+      static_cast<const AgentProvider *>(this)->getCredential());
+}
+
+const Models::CredentialModel &AgentProvider::getCredential() const {
+  return current()->credential;
+}
+
+std::shared_ptr<const CredentialSnapshot> AgentProvider::getSnapshot() const {
+  return current()->snapshot;
+}
+
+void AgentProvider::publish(const AgentProtocol::Credential &received) const {
+  auto next = std::make_shared<const Published>(received);
+  std::lock_guard<std::mutex> lock(publishMutex_);
+  const std::shared_ptr<const Published> previous = published_.load();
+  published_.store(next);
+  // Bump after publishing so a reader that sees the new generation also
+  // sees the new credential
+  if (previous == nullptr ||
+      !sameKeyMaterial(previous->credential, next->credential)) {
+    generation_.fetch_add(1, std::memory_order_release);
+    bumpEpoch();
+  }
+}
+
+static bool usable(const CredentialSnapshot &snapshot) {
+  return snapshot.getExpiration() == 0 ||
+         snapshot.getExpiration() > static_cast<int64_t>(time(nullptr));
+}
+
+#ifndef _WIN32
+
+const AgentProvider::Published *AgentProvider::current() const {
+  const Published *current = published_.pin();
+  if (current != nullptr && usable(*current->snapshot)) {
+    return current;
+  }
+  std::lock_guard<std::mutex> lock(requestMutex_);
+  // Double check: a push or another request may have arrived meanwhile
+  current = published_.pin();
+  if (current != nullptr && usable(*current->snapshot)) {
+    return current;
+  }
+
+  int fd = AgentProtocol::connectTo(socketPath_, timeoutMs_);
+  if (fd < 0) {
+    throw Darabonba::Exception("Credential agent unreachable at " + socketPath_);
+  }
+  if (!AgentProtocol::isTrustedPeer(fd)) {
+    close(fd);
+    throw Darabonba::Exception("Credential agent at " + socketPath_ +
+                               " runs as another user");
+  }
+  AgentProtocol::Message response;
+  const bool ok =
+      AgentProtocol::writeFrame(
+          fd, AgentProtocol::encodeFrame(AgentProtocol::MessageType::GET)) &&
+      AgentProtocol::readFrame(fd, response);
+  close(fd);
+  if (!ok) {
+    throw Darabonba::Exception("No response from the credential agent at " +
+                               socketPath_);
+  }
+  if (response.type == AgentProtocol::MessageType::FAILURE) {
+    throw Darabonba::Exception("Credential agent failed to get credentials: " +
+                               response.payload);
+  }
+  AgentProtocol::Credential received;
+  if (response.type != AgentProtocol::MessageType::CREDENTIAL ||
+      !AgentProtocol::decodeCredential(response.payload, received)) {
+    throw Darabonba::Exception("Invalid response from the credential agent");
+  }
+  publish(received);
+  return published_.pin();
+}
+
+void AgentProvider::subscribe() {
+  int64_t backoffMs = MIN_RECONNECT_MS;
+  for (;;) {
+    int fd = AgentProtocol::connectTo(socketPath_, 0);
+    if (fd >= 0 && !AgentProtocol::isTrustedPeer(fd)) {
+      close(fd);
+      fd = -1;
+    }
+    if (fd >= 0) {
+      {
+        std::lock_guard<std::mutex> lock(subscriptionMutex_);
+        if (stopping_) {
+          close(fd);
+          return;
+        }
+        subscriptionFd_ = fd;
+      }
+      if (AgentProtocol::writeFrame(
+              fd, AgentProtocol::encodeFrame(AgentProtocol::MessageType::SUBSCRIBE))) {
+        AgentProtocol::Message message;
+        while (AgentProtocol::readFrame(fd, message)) {
+          AgentProtocol::Credential received;
+          if (message.type == AgentProtocol::MessageType::CREDENTIAL &&
+              AgentProtocol::decodeCredential(message.payload, received)) {
+            publish(received);
+            backoffMs = MIN_RECONNECT_MS;
+          }
+        }
+      }
+      std::lock_guard<std::mutex> lock(subscriptionMutex_);
+      subscriptionFd_ = -1;
+      close(fd);
+    }
+
+    std::unique_lock<std::mutex> lock(subscriptionMutex_);
+    if (stopCondition_.wait_for(lock, std::chrono::milliseconds(backoffMs),
+                                [this] { return stopping_; })) {
+      return;
+    }
+    backoffMs = std::min(backoffMs * 2, MAX_RECONNECT_MS);
+  }
+}
+
+#else
+
+const AgentProvider::Published *AgentProvider::current() const {
+  throw Darabonba::Exception("The credential agent is not supported on Windows");
+}
+
+void AgentProvider::subscribe() {}
+
+#endif
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -1,4 +1,5 @@
 #include <alibabacloud/credential/AuthUtil.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
 #include <alibabacloud/credential/provider/CloudSSOCredentialsProvider.hpp>
 #include <darabonba/Core.hpp>
 #include <darabonba/http/Query.hpp>
@@ -12,7 +13,7 @@ const std::string CloudSSOCredentialsProvider::CLOUD_SSO_ENDPOINT =
 const std::string CloudSSOCredentialsProvider::CLOUD_SSO_FETCH_ERROR_MSG =
     "Failed to get credentials from Cloud SSO service.";
 
-bool CloudSSOCredentialsProvider::refreshCredential() const {
+RefreshResult CloudSSOCredentialsProvider::doRefresh() const {
   Darabonba::Http::Query query = {
       {"Action", "GetRoleCredentials"},
       {"Format", "JSON"},
@@ -25,41 +26,42 @@ bool CloudSSOCredentialsProvider::refreshCredential() const {
 
   // 使用 getNewRequest 创建带 User-Agent 的请求（对应 Python SDK）
   std::string url = "https://" + CLOUD_SSO_ENDPOINT + "/";
-  auto req = AuthUtil::getNewRequest(url);
-  req.setQuery(std::move(query));
+  auto req = AuthUtil::getNewHttpRequest(url);
+  req.query = std::move(query);
 
   // 使用保存的超时配置
-  Darabonba::RuntimeOptions runtime;
-  runtime.setConnectTimeout(connectTimeout_);
-  runtime.setReadTimeout(readTimeout_);
-  auto future = Darabonba::Core::doAction(req, runtime);
-  auto resp = future.get();
-  if (resp->getStatusCode() != 200) {
+  req.connectTimeoutMs = connectTimeout_;
+  req.readTimeoutMs = readTimeout_;
+  const auto resp = getHttpTransport().send(req);
+  if (resp.statusCode != 200) {
     throw Darabonba::Exception(CLOUD_SSO_FETCH_ERROR_MSG + " Status code is " +
-                               std::to_string(resp->getStatusCode()) +
-                               ". Body is " +
-                               Darabonba::Stream::readAsString(resp->getBody()));
+                               std::to_string(resp.statusCode) +
+                               ". Body is " + resp.body);
   }
 
-  auto result = Darabonba::Stream::readAsJSON(resp->getBody());
+  auto result = Darabonba::Json::parse(resp.body);
   if (result.contains("Code") &&
       result["Code"].get<std::string>() != "Success") {
     throw Darabonba::Exception(CLOUD_SSO_FETCH_ERROR_MSG +
                                " Response: " + result.dump());
   }
 
-  auto &credential = result["RoleCredentials"];
-  std::string accessKeyId = credential["AccessKeyId"].get<std::string>();
+  auto &roleCredentials = result["RoleCredentials"];
+  std::string accessKeyId = roleCredentials["AccessKeyId"].get<std::string>();
   std::string accessKeySecret =
-      credential["AccessKeySecret"].get<std::string>();
-  std::string securityToken = credential["SecurityToken"].get<std::string>();
-  auto expiration = strtotime(credential["Expiration"].get<std::string>());
+      roleCredentials["AccessKeySecret"].get<std::string>();
+  std::string securityToken =
+      roleCredentials["SecurityToken"].get<std::string>();
+  auto expiration =
+      strtotime(roleCredentials["Expiration"].get<std::string>());
 
-  this->expiration_ = expiration;
-  credential_.setAccessKeyId(accessKeyId)
+  Models::CredentialModel credential;
+  credential.setType(Constant::CLOUD_SSO)
+      .setAccessKeyId(accessKeyId)
       .setAccessKeySecret(accessKeySecret)
-      .setSecurityToken(securityToken);
-  return true;
+      .setSecurityToken(securityToken)
+      .setProviderName(getProviderName());
+  return makeRefreshResult(credential, expiration);
 }
 
 } // namespace Credential
@@ -0,0 +1,332 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+
+#include <darabonba/Env.hpp>
+
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/provider/CredentialFileCache.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+namespace {
+
+const char SEALED_MAGIC[] = "ACC1";      // Sealed file header
+const size_t MAGIC_SIZE = 4;
+const size_t IV_SIZE = 12;
+const size_t TAG_SIZE = 16;
+const size_t MAX_FILE_SIZE = 64 * 1024;  // Anything bigger is not ours
+
+std::string sha256(const std::string &data) {
+  unsigned char digest[SHA256_DIGEST_LENGTH];
+  SHA256(reinterpret_cast<const unsigned char *>(data.data()), data.size(),
+         digest);
+  return std::string(reinterpret_cast<const char *>(digest), sizeof(digest));
+}
+
+std::string hex(const std::string &bytes) {
+  static const char digits[] = "0123456789abcdef";
+  std::string out;
+  out.reserve(bytes.size() * 2);
+  for (unsigned char c : bytes) {
+    out.push_back(digits[c >> 4]);
+    out.push_back(digits[c & 0x0f]);
+  }
+  return out;
+}
+
+#ifndef _WIN32
+std::string readSmallFile(const char *path) {
+  std::ifstream in(path);
+  std::string line;
+  std::getline(in, line);
+  return line;
+}
+
+// Machine id and user id: stable for this account on this host only
+std::string hostKey() {
+  std::string machine = readSmallFile("/etc/machine-id");
+  if (machine.empty()) {
+    machine = readSmallFile("/var/lib/dbus/machine-id");
+  }
+  if (machine.empty()) {
+    char host[256] = {0};
+    if (gethostname(host, sizeof(host) - 1) == 0) {
+      machine = host;
+    }
+  }
+  return sha256("alibabacloud-credential-cache:v1:" + machine + ":" +
+                std::to_string(static_cast<long>(geteuid())));
+}
+
+bool seal(const std::string &plain, const std::string &aad, std::string &out) {
+  const std::string key = hostKey();
+  unsigned char iv[IV_SIZE];
+  if (RAND_bytes(iv, sizeof(iv)) != 1) {
+    return false;
+  }
+  EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+  if (ctx == nullptr) {
+    return false;
+  }
+  std::vector<unsigned char> cipher(plain.size() + 16);
+  unsigned char tag[TAG_SIZE];
+  int len = 0;
+  int total = 0;
+  bool ok =
+      EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr,
+                         reinterpret_cast<const unsigned char *>(key.data()),
+                         iv) == 1 &&
+      EVP_EncryptUpdate(ctx, nullptr, &len,
+                        reinterpret_cast<const unsigned char *>(aad.data()),
+                        static_cast<int>(aad.size())) == 1 &&
+      EVP_EncryptUpdate(ctx, cipher.data(), &len,
+                        reinterpret_cast<const unsigned char *>(plain.data()),
+                        static_cast<int>(plain.size())) == 1;
+  total = len;
+  ok = ok && EVP_EncryptFinal_ex(ctx, cipher.data() + total, &len) == 1;
+  total += len;
+  ok = ok && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, TAG_SIZE, tag) == 1;
+  EVP_CIPHER_CTX_free(ctx);
+  if (!ok) {
+    return false;
+  }
+  out.assign(SEALED_MAGIC, MAGIC_SIZE);
+  out.append(reinterpret_cast<const char *>(iv), IV_SIZE);
+  out.append(reinterpret_cast<const char *>(tag), TAG_SIZE);
+  out.append(reinterpret_cast<const char *>(cipher.data()), total);
+  return true;
+}
+
+bool unseal(const std::string &sealed, const std::string &aad,
+            std::string &out) {
+  if (sealed.size() < MAGIC_SIZE + IV_SIZE + TAG_SIZE ||
+      sealed.compare(0, MAGIC_SIZE, SEALED_MAGIC) != 0) {
+    return false;
+  }
+  const std::string key = hostKey();
+  const auto *iv =
+      reinterpret_cast<const unsigned char *>(sealed.data() + MAGIC_SIZE);
+  std::string tag = sealed.substr(MAGIC_SIZE + IV_SIZE, TAG_SIZE);
+  const auto *cipher = reinterpret_cast<const unsigned char *>(
+      sealed.data() + MAGIC_SIZE + IV_SIZE + TAG_SIZE);
+  const int cipherSize =
+      static_cast<int>(sealed.size() - MAGIC_SIZE - IV_SIZE - TAG_SIZE);
+
+  EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+  if (ctx == nullptr) {
+    return false;
+  }
+  std::vector<unsigned char> plain(cipherSize + 16);
+  int len = 0;
+  int total = 0;
+  bool ok =
+      EVP_DecryptInit_ex(ctx, EVP_aes_256_gcm(), nullptr,
+                         reinterpret_cast<const unsigned char *>(key.data()),
+                         iv) == 1 &&
+      EVP_DecryptUpdate(ctx, nullptr, &len,
+                        reinterpret_cast<const unsigned char *>(aad.data()),
+                        static_cast<int>(aad.size())) == 1 &&
+      EVP_DecryptUpdate(ctx, plain.data(), &len, cipher, cipherSize) == 1;
+  total = len;
+  ok = ok && EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, TAG_SIZE,
+                                 &tag[0]) == 1;
+  // Fails if the file was tampered with or sealed on another host
+  ok = ok && EVP_DecryptFinal_ex(ctx, plain.data() + total, &len) == 1;
+  total += len;
+  EVP_CIPHER_CTX_free(ctx);
+  if (!ok) {
+    return false;
+  }
+  out.assign(reinterpret_cast<const char *>(plain.data()), total);
+  return true;
+}
+
+bool makeDirectory(const std::string &directory) {
+  struct stat st;
+  if (stat(directory.c_str(), &st) == 0) {
+    return S_ISDIR(st.st_mode);
+  }
+  auto slash = directory.find_last_of('/');
+  if (slash != std::string::npos && slash > 0 &&
+      !makeDirectory(directory.substr(0, slash))) {
+    return false;
+  }
+  return mkdir(directory.c_str(), 0700) == 0 || errno == EEXIST;
+}
+#endif
+
+} // namespace
+
+std::shared_ptr<CredentialFileCache> CredentialFileCache::getDefault() {
+  static std::shared_ptr<CredentialFileCache> instance = []() {
+    Options options;
+    options.directory = Darabonba::Env::getEnv(Constant::ENV_CREDENTIALS_CACHE_DIR);
+    if (options.directory.empty()) {
+      return std::shared_ptr<CredentialFileCache>();
+    }
+    options.encrypt =
+        Darabonba::Env::getEnv(Constant::ENV_CREDENTIALS_CACHE_ENCRYPTED) == "true";
+    return std::make_shared<CredentialFileCache>(options);
+  }();
+  return instance;
+}
+
+std::string CredentialFileCache::makeKey(std::initializer_list<std::string> parts) {
+  std::string key;
+  for (const auto &part : parts) {
+    key += std::to_string(part.size());
+    key += ':';
+    key += part;
+  }
+  return key;
+}
+
+CredentialFileCache::CredentialFileCache(const Options &options)
+    : options_(options) {
+  while (options_.directory.size() > 1 && options_.directory.back() == '/') {
+    options_.directory.pop_back();
+  }
+}
+
+std::string CredentialFileCache::hashKey(const std::string &key) {
+  return hex(sha256(key));
+}
+
+std::string CredentialFileCache::getPath(const std::string &key) const {
+  return options_.directory + "/" + hashKey(key) + ".json";
+}
+
+#ifndef _WIN32
+
+bool CredentialFileCache::load(const std::string &key, Entry &entry) const {
+  const std::string path = getPath(key);
+  int fd = open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_uid != geteuid() ||
+      (st.st_mode & 077) != 0 || st.st_size <= 0 ||
+      static_cast<size_t>(st.st_size) > MAX_FILE_SIZE) {
+    close(fd);
+    return false;
+  }
+  std::string content(static_cast<size_t>(st.st_size), '\0');
+  size_t done = 0;
+  while (done < content.size()) {
+    ssize_t n = read(fd, &content[done], content.size() - done);
+    if (n <= 0) {
+      close(fd);
+      return false;
+    }
+    done += static_cast<size_t>(n);
+  }
+  close(fd);
+
+  std::string json;
+  if (options_.encrypt) {
+    if (!unseal(content, sha256(key), json)) {
+      return false;
+    }
+  } else {
+    json.swap(content);
+  }
+
+  try {
+    auto value = Darabonba::Json::parse(json);
+    if (value.value("version", 0) != 1 || !value.contains("credential")) {
+      return false;
+    }
+    Entry loaded;
+    loaded.credential.fromMap(value["credential"]);
+    loaded.staleTime = value.value("staleTime", static_cast<int64_t>(0));
+    loaded.prefetchTime = value.value("prefetchTime", static_cast<int64_t>(0));
+    entry = std::move(loaded);
+    return true;
+  } catch (const std::exception &) {
+    return false;
+  }
+}
+
+bool CredentialFileCache::store(const std::string &key,
+                                const Entry &entry) const {
+  std::string content;
+  try {
+    Darabonba::Json value;
+    value["version"] = 1;
+    value["staleTime"] = entry.staleTime;
+    value["prefetchTime"] = entry.prefetchTime;
+    value["credential"] = entry.credential.toMap();
+    content = value.dump();
+  } catch (const std::exception &) {
+    return false;
+  }
+  if (options_.encrypt && !seal(std::string(content), sha256(key), content)) {
+    return false;
+  }
+  if (!makeDirectory(options_.directory)) {
+    return false;
+  }
+
+  // Write a private temporary file and rename it over the entry, so readers
+  // never see a partial file. mkstemp() picks a new name per call: threads
+  // of one process storing the same key must not share it
+  const std::string path = getPath(key);
+  std::vector<char> temp(path.begin(), path.end());
+  const char suffix[] = ".tmp.XXXXXX";
+  temp.insert(temp.end(), suffix, suffix + sizeof(suffix));
+  int fd = mkstemp(temp.data());
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = fcntl(fd, F_SETFD, FD_CLOEXEC) == 0 && fchmod(fd, 0600) == 0;
+  size_t done = 0;
+  while (ok && done < content.size()) {
+    ssize_t n = write(fd, content.data() + done, content.size() - done);
+    ok = n > 0;
+    done += ok ? static_cast<size_t>(n) : 0;
+  }
+  ok = close(fd) == 0 && ok;
+  if (!ok || rename(temp.data(), path.c_str()) != 0) {
+    unlink(temp.data());
+    return false;
+  }
+  return true;
+}
+
+void CredentialFileCache::remove(const std::string &key) const {
+  unlink(getPath(key).c_str());
+}
+
+#else
+
+bool CredentialFileCache::load(const std::string &, Entry &) const {
+  return false;
+}
+
+bool CredentialFileCache::store(const std::string &, const Entry &) const {
+  return false;
+}
+
+void CredentialFileCache::remove(const std::string &) const {}
+
+#endif
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -1,6 +1,16 @@
-#include <darabonba/Env.hpp>
+#include <algorithm>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <darabonba/Exception.hpp>
 
+#include <alibabacloud/credential/Constant.hpp>
 #include <alibabacloud/credential/provider/DefaultProvider.hpp>
 #include <alibabacloud/credential/provider/EcsRamRoleProvider.hpp>
 #include <alibabacloud/credential/provider/EnvironmentVariableProvider.hpp>
@@ -10,73 +20,236 @@
 namespace AlibabaCloud {
 namespace Credential {
 
-DefaultProvider::DefaultProvider() {
+DefaultProvider::DefaultProvider(
+    std::shared_ptr<const EnvironmentSource> environment) {
+  if (environment == nullptr) {
+    environment = EnvironmentSource::fromProcess();
+  }
+  parallelResolutionEnabled_ =
+      environment->get(Constant::ENV_CREDENTIALS_PARALLEL_RESOLUTION) == "true";
+  addProviders(environment, nullptr);
+}
+
+DefaultProvider::DefaultProvider(
+    std::shared_ptr<Models::Config> config,
+    std::shared_ptr<const EnvironmentSource> environment)
+    : reuseLastProviderEnabled_(config->getReuseLastProviderEnabled()) {
+  if (environment == nullptr) {
+    environment = EnvironmentSource::fromProcess();
+  }
+  parallelResolutionEnabled_ =
+      config->getParallelResolutionEnabled() ||
+      environment->get(Constant::ENV_CREDENTIALS_PARALLEL_RESOLUTION) == "true";
+  addProviders(environment, config->getHttpTransport());
+}
 
-  providers_.emplace_back(new EnvironmentVariableProvider());
+void DefaultProvider::addProviders(
+    const std::shared_ptr<const EnvironmentSource> &environment,
+    const std::shared_ptr<HttpTransport> &transport) {
+  providers_.emplace_back(new EnvironmentVariableProvider(environment));
 
-  auto oidcTokenFile = Darabonba::Env::getEnv("ALIBABA_CLOUD_OIDC_TOKEN_FILE"),
-       roleArn = Darabonba::Env::getEnv("ALIBABA_CLOUD_ROLE_ARN"),
-       oidcProviderArn =
-           Darabonba::Env::getEnv("ALIBABA_CLOUD_OIDC_PROVIDER_ARN");
+  auto oidcTokenFile = environment->get("ALIBABA_CLOUD_OIDC_TOKEN_FILE"),
+       roleArn = environment->get("ALIBABA_CLOUD_ROLE_ARN"),
+       oidcProviderArn = environment->get("ALIBABA_CLOUD_OIDC_PROVIDER_ARN");
   if (!oidcTokenFile.empty() && !roleArn.empty() && !oidcProviderArn.empty()) {
-    auto roleSessionName =
-        Darabonba::Env::getEnv("ALIBABA_CLOUD_ROLE_SESSION_NAME");
-    providers_.emplace_back(new OIDCRoleArnProvider(
-        roleArn, oidcProviderArn, oidcTokenFile, roleSessionName));
+    auto roleSessionName = environment->get("ALIBABA_CLOUD_ROLE_SESSION_NAME");
+    auto oidc = new OIDCRoleArnProvider(roleArn, oidcProviderArn, oidcTokenFile,
+                                        roleSessionName);
+    oidc->setHttpTransport(transport);
+    providers_.emplace_back(oidc);
   }
 
   providers_.emplace_back(new ProfileProvider());
 
   // Check if ECS metadata access is disabled
   auto ecsMetadataDisabled =
-      Darabonba::Env::getEnv("ALIBABA_CLOUD_ECS_METADATA_DISABLED");
+      environment->get("ALIBABA_CLOUD_ECS_METADATA_DISABLED");
   if (ecsMetadataDisabled != "true" && ecsMetadataDisabled != "True" &&
       ecsMetadataDisabled != "TRUE") {
-    auto ecsMetaData = Darabonba::Env::getEnv("ALIBABA_CLOUD_ECS_METADATA");
+    auto ecsMetaData = environment->get("ALIBABA_CLOUD_ECS_METADATA");
     if (!ecsMetaData.empty()) {
-      providers_.emplace_back(new EcsRamRoleProvider(ecsMetaData));
+      auto ecs = new EcsRamRoleProvider(
+          ecsMetaData, false, true, StaleValueBehavior::ALLOW_,
+          std::make_shared<NonBlockingPrefetch>(), environment);
+      ecs->setHttpTransport(transport);
+      providers_.emplace_back(ecs);
     }
   }
 
-  auto url = Darabonba::Env::getEnv("ALIBABA_CLOUD_CREDENTIALS_URI");
+  auto url = environment->get("ALIBABA_CLOUD_CREDENTIALS_URI");
   if (!url.empty()) {
-    providers_.emplace_back(new URLProvider(url));
+    auto urlProvider = new URLProvider(url);
+    urlProvider->setHttpTransport(transport);
+    providers_.emplace_back(urlProvider);
   }
 }
 
-DefaultProvider::DefaultProvider(std::shared_ptr<Models::Config> config)
-    : reuseLastProviderEnabled_(config->getReuseLastProviderEnabled()) {
+// C++11 requires out-of-class definition for constexpr static members
+constexpr int64_t DefaultProvider::INITIAL_BACKOFF_MS;
+constexpr int64_t DefaultProvider::MAX_BACKOFF_MS;
 
-  providers_.emplace_back(new EnvironmentVariableProvider());
+static bool probe(const Provider &provider) {
+  try {
+    provider.getCredential();
+    return true;
+  } catch (const std::exception &) {
+    return false;
+  }
+}
 
-  auto oidcTokenFile = Darabonba::Env::getEnv("ALIBABA_CLOUD_OIDC_TOKEN_FILE"),
-       roleArn = Darabonba::Env::getEnv("ALIBABA_CLOUD_ROLE_ARN"),
-       oidcProviderArn =
-           Darabonba::Env::getEnv("ALIBABA_CLOUD_OIDC_PROVIDER_ARN");
-  if (!oidcTokenFile.empty() && !roleArn.empty() && !oidcProviderArn.empty()) {
-    auto roleSessionName =
-        Darabonba::Env::getEnv("ALIBABA_CLOUD_ROLE_SESSION_NAME");
-    providers_.emplace_back(new OIDCRoleArnProvider(
-        roleArn, oidcProviderArn, oidcTokenFile, roleSessionName));
+void DefaultProvider::recordFailure(size_t index, int64_t now) const {
+  ProbeState &state = probeStates_[index];
+  const int shift = std::min(state.failures, 20);
+  state.retryAt = now + std::min(INITIAL_BACKOFF_MS << shift, MAX_BACKOFF_MS);
+  ++state.failures;
+}
+
+void DefaultProvider::markFailed(Provider *provider) const {
+  std::lock_guard<std::mutex> lock(resolveMutex_);
+  Provider *expected = provider;
+  if (!lastSuccessfulProvider_.compare_exchange_strong(
+          expected, nullptr, std::memory_order_acq_rel)) {
+    return;  // Already replaced by another resolution
+  }
+  probeStates_.resize(providers_.size());
+  for (size_t i = 0; i < providers_.size(); ++i) {
+    if (providers_[i].get() == provider) {
+      recordFailure(i, Internal::nowMs());
+    }
   }
+}
 
-  providers_.emplace_back(new ProfileProvider());
+Provider *DefaultProvider::resolve() const {
+  std::lock_guard<std::mutex> resolveLock(resolveMutex_);
+  // Another caller may have resolved the chain while we waited
+  Provider *cached = lastSuccessfulProvider_.load(std::memory_order_acquire);
+  if (cached != nullptr && !reprobeDue()) {
+    return cached;
+  }
+  return probeChain();
+}
 
-  // Check if ECS metadata access is disabled
-  auto ecsMetadataDisabled =
-      Darabonba::Env::getEnv("ALIBABA_CLOUD_ECS_METADATA_DISABLED");
-  if (ecsMetadataDisabled != "true" && ecsMetadataDisabled != "True" &&
-      ecsMetadataDisabled != "TRUE") {
-    auto ecsMetaData = Darabonba::Env::getEnv("ALIBABA_CLOUD_ECS_METADATA");
-    if (!ecsMetaData.empty()) {
-      providers_.emplace_back(new EcsRamRoleProvider(ecsMetaData));
+Provider *DefaultProvider::probeChain() const {
+  probeStates_.resize(providers_.size());
+  const int64_t now = Internal::nowMs();
+  std::vector<bool> due(providers_.size());
+  for (size_t i = 0; i < providers_.size(); ++i) {
+    due[i] = providers_[i] != nullptr && probeStates_[i].retryAt <= now;
+  }
+
+  const int winner =
+      parallelResolutionEnabled_ ? probeInParallel(due) : probeInOrder(due);
+  if (winner < 0) {
+    lastSuccessfulProvider_.store(nullptr, std::memory_order_release);
+    throw Darabonba::Exception("Can't get the credential.");
+  }
+
+  probeStates_[winner] = ProbeState();
+  int64_t reprobeAt = INT64_MAX;
+  for (int i = 0; i < winner; ++i) {
+    if (providers_[i] != nullptr) {
+      reprobeAt = std::min(reprobeAt, probeStates_[i].retryAt);
     }
   }
+  reprobeAt_.store(reprobeAt, std::memory_order_relaxed);
+  lastSuccessfulProvider_.store(providers_[winner].get(),
+                                std::memory_order_release);
+  const Provider *previous =
+      generationProvider_.load(std::memory_order_relaxed);
+  if (previous != providers_[winner].get()) {
+    generationProvider_.store(providers_[winner].get(),
+                              std::memory_order_release);
+    if (previous != nullptr) {
+      generationBase_.store(
+          nextGenerationBase(generationBase_.load(std::memory_order_relaxed),
+                             previous),
+          std::memory_order_release);
+    }
+  }
+  return providers_[winner].get();
+}
 
-  auto url = Darabonba::Env::getEnv("ALIBABA_CLOUD_CREDENTIALS_URI");
-  if (!url.empty()) {
-    providers_.emplace_back(new URLProvider(url));
+int DefaultProvider::probeInOrder(const std::vector<bool> &due) const {
+  for (size_t i = 0; i < providers_.size(); ++i) {
+    if (!due[i]) {
+      continue;
+    }
+    if (probe(*providers_[i])) {
+      return static_cast<int>(i);
+    }
+    recordFailure(i, Internal::nowMs());
+  }
+  return -1;
+}
+
+int DefaultProvider::probeInParallel(const std::vector<bool> &due) const {
+  // Results are shared with probe threads that may outlive this call and
+  // this provider
+  struct Probes {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<int> results;  // 0: running, 1: succeeded, -1: failed
+  };
+  auto probes = std::make_shared<Probes>();
+  probes->results.assign(providers_.size(), -1);
+
+  // The highest-priority due provider is probed on the calling thread
+  size_t first = providers_.size();
+  for (size_t i = 0; i < providers_.size(); ++i) {
+    if (!due[i]) {
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lock(runningProbes_->mutex);
+      runningProbes_->running.resize(providers_.size());
+      if (runningProbes_->running[i]) {
+        // Still blocked in a probe of an earlier resolution: counts as a
+        // failure instead of tying up another thread
+        continue;
+      }
+      probes->results[i] = 0;
+      if (first == providers_.size()) {
+        first = i;
+        continue;
+      }
+      runningProbes_->running[i] = true;
+    }
+    // The thread owns what it uses: it may outlive this provider
+    std::shared_ptr<const Provider> provider = providers_[i];
+    std::shared_ptr<RunningProbes> running = runningProbes_;
+    std::thread([probes, provider, running, i] {
+      int result = -1;
+      try {
+        result = probe(*provider) ? 1 : -1;
+      } catch (...) {
+      }
+      {
+        std::lock_guard<std::mutex> lock(probes->mutex);
+        probes->results[i] = result;
+      }
+      probes->cond.notify_all();
+      std::lock_guard<std::mutex> lock(running->mutex);
+      running->running[i] = false;
+    }).detach();
+  }
+  if (first < providers_.size()) {
+    const int result = probe(*providers_[first]) ? 1 : -1;
+    std::lock_guard<std::mutex> lock(probes->mutex);
+    probes->results[first] = result;
+  }
+
+  // Walk in priority order: a success only wins once all before it failed
+  std::unique_lock<std::mutex> lock(probes->mutex);
+  for (size_t i = 0; i < providers_.size(); ++i) {
+    probes->cond.wait(lock, [&probes, i] { return probes->results[i] != 0; });
+    if (probes->results[i] == 1) {
+      return static_cast<int>(i);
+    }
+    if (due[i]) {
+      recordFailure(i, Internal::nowMs());
+    }
   }
+  return -1;
 }
 
 } // namespace Credential
@@ -1,7 +1,8 @@
 #include <alibabacloud/credential/AuthUtil.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
+#include <alibabacloud/credential/internal/Clock.hpp>
 #include <alibabacloud/credential/provider/EcsRamRoleProvider.hpp>
 #include <darabonba/Core.hpp>
-#include <darabonba/Env.hpp>
 #include <darabonba/encode/Encoder.hpp>
 #include <memory>
 
@@ -12,6 +13,7 @@ namespace Credential {
 constexpr int EcsRamRoleProvider::DEFAULT_READ_TIMEOUT;
 constexpr int EcsRamRoleProvider::DEFAULT_CONNECT_TIMEOUT;
 constexpr int EcsRamRoleProvider::DEFAULT_METADATA_TOKEN_DURATION;
+constexpr int EcsRamRoleProvider::METADATA_TOKEN_RENEW_BEFORE;
 
 // 常量定义（对应 Python SDK）
 const std::string EcsRamRoleProvider::URL_IN_ECS_META_DATA =
@@ -28,7 +30,8 @@ const std::string EcsRamRoleProvider::ECS_METADATA_TOKEN_FETCH_ERROR_MSG =
 // 构造函数实现
 EcsRamRoleProvider::EcsRamRoleProvider(
     std::shared_ptr<Models::Config> config, bool asyncUpdateEnabled,
-    StaleValueBehavior behavior, std::shared_ptr<PrefetchStrategy> strategy)
+    StaleValueBehavior behavior, std::shared_ptr<PrefetchStrategy> strategy,
+    std::shared_ptr<const EnvironmentSource> environment)
     : RefreshableProvider(behavior, strategy),
       roleName_(config->hasRoleName() ? config->getRoleName() : ""),
       disableIMDSv1_(config->hasDisableIMDSv1() ? config->getDisableIMDSv1()
@@ -38,11 +41,15 @@ EcsRamRoleProvider::EcsRamRoleProvider(
                                                   : DEFAULT_CONNECT_TIMEOUT),
       readTimeout_(config->hasTimeout() ? config->getTimeout()
                                         : DEFAULT_READ_TIMEOUT) {
+  setHttpTransport(config->getHttpTransport());
+  if (environment == nullptr) {
+    environment = EnvironmentSource::fromProcess();
+  }
 
   // 检查是否禁用了 IMDS（对应 Python 的 environment_ecs_metadata_disabled
   // 检查）
   std::string ecsMetadataDisabled =
-      Darabonba::Env::getEnv("ALIBABA_CLOUD_ECS_METADATA_DISABLED");
+      environment->get("ALIBABA_CLOUD_ECS_METADATA_DISABLED");
   if (!ecsMetadataDisabled.empty() &&
       (ecsMetadataDisabled == "true" || ecsMetadataDisabled == "TRUE")) {
     throw std::runtime_error("IMDS credentials is disabled");
@@ -50,13 +57,14 @@ EcsRamRoleProvider::EcsRamRoleProvider(
 
   // 如果未设置角色名，尝试从环境变量获取
   if (roleName_.empty()) {
-    roleName_ = Darabonba::Env::getEnv("ALIBABA_CLOUD_ECS_METADATA");
+    roleName_ = environment->get("ALIBABA_CLOUD_ECS_METADATA");
   }
+  configuredRoleName_ = roleName_;
 
   // 如果未设置 disableIMDSv1，检查环境变量
   if (!disableIMDSv1_) {
     std::string imdsv1Disabled =
-        Darabonba::Env::getEnv("ALIBABA_CLOUD_IMDSV1_DISABLED");
+        environment->get("ALIBABA_CLOUD_IMDSV1_DISABLED");
     disableIMDSv1_ = (!imdsv1Disabled.empty() &&
                       (imdsv1Disabled == "true" || imdsv1Disabled == "TRUE"));
   }
@@ -64,59 +72,62 @@ EcsRamRoleProvider::EcsRamRoleProvider(
 
 EcsRamRoleProvider::EcsRamRoleProvider(
     const std::string &roleName, bool disableIMDSv1, bool asyncUpdateEnabled,
-    StaleValueBehavior behavior, std::shared_ptr<PrefetchStrategy> strategy)
+    StaleValueBehavior behavior, std::shared_ptr<PrefetchStrategy> strategy,
+    std::shared_ptr<const EnvironmentSource> environment)
     : RefreshableProvider(behavior, strategy), roleName_(roleName),
       disableIMDSv1_(disableIMDSv1), shouldRefresh_(false),
       asyncUpdateEnabled_(asyncUpdateEnabled),
       connectTimeout_(DEFAULT_CONNECT_TIMEOUT),
       readTimeout_(DEFAULT_READ_TIMEOUT) {
+  if (environment == nullptr) {
+    environment = EnvironmentSource::fromProcess();
+  }
 
   // 检查环境变量
   std::string ecsMetadataDisabled =
-      Darabonba::Env::getEnv("ALIBABA_CLOUD_ECS_METADATA_DISABLED");
+      environment->get("ALIBABA_CLOUD_ECS_METADATA_DISABLED");
   if (!ecsMetadataDisabled.empty() &&
       (ecsMetadataDisabled == "true" || ecsMetadataDisabled == "TRUE")) {
     throw std::runtime_error("IMDS credentials is disabled");
   }
 
   if (roleName_.empty()) {
-    roleName_ = Darabonba::Env::getEnv("ALIBABA_CLOUD_ECS_METADATA");
+    roleName_ = environment->get("ALIBABA_CLOUD_ECS_METADATA");
   }
+  configuredRoleName_ = roleName_;
 
   if (!disableIMDSv1_) {
     std::string imdsv1Disabled =
-        Darabonba::Env::getEnv("ALIBABA_CLOUD_IMDSV1_DISABLED");
+        environment->get("ALIBABA_CLOUD_IMDSV1_DISABLED");
     disableIMDSv1_ = (!imdsv1Disabled.empty() &&
                       (imdsv1Disabled == "true" || imdsv1Disabled == "TRUE"));
   }
 }
 
 // 获取 IMDSv2 Token（对应 Python 的 _get_metadata_token）
-std::string EcsRamRoleProvider::getMetadataToken() const {
+std::string EcsRamRoleProvider::fetchMetadataToken() const {
   std::string url =
       "http://" + META_DATA_SERVICE_HOST + URL_IN_ECS_METADATA_TOKEN;
 
   // 使用 getNewRequest 创建带 User-Agent 的请求（对应 Python SDK）
-  auto req = AuthUtil::getNewRequest(url);
-  req.setMethod("PUT");
-  req.getHeaders()["X-aliyun-ecs-metadata-token-ttl-seconds"] =
+  auto req = AuthUtil::getNewHttpRequest(url);
+  req.method = "PUT";
+  req.headers["X-aliyun-ecs-metadata-token-ttl-seconds"] =
       std::to_string(DEFAULT_METADATA_TOKEN_DURATION);
 
   try {
     // 使用保存的超时配置
-    Darabonba::RuntimeOptions runtime;
-    runtime.setConnectTimeout(connectTimeout_);
-    runtime.setReadTimeout(readTimeout_);
-    auto future = Darabonba::Core::doAction(req, runtime);
-    const auto resp = future.get();
+    req.connectTimeoutMs = connectTimeout_;
+    req.readTimeoutMs = readTimeout_;
+    const auto resp = getHttpTransport().send(req);
 
-    if (resp->getStatusCode() != 200) {
+    if (resp.statusCode != 200) {
       throw Darabonba::Exception(
           ECS_METADATA_TOKEN_FETCH_ERROR_MSG +
-          " HttpCode=" + std::to_string(resp->getStatusCode()));
+          " HttpCode=" + std::to_string(resp.statusCode));
     }
 
-    return Darabonba::IFStream::readAsString(resp->getBody());
+    return resp.body;
   } catch (const std::exception &e) {
     // 如果禁用了 IMDSv1，抛出异常
     if (disableIMDSv1_) {
@@ -127,6 +138,55 @@ std::string EcsRamRoleProvider::getMetadataToken() const {
   }
 }
 
+std::string EcsRamRoleProvider::getMetadataToken() const {
+  std::lock_guard<std::mutex> lock(metadataTokenMutex_);
+  if (metadataTokenRenewAt_ != 0 && Internal::nowMs() < metadataTokenRenewAt_) {
+    return metadataToken_;
+  }
+  const int64_t requestedAt = Internal::nowMs();
+  metadataToken_ = fetchMetadataToken();
+  metadataTokenRenewAt_ =
+      metadataToken_.empty()
+          ? 0
+          : requestedAt + static_cast<int64_t>(DEFAULT_METADATA_TOKEN_DURATION -
+                                               METADATA_TOKEN_RENEW_BEFORE) *
+                              1000;
+  return metadataToken_;
+}
+
+void EcsRamRoleProvider::invalidateMetadataToken() const {
+  std::lock_guard<std::mutex> lock(metadataTokenMutex_);
+  metadataToken_.clear();
+  metadataTokenRenewAt_ = 0;
+}
+
+int EcsRamRoleProvider::getMetadata(const std::string &url,
+                                    std::string &body) const {
+  for (int attempt = 0;; ++attempt) {
+    // 使用 getNewRequest 创建带 User-Agent 的请求（对应 Python SDK）
+    auto req = AuthUtil::getNewHttpRequest(url);
+    const std::string metadataToken = getMetadataToken();
+    if (!metadataToken.empty()) {
+      req.headers["X-aliyun-ecs-metadata-token"] = metadataToken;
+    }
+
+    // 使用保存的超时配置
+    req.connectTimeoutMs = connectTimeout_;
+    req.readTimeoutMs = readTimeout_;
+    auto resp = getHttpTransport().send(req);
+
+    const int statusCode = resp.statusCode;
+    if (statusCode == 401 && !metadataToken.empty()) {
+      invalidateMetadataToken();
+      if (attempt == 0) {
+        continue;
+      }
+    }
+    body = std::move(resp.body);
+    return statusCode;
+  }
+}
+
 // 刷新凭据（对应 Python 的 _refresh_credentials）
 RefreshResult EcsRamRoleProvider::doRefresh() const {
   // 获取角色名（如果未设置）
@@ -136,31 +196,18 @@ RefreshResult EcsRamRoleProvider::doRefresh() const {
     roleName_ = roleNameToUse; // 缓存角色名
   }
 
-  // 使用 getNewRequest 构建带 User-Agent 的请求（对应 Python SDK）
+  // 与获取角色名共用 IMDSv2 Token
   std::string url =
       "http://" + META_DATA_SERVICE_HOST + URL_IN_ECS_META_DATA + roleNameToUse;
-  auto req = AuthUtil::getNewRequest(url);
-
-  // 尝试获取 IMDSv2 Token
-  std::string metadataToken = getMetadataToken();
-  if (!metadataToken.empty()) {
-    req.getHeaders()["X-aliyun-ecs-metadata-token"] = metadataToken;
-  }
-
-  // 发送请求，使用保存的超时配置
-  Darabonba::RuntimeOptions runtime;
-  runtime.setConnectTimeout(connectTimeout_);
-  runtime.setReadTimeout(readTimeout_);
-  auto future = Darabonba::Core::doAction(req, runtime);
-  auto resp = future.get();
-
-  if (resp->getStatusCode() != 200) {
+  std::string body;
+  const int statusCode = getMetadata(url, body);
+  if (statusCode != 200) {
     throw Darabonba::Exception(ECS_METADATA_FETCH_ERROR_MSG + " HttpCode=" +
-                               std::to_string(resp->getStatusCode()));
+                               std::to_string(statusCode));
   }
 
   // 解析响应
-  auto result = Darabonba::IFStream::readAsJSON(resp->getBody());
+  auto result = Darabonba::Json::parse(body);
 
   std::string contentCode = result["Code"].get<std::string>();
   if (contentCode != "Success") {
@@ -199,29 +246,13 @@ RefreshResult EcsRamRoleProvider::doRefresh() const {
 // 获取角色名（对应 Python 的 _get_role_name）
 std::string EcsRamRoleProvider::getRoleName() const {
   std::string url = "http://" + META_DATA_SERVICE_HOST + URL_IN_ECS_META_DATA;
-
-  // 使用 getNewRequest 创建带 User-Agent 的请求（对应 Python SDK）
-  auto req = AuthUtil::getNewRequest(url);
-
-  // 尝试获取 IMDSv2 Token
-  std::string metadataToken = getMetadataToken();
-  if (!metadataToken.empty()) {
-    req.getHeaders()["X-aliyun-ecs-metadata-token"] = metadataToken;
-  }
-
-  // 使用保存的超时配置
-  Darabonba::RuntimeOptions runtime;
-  runtime.setConnectTimeout(connectTimeout_);
-  runtime.setReadTimeout(readTimeout_);
-  auto future = Darabonba::Core::doAction(req, runtime);
-  auto resp = future.get();
-
-  if (resp->getStatusCode() != 200) {
+  std::string body;
+  const int statusCode = getMetadata(url, body);
+  if (statusCode != 200) {
     throw Darabonba::Exception(ECS_METADATA_FETCH_ERROR_MSG + " HttpCode=" +
-                               std::to_string(resp->getStatusCode()));
+                               std::to_string(statusCode));
   }
-
-  return Darabonba::IFStream::readAsString(resp->getBody());
+  return body;
 }
 
 // 计算 stale_time（对应 Python 的 _get_stale_time）
@@ -238,7 +269,7 @@ int64_t EcsRamRoleProvider::getStaleTime(int64_t expiration) const {
 }
 
 // 计算 prefetch_time（对应 Python 的 _get_prefetch_time）
-int64_t EcsRamRoleProvider::getPrefetchTime(int64_t expiration) {
+int64_t EcsRamRoleProvider::getPrefetchTime(int64_t expiration) const {
   const int64_t now = getCurrentTime();
 
   // Python 逻辑：如果 expiration < 0，返回 now + 5分钟
@@ -246,8 +277,10 @@ int64_t EcsRamRoleProvider::getPrefetchTime(int64_t expiration) {
     return now + 5 * 60;
   }
 
-  // Python 逻辑：否则返回 now + 60分钟
-  return now + 60 * 60;
+  // Lifetime-proportional and jittered, so instances booted together do not
+  // hit the metadata service in lockstep
+  return adaptPrefetchTime(getRefreshPolicy().getPrefetchTime(now, expiration),
+                           getStaleTime(expiration));
 }
 
 } // namespace Credential
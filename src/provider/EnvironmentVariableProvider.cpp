@@ -1,7 +1,5 @@
 #include <memory>
 
-#include <darabonba/Env.hpp>
-
 #include <alibabacloud/credential/provider/AccessKeyProvider.hpp>
 #include <alibabacloud/credential/provider/EnvironmentVariableProvider.hpp>
 #include <alibabacloud/credential/provider/StsProvider.hpp>
@@ -9,14 +7,63 @@
 namespace AlibabaCloud {
 namespace Credential {
 
-std::unique_ptr<Provider> EnvironmentVariableProvider::createProvider() {
-  const auto accessKeyId =
-      Darabonba::Env::getEnv("ALIBABA_CLOUD_ACCESS_KEY_ID");
+const Provider &EnvironmentVariableProvider::provider() const {
+  const Loaded *loaded = current();
+  if (loaded->provider == nullptr) {
+    throw Darabonba::Exception(loaded->error);
+  }
+  return *loaded->provider;
+}
+
+const EnvironmentVariableProvider::Loaded *
+EnvironmentVariableProvider::current() const {
+  const Loaded *pinned = loaded_.pin();
+  if (pinned != nullptr && pinned->version == environment_->getVersion()) {
+    return pinned;
+  }
+  std::lock_guard<std::mutex> lock(loadMutex_);
+  // Double check: another thread may have rebuilt meanwhile
+  const std::shared_ptr<const Loaded> loaded = loaded_.load();
+  // Version before values: a reload in between shows up next time
+  const uint64_t version = environment_->getVersion();
+  if (loaded != nullptr && loaded->version == version) {
+    return loaded_.pin();
+  }
+
+  auto next = std::make_shared<Loaded>();
+  next->version = version;
+  try {
+    next->provider = createProvider(*environment_);
+  } catch (const std::exception &e) {
+    next->error = e.what();
+  }
+
+  if (loaded != nullptr) {
+    bumpEpoch();
+    next->generationBase =
+        nextGenerationBase(loaded->generationBase, loaded->provider.get());
+  }
+  loaded_.store(std::move(next));
+  return loaded_.pin();
+}
+
+uint64_t EnvironmentVariableProvider::getGeneration() const {
+  // load(): pinning here would release the caller's last credential
+  const std::shared_ptr<const Loaded> loaded = loaded_.load();
+  if (loaded == nullptr) {
+    return 0;
+  }
+  return loaded->generationBase +
+         (loaded->provider != nullptr ? loaded->provider->getGeneration() : 0);
+}
+
+std::unique_ptr<Provider>
+EnvironmentVariableProvider::createProvider(const EnvironmentSource &environment) {
+  const auto accessKeyId = environment.get("ALIBABA_CLOUD_ACCESS_KEY_ID");
   const auto accessKeySecret =
-      Darabonba::Env::getEnv("ALIBABA_CLOUD_ACCESS_KEY_SECRET");
+      environment.get("ALIBABA_CLOUD_ACCESS_KEY_SECRET");
   if (!accessKeyId.empty() && !accessKeySecret.empty()) {
-    const auto securityToken =
-        Darabonba::Env::getEnv("ALIBABA_CLOUD_SECURITY_TOKEN");
+    const auto securityToken = environment.get("ALIBABA_CLOUD_SECURITY_TOKEN");
     if (securityToken.empty()) {
       return std::unique_ptr<Provider>(
           new AccessKeyProvider(accessKeyId, accessKeySecret));
@@ -28,11 +75,8 @@ std::unique_ptr<Provider> EnvironmentVariableProvider::createProvider() {
     throw Darabonba::Exception(
         "Environment variable accessKeyId cannot be empty");
   }
-  if (accessKeySecret.empty()) {
-    throw Darabonba::Exception(
-        "Environment variable accessKeySecret cannot be empty");
-  }
-  return nullptr;
+  throw Darabonba::Exception(
+      "Environment variable accessKeySecret cannot be empty");
 }
 } // namespace Credential
-} // namespace AlibabaCloud
\ No newline at end of file
+} // namespace AlibabaCloud
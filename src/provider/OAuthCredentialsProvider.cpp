@@ -1,4 +1,5 @@
 #include <alibabacloud/credential/AuthUtil.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
 #include <alibabacloud/credential/provider/OAuthCredentialsProvider.hpp>
 #include <darabonba/Core.hpp>
 #include <darabonba/encode/Encoder.hpp>
@@ -11,12 +12,12 @@ namespace Credential {
 const std::string OAuthCredentialsProvider::OAUTH_FETCH_ERROR_MSG =
     "Failed to get credentials from OAuth token endpoint.";
 
-bool OAuthCredentialsProvider::refreshCredential() const {
+RefreshResult OAuthCredentialsProvider::doRefresh() const {
   // OAuth 2.0 Client Credentials flow
 
   // 使用 getNewRequest 创建带 User-Agent 的请求（对应 Python SDK）
-  auto req = AuthUtil::getNewRequest(tokenEndpoint_);
-  req.setMethod("POST");
+  auto req = AuthUtil::getNewHttpRequest(tokenEndpoint_);
+  req.method = "POST";
 
   // Extract host from token endpoint
   size_t hostStart = tokenEndpoint_.find("://");
@@ -32,8 +33,7 @@ bool OAuthCredentialsProvider::refreshCredential() const {
   std::string path =
       (hostEnd != std::string::npos) ? tokenEndpoint_.substr(hostEnd) : "/";
 
-  req.getHeaders()["host"] = host;
-  req.getUrl().setHost(host);
+  req.headers["host"] = host;
   if (!path.empty() && path != "/") {
     Darabonba::Http::Query query;
     size_t queryPos = path.find('?');
@@ -44,7 +44,7 @@ bool OAuthCredentialsProvider::refreshCredential() const {
     }
   }
 
-  req.getHeaders()["Content-Type"] = "application/x-www-form-urlencoded";
+  req.headers["Content-Type"] = "application/x-www-form-urlencoded";
 
   // Build OAuth request body
   std::string body =
@@ -53,24 +53,20 @@ bool OAuthCredentialsProvider::refreshCredential() const {
       Darabonba::Encode::Encoder::urlEncode(clientId_) +
       "&client_secret=" + Darabonba::Encode::Encoder::urlEncode(clientSecret_);
 
-  // Use std::string directly instead of shared_ptr
-  req.setBody(body);
+  req.body = body;
 
   // 使用保存的超时配置
-  Darabonba::RuntimeOptions runtime;
-  runtime.setConnectTimeout(connectTimeout_);
-  runtime.setReadTimeout(readTimeout_);
-  auto future = Darabonba::Core::doAction(req, runtime);
-  auto resp = future.get();
+  req.connectTimeoutMs = connectTimeout_;
+  req.readTimeoutMs = readTimeout_;
+  const auto resp = getHttpTransport().send(req);
 
-  if (resp->getStatusCode() != 200) {
+  if (resp.statusCode != 200) {
     throw Darabonba::Exception(OAUTH_FETCH_ERROR_MSG + " Status code is " +
-                               std::to_string(resp->getStatusCode()) +
-                               ". Body is " +
-                               Darabonba::Stream::readAsString(resp->getBody()));
+                               std::to_string(resp.statusCode) +
+                               ". Body is " + resp.body);
   }
 
-  auto result = Darabonba::Stream::readAsJSON(resp->getBody());
+  auto result = Darabonba::Json::parse(resp.body);
 
   if (result.contains("error")) {
     throw Darabonba::Exception(
@@ -89,25 +85,28 @@ bool OAuthCredentialsProvider::refreshCredential() const {
   int64_t expiresIn = result.contains("expires_in")
                           ? result["expires_in"].get<int64_t>()
                           : 3600;
-  this->expiration_ = static_cast<int64_t>(time(nullptr)) + expiresIn;
+  int64_t expiration = getCurrentTime() + expiresIn;
 
   // For OAuth, we store the access token as a bearer token
-  credential_.setBearerToken(accessToken);
+  Models::CredentialModel credential;
+  credential.setType(Constant::OAUTH)
+      .setBearerToken(accessToken)
+      .setProviderName(getProviderName());
 
   // If the response includes additional credentials (some OAuth
   // implementations)
   if (result.contains("access_key_id")) {
-    credential_.setAccessKeyId(result["access_key_id"].get<std::string>());
+    credential.setAccessKeyId(result["access_key_id"].get<std::string>());
   }
   if (result.contains("access_key_secret")) {
-    credential_.setAccessKeySecret(
+    credential.setAccessKeySecret(
         result["access_key_secret"].get<std::string>());
   }
   if (result.contains("security_token")) {
-    credential_.setSecurityToken(result["security_token"].get<std::string>());
+    credential.setSecurityToken(result["security_token"].get<std::string>());
   }
 
-  return true;
+  return makeRefreshResult(credential, expiration);
 }
 
 } // namespace Credential
@@ -1,28 +1,74 @@
-#include <fstream>
-
 #include <darabonba/Exception.hpp>
 #include <darabonba/Core.hpp>
 
 #include <alibabacloud/credential/AuthUtil.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
 #include <alibabacloud/credential/provider/OIDCRoleArnProvider.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
-bool OIDCRoleArnProvider::refreshCredential() const {
-  std::ifstream ifs(oidcTokenFilePath_);
-  if (!ifs) {
-    throw Darabonba::Exception("Can't open " + oidcTokenFilePath_);
+
+/**
+ * @brief `value` if the config set it, else `name` from the environment,
+ *        else `defaultValue`
+ */
+static std::string configOrEnvironment(bool has, const std::string &value,
+                                       const EnvironmentSource &environment,
+                                       const std::string &name,
+                                       const std::string &defaultValue = "") {
+  if (has && !value.empty()) {
+    return value;
   }
-  std::string oidcToken((std::istreambuf_iterator<char>(ifs)),
-                        (std::istreambuf_iterator<char>()));
-  ifs.close();
+  const auto fromEnvironment = environment.get(name);
+  return fromEnvironment.empty() ? defaultValue : fromEnvironment;
+}
+
+OIDCRoleArnProvider::OIDCRoleArnProvider(
+    std::shared_ptr<Models::Config> config,
+    std::shared_ptr<const EnvironmentSource> environment)
+    : policy_(config->hasPolicy()
+                  ? std::make_shared<std::string>(config->getPolicy())
+                  : nullptr),
+      durationSeconds_(config->getDurationSeconds()),
+      stsEndpoint_(config->getStsEndpoint()),
+      connectTimeout_(config->hasConnectTimeout() ? config->getConnectTimeout()
+                                                  : 10000),
+      readTimeout_(config->hasTimeout() ? config->getTimeout() : 5000) {
+  if (environment == nullptr) {
+    environment = EnvironmentSource::fromProcess();
+  }
+  roleArn_ = configOrEnvironment(config->hasRoleArn(), config->getRoleArn(),
+                                 *environment, Constant::ENV_ROLE_ARN);
+  oidcProviderArn_ = configOrEnvironment(
+      config->hasOidcProviderArn(), config->getOidcProviderArn(), *environment,
+      Constant::ENV_OIDC_PROVIDER_ARN);
+  oidcTokenFilePath_ = configOrEnvironment(
+      config->hasOidcTokenFilePath(), config->getOidcTokenFilePath(),
+      *environment, Constant::ENV_OIDC_TOKEN_FILE);
+  roleSessionName_ = configOrEnvironment(
+      config->hasRoleSessionName(), config->getRoleSessionName(), *environment,
+      Constant::ENV_ROLE_SESSION_NAME, "defaultSessionName");
+  regionId_ = configOrEnvironment(config->hasStsRegionId(),
+                                  config->getStsRegionId(), *environment,
+                                  Constant::ENV_STS_REGION,
+                                  config->getRegionId());
+  enableVpc_ = config->hasEnableVpc()
+                   ? config->getEnableVpc()
+                   : environment->get(Constant::ENV_VPC_ENDPOINT_ENABLED) ==
+                         "true";
+  tokenFile_.reset(new TokenFile(oidcTokenFilePath_));
+  setHttpTransport(config->getHttpTransport());
+}
+
+RefreshResult OIDCRoleArnProvider::doRefresh() const {
+  const auto oidcToken = tokenFile_->getToken();
 
   // V3 format: business parameters in Query
   Darabonba::Http::Query query = {
       {"DurationSeconds", std::to_string(durationSeconds_)},
       {"RoleArn", roleArn_},
       {"OIDCProviderArn", oidcProviderArn_},
-      {"OIDCToken", oidcToken},
+      {"OIDCToken", *oidcToken},
       {"RoleSessionName", roleSessionName_},
   };
   if (policy_) {
@@ -31,37 +77,38 @@ bool OIDCRoleArnProvider::refreshCredential() const {
 
   // Build request
   std::string url = "https://" + stsEndpoint_ + "/";
-  auto req = AuthUtil::getNewRequest(url);
-  req.setQuery(std::move(query));
-  req.setMethod("POST");
+  auto req = AuthUtil::getNewHttpRequest(url);
+  req.query = std::move(query);
+  req.method = "POST";
 
   // V3 format: common parameters in Header
   std::string utcDate = gmt_datetime();
   std::string nonce = Darabonba::Core::uuid();
 
-  req.getHeaders()["host"] = stsEndpoint_;
-  req.getHeaders()["x-acs-action"] = "AssumeRoleWithOIDC";
-  req.getHeaders()["x-acs-version"] = "2015-04-01";
-  req.getHeaders()["x-acs-date"] = utcDate;
-  req.getHeaders()["x-acs-signature-nonce"] = nonce;
+  req.headers["host"] = stsEndpoint_;
+  req.headers["x-acs-action"] = "AssumeRoleWithOIDC";
+  req.headers["x-acs-version"] = "2015-04-01";
+  req.headers["x-acs-date"] = utcDate;
+  req.headers["x-acs-signature-nonce"] = nonce;
   // OIDC does not require signature, so no need to add Authorization Header
 
   // Use saved timeout configuration
-  Darabonba::RuntimeOptions runtime;
-  runtime.setConnectTimeout(connectTimeout_);
-  runtime.setReadTimeout(readTimeout_);
-  auto future = Darabonba::Core::doAction(req, runtime);
-  auto resp = future.get();
-  if (resp->getStatusCode() != 200) {
-    throw Darabonba::Exception(Darabonba::Stream::readAsString(resp->getBody()));
+  req.connectTimeoutMs = connectTimeout_;
+  req.readTimeoutMs = readTimeout_;
+  const auto resp = getHttpTransport().send(req);
+  if (resp.statusCode != 200) {
+    throw Darabonba::Exception(resp.body);
   }
-  auto result = Darabonba::Stream::readAsJSON(resp->getBody());
-  auto &credential = result["Credentials"];
-  this->expiration_ = strtotime(credential["Expiration"].get<std::string>());
-  credential_.setAccessKeyId(credential["AccessKeyId"].get<std::string>())
-      .setAccessKeySecret(credential["AccessKeySecret"].get<std::string>())
-      .setSecurityToken(credential["SecurityToken"].get<std::string>());
-  return true;
+  auto result = Darabonba::Json::parse(resp.body);
+  auto &credentials = result["Credentials"];
+  Models::CredentialModel credential;
+  credential.setType(Constant::OIDC_ROLE_ARN)
+      .setAccessKeyId(credentials["AccessKeyId"].get<std::string>())
+      .setAccessKeySecret(credentials["AccessKeySecret"].get<std::string>())
+      .setSecurityToken(credentials["SecurityToken"].get<std::string>())
+      .setProviderName(getProviderName());
+  return makeRefreshResult(
+      credential, strtotime(credentials["Expiration"].get<std::string>()));
 }
 
 } // namespace Credential
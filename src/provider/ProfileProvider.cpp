@@ -2,11 +2,12 @@
 
 #include <darabonba/Env.hpp>
 #include <darabonba/Exception.hpp>
-#include <darabonba/Ini.hpp>
 
 #include <alibabacloud/credential/AuthUtil.hpp>
 #include <alibabacloud/credential/Constant.hpp>
 #include <alibabacloud/credential/Model.hpp>
+#include <alibabacloud/credential/ProfileFile.hpp>
+#include <alibabacloud/credential/internal/Clock.hpp>
 #include <alibabacloud/credential/provider/AccessKeyProvider.hpp>
 #include <alibabacloud/credential/provider/EcsRamRoleProvider.hpp>
 #include <alibabacloud/credential/provider/OIDCRoleArnProvider.hpp>
@@ -39,63 +40,136 @@ static std::string getProfilePath() {
 namespace AlibabaCloud {
 namespace Credential {
 
-std::unique_ptr<Provider> ProfileProvider::createProvider() {
-  auto filePath = Darabonba::Env::getEnv("ALIBABA_CLOUD_CREDENTIALS_FILE",
-                                         getProfilePath());
-  if (filePath.empty()) {
-    throw Darabonba::Exception("No credential profile.");
-  }
-  std::ifstream ifs(filePath);
-  if (!ifs.good()) {
-    throw Darabonba::Exception("Can't open credential profile: " + filePath);
-  }
-  auto iniObj = Darabonba::Ini::parse(ifs);
-  // parse ini object into config
+// C++11 requires out-of-class definition for constexpr static members
+constexpr int64_t ProfileProvider::DEFAULT_REVALIDATE_INTERVAL_MS;
+
+std::string ProfileProvider::getFilePath() {
+  return Darabonba::Env::getEnv("ALIBABA_CLOUD_CREDENTIALS_FILE",
+                                getProfilePath());
+}
+
+std::string ProfileProvider::getSectionName() {
   std::string sectionName = AuthUtil::clientType();
   if (sectionName.empty()) {
     sectionName = Darabonba::Env::getEnv("ALIBABA_CLOUD_PROFILE", "default");
   }
+  return sectionName;
+}
+
+const Provider &ProfileProvider::provider() const {
+  const Loaded *loaded = current();
+  if (loaded->provider == nullptr) {
+    throw Darabonba::Exception(loaded->error);
+  }
+  return *loaded->provider;
+}
+
+const ProfileProvider::Loaded *ProfileProvider::current() const {
+  const Loaded *pinned = loaded_.pin();
+  if (pinned != nullptr &&
+      Internal::nowMs() < revalidateAt_.load(std::memory_order_acquire)) {
+    return pinned;
+  }
+  std::lock_guard<std::mutex> lock(loadMutex_);
+  // Double check: another thread may have revalidated meanwhile
+  const std::shared_ptr<const Loaded> loaded = loaded_.load();
+  const int64_t now = Internal::nowMs();
+  if (loaded != nullptr && now < revalidateAt_.load(std::memory_order_acquire)) {
+    return loaded_.pin();
+  }
+
+  const std::string filePath = getFilePath();
+  const std::string sectionName = getSectionName();
+  // Stat before reading: a change during the parse shows up next time
+  const FileStamp stamp = FileStamp::of(filePath);
+  if (loaded == nullptr || loaded->filePath != filePath ||
+      loaded->sectionName != sectionName || loaded->stamp != stamp) {
+    auto next = std::make_shared<Loaded>();
+    next->filePath = filePath;
+    next->sectionName = sectionName;
+    next->stamp = stamp;
+    try {
+      if (filePath.empty()) {
+        next->error = "No credential profile.";
+      } else if (!stamp.exists()) {
+        next->error = "Can't open credential profile: " + filePath;
+      } else {
+        next->provider = createProvider(filePath, sectionName);
+        if (next->provider == nullptr) {
+          next->error = "Can't create the ProfileProvider.";
+        }
+      }
+    } catch (const std::exception &e) {
+      next->error = e.what();
+    }
+
+    if (loaded != nullptr) {
+      bumpEpoch();
+      next->generationBase =
+          nextGenerationBase(loaded->generationBase, loaded->provider.get());
+    }
+    loaded_.store(std::move(next));
+  }
+  revalidateAt_.store(now + revalidateIntervalMs_, std::memory_order_release);
+  return loaded_.pin();
+}
+
+uint64_t ProfileProvider::getGeneration() const {
+  // load(): pinning here would release the caller's last credential
+  const std::shared_ptr<const Loaded> loaded = loaded_.load();
+  if (loaded == nullptr) {
+    return 0;
+  }
+  return loaded->generationBase +
+         (loaded->provider != nullptr ? loaded->provider->getGeneration() : 0);
+}
 
-  const auto &enable = iniObj.get(sectionName, Constant::INI_ENABLE);
-  if (enable != "true") {
+std::unique_ptr<Provider>
+ProfileProvider::createProvider(const std::string &filePath,
+                                const std::string &sectionName) {
+  // Only the requested section is read out of the file
+  ProfileFile file(filePath);
+  ProfileFile::Section section;
+  file.findSection(sectionName, section);
+  const auto *enable = ProfileFile::find(section, Constant::INI_ENABLE);
+  if (enable == nullptr || enable->value != "true") {
     throw Darabonba::Exception("The enable option in " + sectionName +
                                " is not equal to true.");
   }
-  const auto &section = iniObj.get(sectionName);
   auto config = std::make_shared<Models::Config>();
-  if (section.count(Constant::INI_ACCESS_KEY_ID)) {
-    config->setAccessKeyId(section.get(Constant::INI_ACCESS_KEY_ID));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ACCESS_KEY_ID)) {
+    config->setAccessKeyId(field->str());
   }
-  if (section.count(Constant::INI_ACCESS_KEY_SECRET)) {
-    config->setAccessKeySecret(section.get(Constant::INI_ACCESS_KEY_SECRET));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ACCESS_KEY_SECRET)) {
+    config->setAccessKeySecret(field->str());
   }
-  if (section.count(Constant::INI_TYPE)) {
-    config->setType(section.get(Constant::INI_TYPE));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_TYPE)) {
+    config->setType(field->str());
   }
-  if (section.count(Constant::INI_PRIVATE_KEY_FILE)) {
-    config->setPrivateKeyFile(section.get(Constant::INI_PRIVATE_KEY_FILE));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_PRIVATE_KEY_FILE)) {
+    config->setPrivateKeyFile(field->str());
   }
-  if (section.count(Constant::INI_PUBLIC_KEY_ID)) {
-    config->setPublicKeyId(section.get(Constant::INI_PUBLIC_KEY_ID));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_PUBLIC_KEY_ID)) {
+    config->setPublicKeyId(field->str());
   }
-  if (section.count(Constant::INI_ROLE_ARN)) {
-    config->setRoleArn(section.get(Constant::INI_ROLE_ARN));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ROLE_ARN)) {
+    config->setRoleArn(field->str());
   }
-  if (section.count(Constant::INI_ROLE_SESSION_NAME)) {
-    config->setRoleSessionName(section.get(Constant::INI_ROLE_SESSION_NAME));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ROLE_SESSION_NAME)) {
+    config->setRoleSessionName(field->str());
   }
-  if (section.count(Constant::INI_POLICY)) {
-    config->setPolicy(section.get(Constant::INI_POLICY));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_POLICY)) {
+    config->setPolicy(field->str());
   }
-  if (section.count(Constant::INI_ROLE_NAME)) {
-    config->setRoleName(section.get(Constant::INI_ROLE_NAME));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ROLE_NAME)) {
+    config->setRoleName(field->str());
   }
-  if (section.count(Constant::INI_OIDC_PROVIDER_ARN)) {
-    config->setOidcProviderArn(section.get(Constant::INI_OIDC_PROVIDER_ARN));
+  if (const auto *field = ProfileFile::find(section, Constant::INI_OIDC_PROVIDER_ARN)) {
+    config->setOidcProviderArn(field->str());
   }
-  if (section.count(Constant::INI_OIDC_TOKEN_FILE_PATH)) {
+  if (const auto *field = ProfileFile::find(section, Constant::INI_OIDC_TOKEN_FILE_PATH)) {
     config->setOidcTokenFilePath(
-        section.get(Constant::INI_OIDC_TOKEN_FILE_PATH));
+        field->str());
   }
 
   auto configType = config->getType();
@@ -0,0 +1,342 @@
+#include <darabonba/Exception.hpp>
+
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/FileStamp.hpp>
+#include <alibabacloud/credential/ProfileFile.hpp>
+#include <alibabacloud/credential/internal/Clock.hpp>
+#include <alibabacloud/credential/provider/AccessKeyProvider.hpp>
+#include <alibabacloud/credential/provider/EcsRamRoleProvider.hpp>
+#include <alibabacloud/credential/provider/OIDCRoleArnProvider.hpp>
+#include <alibabacloud/credential/provider/ProfileRegistry.hpp>
+#include <alibabacloud/credential/provider/RamRoleArnProvider.hpp>
+#include <alibabacloud/credential/provider/RsaKeyPairProvider.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+// C++11 requires out-of-class definition for constexpr static members
+constexpr int64_t ProfileRegistry::DEFAULT_REVALIDATE_INTERVAL_MS;
+
+struct ProfileRegistry::Profile {
+  std::shared_ptr<const Models::Config> config;  // nullptr if invalid
+  std::string fingerprint;                       // Serialized config
+  std::string error;                             // Why the profile is unusable
+  std::shared_ptr<Provider> provider;            // Built on first use
+};
+
+struct ProfileRegistry::File {
+  bool loaded = false;
+  FileStamp stamp;
+  int64_t revalidateAt = 0;  // Steady clock, ms
+  std::string error;         // Why the file is unusable
+  bool json = false;         // CLI JSON rather than INI
+  std::unique_ptr<ProfileFile> content;  // Backs the fields of `sections`
+  ProfileFile::Index sections;           // Every profile of the file
+  std::string indexError;  // Why indexing stopped early, empty if it didn't
+  std::unordered_map<std::string, Profile> profiles;  // Looked up so far
+};
+
+/**
+ * @brief Whether a CLI profile file is JSON, by extension or first character
+ *
+ * Only '{' counts: an INI file starts with '[' as well.
+ */
+static bool isJsonFile(const std::string &filePath, const ProfileFile &content) {
+  if (filePath.size() >= 5 && filePath.substr(filePath.size() - 5) == ".json") {
+    return true;
+  }
+  return content.isJson();
+}
+
+static std::shared_ptr<Models::Config>
+configFromJson(const ProfileFile::Section &profile) {
+  auto config = std::make_shared<Models::Config>();
+
+  if (const auto *field = ProfileFile::find(profile, "mode")) {
+    config->setType(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "access_key_id")) {
+    config->setAccessKeyId(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "access_key_secret")) {
+    config->setAccessKeySecret(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "sts_token")) {
+    config->setSecurityToken(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "ram_role_name")) {
+    config->setRoleName(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "ram_role_arn")) {
+    config->setRoleArn(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "role_session_name")) {
+    config->setRoleSessionName(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "public_key_id")) {
+    config->setPublicKeyId(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "private_key_file")) {
+    config->setPrivateKeyFile(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "oidc_provider_arn")) {
+    config->setOidcProviderArn(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "oidc_token_file")) {
+    config->setOidcTokenFilePath(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(profile, "region_id")) {
+    config->setRegionId(field->str());
+  }
+
+  return config;
+}
+
+static std::shared_ptr<Models::Config>
+configFromIni(const ProfileFile::Section &section,
+              const std::string &profileName) {
+  const auto *enable = ProfileFile::find(section, Constant::INI_ENABLE);
+  if (enable == nullptr || enable->value != "true") {
+    throw Darabonba::Exception("The enable option in '" + profileName +
+                               "' is not equal to true.");
+  }
+
+  auto config = std::make_shared<Models::Config>();
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_TYPE)) {
+    config->setType(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ACCESS_KEY_ID)) {
+    config->setAccessKeyId(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ACCESS_KEY_SECRET)) {
+    config->setAccessKeySecret(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ROLE_NAME)) {
+    config->setRoleName(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ROLE_ARN)) {
+    config->setRoleArn(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_ROLE_SESSION_NAME)) {
+    config->setRoleSessionName(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_PUBLIC_KEY_ID)) {
+    config->setPublicKeyId(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_PRIVATE_KEY_FILE)) {
+    config->setPrivateKeyFile(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_OIDC_PROVIDER_ARN)) {
+    config->setOidcProviderArn(field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_OIDC_TOKEN_FILE_PATH)) {
+    config->setOidcTokenFilePath(
+        field->str());
+  }
+
+  if (const auto *field = ProfileFile::find(section, Constant::INI_POLICY)) {
+    config->setPolicy(field->str());
+  }
+
+  return config;
+}
+
+/**
+ * @brief Build the provider configured by a profile
+ */
+static std::shared_ptr<Provider> makeProvider(const Models::Config &settings) {
+  auto config = std::make_shared<Models::Config>(settings);
+  auto configType = config->getType();
+  if (configType.empty()) {
+    throw Darabonba::Exception("The configured client type is empty");
+  }
+
+  if (configType == Constant::ECS_RAM_ROLE) {
+    return std::make_shared<EcsRamRoleProvider>(config);
+  } else if (configType == Constant::RSA_KEY_PAIR) {
+    return std::make_shared<RsaKeyPairProvider>(config);
+  } else if (configType == Constant::RAM_ROLE_ARN) {
+    return std::make_shared<RamRoleArnProvider>(config);
+  } else if (configType == Constant::OIDC_ROLE_ARN) {
+    return std::make_shared<OIDCRoleArnProvider>(config);
+  }
+
+  // 默认使用 AccessKey
+  const auto &accessKeyId = config->getAccessKeyId();
+  const auto &accessKeySecret = config->getAccessKeySecret();
+  if (accessKeyId.empty() || accessKeySecret.empty()) {
+    throw Darabonba::Exception("AccessKeyId and AccessKeySecret are required");
+  }
+
+  return std::make_shared<AccessKeyProvider>(config);
+}
+
+std::shared_ptr<ProfileRegistry> ProfileRegistry::getDefault() {
+  static std::shared_ptr<ProfileRegistry> instance =
+      std::make_shared<ProfileRegistry>();
+  return instance;
+}
+
+ProfileRegistry::ProfileRegistry(int64_t revalidateIntervalMs)
+    : revalidateIntervalMs_(revalidateIntervalMs) {}
+
+ProfileRegistry::~ProfileRegistry() = default;
+
+void ProfileRegistry::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  files_.clear();
+}
+
+std::shared_ptr<Provider>
+ProfileRegistry::getProvider(const std::string &filePath,
+                             const std::string &profileName) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Profile &profile = lookup(filePath, profileName);
+  if (profile.provider == nullptr) {
+    try {
+      profile.provider = makeProvider(*profile.config);
+    } catch (const std::exception &e) {
+      profile.error = e.what();
+      throw Darabonba::Exception(profile.error);
+    }
+  }
+  return profile.provider;
+}
+
+std::shared_ptr<const Models::Config>
+ProfileRegistry::getConfig(const std::string &filePath,
+                           const std::string &profileName) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lookup(filePath, profileName).config;
+}
+
+ProfileRegistry::Profile &
+ProfileRegistry::lookup(const std::string &filePath,
+                        const std::string &profileName) {
+  if (filePath.empty()) {
+    throw Darabonba::Exception("No CLI profile file found.");
+  }
+  auto &entry = files_[filePath];
+  if (entry == nullptr) {
+    entry.reset(new File());
+  }
+  File &file = *entry;
+
+  const int64_t now = Internal::nowMs();
+  if (now >= file.revalidateAt) {
+    // Stat before reading: a change during the parse shows up next time
+    const FileStamp stamp = FileStamp::of(filePath);
+    if (!file.loaded || stamp != file.stamp) {
+      file.stamp = stamp;
+      reload(file, filePath);
+    }
+    file.revalidateAt = now + revalidateIntervalMs_;
+  }
+  if (!file.error.empty()) {
+    throw Darabonba::Exception(file.error);
+  }
+
+  auto it = file.profiles.find(profileName);
+  if (it == file.profiles.end()) {
+    it = file.profiles.emplace(profileName, loadProfile(file, profileName))
+             .first;
+  }
+  if (!it->second.error.empty()) {
+    throw Darabonba::Exception(it->second.error);
+  }
+  return it->second;
+}
+
+ProfileRegistry::Profile
+ProfileRegistry::loadProfile(const File &file, const std::string &profileName) {
+  Profile profile;
+  try {
+    // Only the fields of the requested profile are copied out of the index
+    const auto it = file.sections.find(profileName);
+    std::shared_ptr<Models::Config> config;
+    if (file.json) {
+      if (it == file.sections.end()) {
+        // A profile after a syntax error was never indexed
+        throw Darabonba::Exception(
+            !file.indexError.empty()
+                ? file.indexError
+                : "Profile '" + profileName + "' not found in CLI config");
+      }
+      config = configFromJson(it->second);
+    } else {
+      config = configFromIni(it != file.sections.end() ? it->second
+                                                       : ProfileFile::Section(),
+                             profileName);
+    }
+    profile.fingerprint = config->toMap().dump();
+    profile.config = config;
+  } catch (const std::exception &e) {
+    profile.error = e.what();
+  }
+  return profile;
+}
+
+void ProfileRegistry::reload(File &file, const std::string &filePath) {
+  file.loaded = true;
+  file.error.clear();
+  file.indexError.clear();
+  file.sections.clear();
+  file.content.reset();
+  if (file.stamp.exists()) {
+    try {
+      file.content.reset(new ProfileFile(filePath));
+    } catch (const std::exception &) {
+    }
+  }
+  if (file.content == nullptr) {
+    file.error = "Can't open CLI profile file: " + filePath;
+    file.profiles.clear();
+    return;
+  }
+  file.json = isJsonFile(filePath, *file.content);
+
+  // One pass over the file, however many profiles are looked up in it
+  try {
+    if (file.json) {
+      file.content->indexJsonProfiles(file.sections);
+    } else {
+      file.content->indexSections(file.sections);
+    }
+  } catch (const std::exception &e) {
+    file.indexError = e.what();
+  }
+
+  // Profiles whose settings did not change keep their provider
+  for (auto &entry : file.profiles) {
+    Profile next = loadProfile(file, entry.first);
+    if (next.error.empty() && entry.second.error.empty() &&
+        next.fingerprint == entry.second.fingerprint) {
+      continue;
+    }
+    entry.second = std::move(next);
+  }
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
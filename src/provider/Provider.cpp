@@ -0,0 +1,9 @@
+#include <alibabacloud/credential/provider/Provider.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+std::atomic<uint64_t> Provider::epoch_(0);
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <vector>
+
+#include <alibabacloud/credential/provider/PublishedValue.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+// C++11 requires out-of-class definition for constexpr static members
+constexpr size_t PinnedValues::SWEEP_THRESHOLD;
+
+namespace {
+
+struct SlotTable {
+  std::vector<PinnedValues::Slot> slots;
+  size_t lastIndex = 0;  // Most recently used slot
+  size_t sweepAt = PinnedValues::SWEEP_THRESHOLD;
+};
+
+std::atomic<uint64_t> nextOwnerId(1);
+
+} // namespace
+
+uint64_t PinnedValues::nextOwner() { return nextOwnerId.fetch_add(1); }
+
+PinnedValues::Slot &
+PinnedValues::slot(uint64_t owner, const std::shared_ptr<const void> &alive) {
+  static thread_local SlotTable table;
+  std::vector<Slot> &slots = table.slots;
+  if (table.lastIndex < slots.size() && slots[table.lastIndex].owner == owner) {
+    return slots[table.lastIndex];
+  }
+  for (size_t i = 0; i < slots.size(); ++i) {
+    if (slots[i].owner == owner) {
+      table.lastIndex = i;
+      return slots[i];
+    }
+  }
+
+  if (slots.size() >= table.sweepAt) {
+    // Values of destroyed owners can no longer be referenced through them;
+    // destroy them once the table is consistent again, since their
+    // destructors may pin other values
+    std::vector<std::shared_ptr<const void>> released;
+    size_t kept = 0;
+    for (size_t i = 0; i < slots.size(); ++i) {
+      if (slots[i].alive.expired()) {
+        released.push_back(std::move(slots[i].value));
+      } else {
+        if (kept != i) {
+          slots[kept] = std::move(slots[i]);
+        }
+        ++kept;
+      }
+    }
+    slots.erase(slots.begin() + kept, slots.end());
+    table.sweepAt = std::max(SWEEP_THRESHOLD, slots.size() * 2);
+    released.clear();
+  }
+
+  slots.emplace_back();
+  table.lastIndex = slots.size() - 1;
+  Slot &added = slots.back();
+  added.owner = owner;
+  added.alive = alive;
+  return added;
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -7,12 +7,13 @@
 #include <darabonba/signature/Signer.hpp>
 
 #include <alibabacloud/credential/AuthUtil.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
 #include <alibabacloud/credential/provider/RamRoleArnProvider.hpp>
 
 namespace AlibabaCloud {
 namespace Credential {
 
-bool RamRoleArnProvider::refreshCredential() const {
+RefreshResult RamRoleArnProvider::doRefresh() const {
   Darabonba::Http::Query query = {
       {"DurationSeconds", std::to_string(durationSeconds_)},
       {"RoleArn", roleArn_},
@@ -24,25 +25,25 @@ bool RamRoleArnProvider::refreshCredential() const {
 
   // Build request
   std::string url = "https://" + stsEndpoint_ + "/";
-  auto req = AuthUtil::getNewRequest(url);
-  req.setQuery(std::move(query));
-  req.setMethod("POST");
+  auto req = AuthUtil::getNewHttpRequest(url);
+  req.query = std::move(query);
+  req.method = "POST";
 
   // V3 signature: common parameters in Header
   std::string utcDate = gmt_datetime();
   std::string nonce = Darabonba::Core::uuid();
 
-  req.getHeaders()["host"] = stsEndpoint_;
-  req.getHeaders()["x-acs-action"] = "AssumeRole";
-  req.getHeaders()["x-acs-version"] = "2015-04-01";
-  req.getHeaders()["x-acs-date"] = utcDate;
-  req.getHeaders()["x-acs-signature-nonce"] = nonce;
-  req.getHeaders()["x-acs-content-sha256"] =
+  req.headers["host"] = stsEndpoint_;
+  req.headers["x-acs-action"] = "AssumeRole";
+  req.headers["x-acs-version"] = "2015-04-01";
+  req.headers["x-acs-date"] = utcDate;
+  req.headers["x-acs-signature-nonce"] = nonce;
+  req.headers["x-acs-content-sha256"] =
       "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b9"
       "34ca495991b7852b855"; // SHA256 of empty body
 
   // Build canonical request string
-  std::string canonicalQueryString = std::string(req.getQuery());
+  std::string canonicalQueryString = std::string(req.query);
   std::string canonicalHeaders =
       "host:" + stsEndpoint_ + "\n" + "x-acs-action:AssumeRole\n" +
       "x-acs-content-sha256:"
@@ -71,34 +72,35 @@ bool RamRoleArnProvider::refreshCredential() const {
   // Calculate signature
   std::string signature = Darabonba::Encode::Encoder::hexEncode(
       Darabonba::Signature::Signer::HmacSHA256Sign(
-          stringToSign, credential_.getAccessKeySecret()));
+          stringToSign, accessKeySecret_));
 
   // Build Authorization Header
   std::string authorization =
-      "ACS3-HMAC-SHA256 Credential=" + credential_.getAccessKeyId() +
+      "ACS3-HMAC-SHA256 Credential=" + accessKeyId_ +
       ",SignedHeaders=" + signedHeaders + ",Signature=" + signature;
-  req.getHeaders()["Authorization"] = authorization;
+  req.headers["Authorization"] = authorization;
 
   // Use saved timeout configuration
-  Darabonba::RuntimeOptions runtime;
-  runtime.setConnectTimeout(connectTimeout_);
-  runtime.setReadTimeout(readTimeout_);
-  auto future = Darabonba::Core::doAction(req, runtime);
-  auto resp = future.get();
-  if (resp->getStatusCode() != 200) {
-    throw Darabonba::Exception(Darabonba::Stream::readAsString(resp->getBody()));
+  req.connectTimeoutMs = connectTimeout_;
+  req.readTimeoutMs = readTimeout_;
+  const auto resp = getHttpTransport().send(req);
+  if (resp.statusCode != 200) {
+    throw Darabonba::Exception(resp.body);
   }
 
-  auto result = Darabonba::Stream::readAsJSON(resp->getBody());
+  auto result = Darabonba::Json::parse(resp.body);
   if (result["Code"].get<std::string>() != "Success") {
     throw Darabonba::Exception(result.dump());
   }
-  auto &credential = result["Credentials"];
-  this->expiration_ = strtotime(credential["Expiration"].get<std::string>());
-  credential_.setAccessKeyId(credential["AccessKeyId"].get<std::string>())
-      .setAccessKeySecret(credential["AccessKeySecret"].get<std::string>())
-      .setSecurityToken(credential["SecurityToken"].get<std::string>());
-  return true;
+  auto &credentials = result["Credentials"];
+  Models::CredentialModel credential;
+  credential.setType(Constant::RAM_ROLE_ARN)
+      .setAccessKeyId(credentials["AccessKeyId"].get<std::string>())
+      .setAccessKeySecret(credentials["AccessKeySecret"].get<std::string>())
+      .setSecurityToken(credentials["SecurityToken"].get<std::string>())
+      .setProviderName(getProviderName());
+  return makeRefreshResult(
+      credential, strtotime(credentials["Expiration"].get<std::string>()));
 }
 
 } // namespace Credential
@@ -0,0 +1,186 @@
+#include <cstdlib>
+#include <exception>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <darabonba/Env.hpp>
+
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/provider/RefreshExecutor.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+RefreshExecutor &RefreshExecutor::getInstance() {
+  static RefreshExecutor instance(defaultOptions());
+  return instance;
+}
+
+void RefreshExecutor::configure(const Options &options) {
+  auto &instance = getInstance();
+  std::lock_guard<std::mutex> guard(instance.configureMutex_);
+  instance.stop();
+  instance.start(options);
+}
+
+RefreshExecutor::Options RefreshExecutor::defaultOptions() {
+  Options options;
+  auto threads = Darabonba::Env::getEnv(Constant::ENV_REFRESH_THREADS);
+  if (!threads.empty()) {
+    long count = std::strtol(threads.c_str(), nullptr, 10);
+    if (count > 0) {
+      options.threadCount = static_cast<size_t>(count);
+    }
+  }
+  std::istringstream cpus(Darabonba::Env::getEnv(Constant::ENV_REFRESH_CPUS));
+  std::string cpu;
+  while (std::getline(cpus, cpu, ',')) {
+    if (!cpu.empty()) {
+      options.cpuAffinity.push_back(std::atoi(cpu.c_str()));
+    }
+  }
+  return options;
+}
+
+RefreshExecutor::RefreshExecutor(const Options &options) { start(options); }
+
+RefreshExecutor::~RefreshExecutor() { stop(); }
+
+void RefreshExecutor::start(const Options &options) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  options_ = options;
+  if (options_.threadCount == 0) {
+    options_.threadCount = 1;
+  }
+  stopping_ = false;
+  for (size_t i = 0; i < options_.threadCount; ++i) {
+    workers_.emplace_back(&RefreshExecutor::workerLoop, this);
+  }
+}
+
+void RefreshExecutor::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queueCond_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  workers_.clear();
+}
+
+bool RefreshExecutor::submit(const void *owner, std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (owner != nullptr) {
+      if (queuedOwners_.count(owner)) {
+        return false;
+      }
+      queuedOwners_.insert(owner);
+    }
+    queue_.emplace_back(owner, std::move(task));
+  }
+  queueCond_.notify_one();
+  return true;
+}
+
+void RefreshExecutor::cancel(const void *owner) {
+  if (owner == nullptr) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (queuedOwners_.erase(owner)) {
+    for (auto it = queue_.begin(); it != queue_.end();) {
+      if (it->first == owner) {
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  // A task cancelling its own owner cannot wait for itself
+  idleCond_.wait(lock, [this, owner]() {
+    auto it = runningOwners_.find(owner);
+    return it == runningOwners_.end() ||
+           it->second == std::this_thread::get_id();
+  });
+}
+
+size_t RefreshExecutor::pendingCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size();
+}
+
+size_t RefreshExecutor::threadCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return workers_.size();
+}
+
+void RefreshExecutor::workerLoop() {
+  applyThreadSettings();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queueCond_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+    if (stopping_) {
+      return;
+    }
+    auto item = std::move(queue_.front());
+    queue_.pop_front();
+    const void *owner = item.first;
+    if (owner != nullptr) {
+      queuedOwners_.erase(owner);
+      runningOwners_[owner] = std::this_thread::get_id();
+    }
+    lock.unlock();
+
+    try {
+      item.second();
+    } catch (...) {
+      // A failed refresh is retried by its provider; report it only if asked
+      if (options_.onTaskError) {
+        try {
+          options_.onTaskError(std::current_exception());
+        } catch (...) {
+        }
+      }
+    }
+
+    lock.lock();
+    if (owner != nullptr) {
+      runningOwners_.erase(owner);
+      idleCond_.notify_all();
+    }
+  }
+}
+
+void RefreshExecutor::applyThreadSettings() const {
+#ifdef __linux__
+  if (options_.lowPriority) {
+    // Per-thread nice value on Linux
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+  }
+  if (!options_.cpuAffinity.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : options_.cpuAffinity) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+      }
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  }
+#endif
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <darabonba/Env.hpp>
+
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/provider/RefreshPolicy.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+namespace {
+
+uint64_t fnv1a(const std::string &data, uint64_t hash) {
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Seed from the host name and process id: stable within a process,
+// different across the processes of a fleet
+uint64_t processSeed() {
+  std::string host;
+#ifdef _WIN32
+  host = Darabonba::Env::getEnv("COMPUTERNAME");
+  long pid = static_cast<long>(_getpid());
+#else
+  char buf[256] = {0};
+  if (gethostname(buf, sizeof(buf) - 1) == 0) {
+    host = buf;
+  }
+  long pid = static_cast<long>(getpid());
+#endif
+  return fnv1a(host + "#" + std::to_string(pid), 14695981039346656037ULL);
+}
+
+// Map a seed to [-1, 1] (splitmix64 finalizer)
+double seedToJitter(uint64_t seed) {
+  seed += 0x9E3779B97F4A7C15ULL;
+  seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+  seed ^= seed >> 31;
+  return static_cast<double>(seed >> 11) / static_cast<double>(1ULL << 53) * 2.0 - 1.0;
+}
+
+double envDouble(const std::string &name, double fallback) {
+  auto value = Darabonba::Env::getEnv(name);
+  if (value.empty()) {
+    return fallback;
+  }
+  char *end = nullptr;
+  double parsed = std::strtod(value.c_str(), &end);
+  return end != value.c_str() ? parsed : fallback;
+}
+
+int64_t envSeconds(const std::string &name, int64_t fallback) {
+  auto value = Darabonba::Env::getEnv(name);
+  if (value.empty()) {
+    return fallback;
+  }
+  char *end = nullptr;
+  long long parsed = std::strtoll(value.c_str(), &end, 10);
+  return end != value.c_str() && parsed >= 0 ? parsed : fallback;
+}
+
+} // namespace
+
+std::shared_ptr<const RefreshPolicy> RefreshPolicy::getDefault() {
+  static std::shared_ptr<const RefreshPolicy> instance =
+      std::make_shared<const RefreshPolicy>(defaultOptions());
+  return instance;
+}
+
+RefreshPolicy::Options RefreshPolicy::defaultOptions() {
+  Options options;
+  options.prefetchFraction =
+      envDouble(Constant::ENV_REFRESH_PREFETCH_FRACTION, options.prefetchFraction);
+  options.jitterFraction =
+      envDouble(Constant::ENV_REFRESH_JITTER_FRACTION, options.jitterFraction);
+  options.minRefreshIntervalSeconds = envSeconds(
+      Constant::ENV_REFRESH_MIN_INTERVAL, options.minRefreshIntervalSeconds);
+  options.maxRefreshIntervalSeconds = envSeconds(
+      Constant::ENV_REFRESH_MAX_INTERVAL, options.maxRefreshIntervalSeconds);
+  return options;
+}
+
+RefreshPolicy::RefreshPolicy(const Options &options) : options_(options) {
+  options_.prefetchFraction =
+      std::min(1.0, std::max(0.0, options_.prefetchFraction));
+  options_.jitterFraction = std::min(1.0, std::max(0.0, options_.jitterFraction));
+  if (options_.maxRefreshIntervalSeconds > 0 &&
+      options_.maxRefreshIntervalSeconds < options_.minRefreshIntervalSeconds) {
+    options_.maxRefreshIntervalSeconds = options_.minRefreshIntervalSeconds;
+  }
+  jitter_ = seedToJitter(options_.jitterSeed != 0 ? options_.jitterSeed
+                                                  : processSeed());
+}
+
+int64_t RefreshPolicy::getPrefetchTime(int64_t now, int64_t expiration) const {
+  const int64_t staleTime = getStaleTime(expiration);
+  double delay = static_cast<double>(expiration - now) * options_.prefetchFraction;
+  delay = std::max(delay, static_cast<double>(options_.minRefreshIntervalSeconds));
+  if (options_.maxRefreshIntervalSeconds > 0) {
+    delay = std::min(delay,
+                     static_cast<double>(options_.maxRefreshIntervalSeconds));
+  }
+  // Never later than the stale time
+  delay = std::min(delay, static_cast<double>(staleTime - now));
+  // Jitter after clamping, otherwise every process would land on exactly
+  // the bound. Only ever earlier, so delays capped at the stale time
+  // still differ per process
+  delay *= 1.0 - options_.jitterFraction * (jitter_ + 1.0) / 2.0;
+  return std::max(now, now + static_cast<int64_t>(delay));
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
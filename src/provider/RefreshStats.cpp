@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <alibabacloud/credential/provider/RefreshStats.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+// C++11 requires out-of-class definition for constexpr static members
+constexpr size_t RefreshStats::LATENCY_SAMPLES;
+constexpr double RefreshStats::FAILURE_RATE_ALPHA;
+constexpr int64_t RefreshStats::MIN_PREFETCH_LEAD_SECONDS;
+constexpr int64_t RefreshStats::MAX_PREFETCH_LEAD_SECONDS;
+constexpr int RefreshStats::MAX_EXPECTED_ATTEMPTS;
+
+void RefreshStats::record(std::chrono::milliseconds latency, bool failed) {
+  samples_[next_] = std::max<int64_t>(0, latency.count());
+  next_ = (next_ + 1) % LATENCY_SAMPLES;
+  const size_t count =
+      std::min(sampleCount_.load(std::memory_order_relaxed) + 1, LATENCY_SAMPLES);
+  sampleCount_.store(count, std::memory_order_relaxed);
+
+  // Refreshes are rare, sorting a copy of at most LATENCY_SAMPLES is cheap
+  std::vector<int64_t> sorted(samples_, samples_ + count);
+  const size_t rank = (count * 99 + 99) / 100 - 1;  // ceil(0.99 * count) - 1
+  std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+  p99LatencyMillis_.store(sorted[rank], std::memory_order_relaxed);
+
+  const double rate = failureRate_.load(std::memory_order_relaxed);
+  failureRate_.store(rate + FAILURE_RATE_ALPHA * ((failed ? 1.0 : 0.0) - rate),
+                     std::memory_order_relaxed);
+}
+
+int64_t RefreshStats::getPrefetchLeadSeconds() const {
+  const double rate = getFailureRate();
+  int attempts = MAX_EXPECTED_ATTEMPTS;
+  if (rate < 0.01) {
+    attempts = 1;
+  } else if (rate < 0.99) {
+    // Smallest n with rate^n <= 1%
+    attempts = std::min(
+        MAX_EXPECTED_ATTEMPTS,
+        static_cast<int>(std::ceil(std::log(0.01) / std::log(rate))));
+  }
+  const double lead =
+      2.0 * attempts * static_cast<double>(getP99LatencyMillis()) / 1000.0;
+  return std::min(MAX_PREFETCH_LEAD_SECONDS,
+                  std::max(MIN_PREFETCH_LEAD_SECONDS,
+                           static_cast<int64_t>(std::ceil(lead))));
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -8,6 +8,7 @@ namespace Credential {
 constexpr int64_t RefreshableProvider::STALE_TIME_WINDOW;
 constexpr int64_t RefreshableProvider::PREFETCH_THRESHOLD;
 constexpr int64_t RefreshableProvider::REFRESH_BLOCKING_MAX_WAIT_MS;
+constexpr int64_t RefreshableProvider::SHARED_CACHE_POLL_MS;
 
 } // namespace Credential
 } // namespace AlibabaCloud
@@ -1,4 +1,5 @@
 #include <alibabacloud/credential/AuthUtil.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
 #include <alibabacloud/credential/provider/RsaKeyPairProvider.hpp>
 #include <darabonba/Core.hpp>
 #include <darabonba/encode/Encoder.hpp>
@@ -8,13 +9,13 @@
 namespace AlibabaCloud {
 namespace Credential {
 
-bool RsaKeyPairProvider::refreshCredential() const {
+RefreshResult RsaKeyPairProvider::doRefresh() const {
   Darabonba::Http::Query query = {
       {"Action", "GenerateSessionAccessKey"},
       {"Format", "JSON"},
       {"Version", "2015-04-01"},
       {"DurationSeconds", std::to_string(durationSeconds_)},
-      {"AccessKeyId", credential_.getAccessKeyId()},
+      {"AccessKeyId", accessKeyId_},
       {"RegionId", regionId_},
       {"SignatureMethod", "HMAC-SHA1"},
       {"SignatureVersion", "1.0"},
@@ -26,32 +27,32 @@ bool RsaKeyPairProvider::refreshCredential() const {
   std::string stringToSign = "GET&%2F&" + std::string(query);
   std::string signature = Darabonba::Encode::Encoder::toString(
       Darabonba::Signature::Signer::HmacSHA1Sign(
-          stringToSign, credential_.getAccessKeySecret()));
+          stringToSign, accessKeySecret_));
   query.emplace("Signature", signature);
 
   // 使用 getNewRequest 创建带 User-Agent 的请求（对应 Python SDK 的
   // getNewRequest）
   const std::string url = "https://" + stsEndpoint_ + "/";
-  auto req = AuthUtil::getNewRequest(url);
-  req.setQuery(std::move(query));
+  auto req = AuthUtil::getNewHttpRequest(url);
+  req.query = std::move(query);
 
-  auto future = Darabonba::Core::doAction(req);
-  auto resp = future.get();
-  if (resp->getStatusCode() != 200) {
-    throw Darabonba::Exception(Darabonba::Stream::readAsString(resp->getBody()));
+  const auto resp = getHttpTransport().send(req);
+  if (resp.statusCode != 200) {
+    throw Darabonba::Exception(resp.body);
   }
-  auto result = Darabonba::Stream::readAsJSON(resp->getBody());
+  auto result = Darabonba::Json::parse(resp.body);
   if (result["Code"].get<std::string>() != "Success") {
     throw Darabonba::Exception(result.dump());
   }
   auto &sessionAccessKey = result["SessionAccessKey"];
-  this->expiration_ =
-      strtotime(sessionAccessKey["Expiration"].get<std::string>());
-  credential_
+  Models::CredentialModel credential;
+  credential.setType(Constant::RSA_KEY_PAIR)
       .setAccessKeyId(sessionAccessKey["SessionAccessKeyId"].get<std::string>())
       .setAccessKeySecret(
-          sessionAccessKey["SessionAccessKeySecret"].get<std::string>());
-  return true;
+          sessionAccessKey["SessionAccessKeySecret"].get<std::string>())
+      .setProviderName(getProviderName());
+  return makeRefreshResult(
+      credential, strtotime(sessionAccessKey["Expiration"].get<std::string>()));
 }
 
 } // namespace Credential
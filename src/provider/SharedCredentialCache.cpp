@@ -0,0 +1,253 @@
+#include <atomic>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <darabonba/Env.hpp>
+
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/provider/SharedCredentialCache.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+// C++11 requires out-of-class definition for constexpr static members
+constexpr int64_t SharedCredentialCache::LEASE_SECONDS;
+constexpr size_t SharedCredentialCache::MAX_CREDENTIAL_SIZE;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "shared memory records need lock-free 64-bit atomics");
+
+namespace {
+
+const uint32_t RECORD_MAGIC = 0x41435231;  // "ACR1"
+const int FIELD_COUNT = 6;
+const int MAX_READ_ATTEMPTS = 64;
+
+} // namespace
+
+/**
+ * @brief Layout of the shared segment
+ *
+ * Zero-filled on creation, which reads as an empty record with a free lease.
+ */
+struct SharedCredentialCache::Record {
+  std::atomic<uint64_t> sequence;        // Even: stable, odd: being written
+  std::atomic<uint64_t> lease;           // Expiry seconds << 32 | owner id
+  std::atomic<int64_t> writeStartedAt;   // Lets a stuck write be overwritten
+  uint32_t magic;
+  uint32_t lengths[FIELD_COUNT];
+  int64_t staleTime;
+  int64_t prefetchTime;
+  char data[MAX_CREDENTIAL_SIZE];
+};
+
+bool SharedCredentialCache::enabledByDefault() {
+  return Darabonba::Env::getEnv(Constant::ENV_CREDENTIALS_SHARED_MEMORY) == "true";
+}
+
+#ifndef _WIN32
+
+static std::string segmentName(const std::string &key) {
+  // Some systems limit shared memory names to 31 characters
+  return "/acred-" + CredentialFileCache::hashKey(key).substr(0, 24);
+}
+
+std::shared_ptr<SharedCredentialCache>
+SharedCredentialCache::open(const std::string &key) {
+  const std::string name = segmentName(key);
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_uid != geteuid() ||
+      (st.st_mode & 077) != 0) {
+    ::close(fd);
+    return nullptr;
+  }
+  // Concurrent creators truncate to the same size; the new bytes are zero
+  if (static_cast<size_t>(st.st_size) < sizeof(Record) &&
+      ftruncate(fd, sizeof(Record)) != 0) {
+    ::close(fd);
+    return nullptr;
+  }
+  void *mapping =
+      mmap(nullptr, sizeof(Record), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+
+  std::random_device random;
+  uint32_t ownerId = 0;
+  while (ownerId == 0) {
+    ownerId = static_cast<uint32_t>(random());
+  }
+  return std::shared_ptr<SharedCredentialCache>(
+      new SharedCredentialCache(static_cast<Record *>(mapping), ownerId));
+}
+
+void SharedCredentialCache::unlink(const std::string &key) {
+  shm_unlink(segmentName(key).c_str());
+}
+
+SharedCredentialCache::~SharedCredentialCache() {
+  releaseLease();
+  munmap(record_, sizeof(Record));
+}
+
+#else
+
+std::shared_ptr<SharedCredentialCache>
+SharedCredentialCache::open(const std::string &) {
+  return nullptr;
+}
+
+void SharedCredentialCache::unlink(const std::string &) {}
+
+SharedCredentialCache::~SharedCredentialCache() {}
+
+#endif
+
+SharedCredentialCache::SharedCredentialCache(Record *record, uint32_t ownerId)
+    : record_(record), ownerId_(ownerId) {}
+
+bool SharedCredentialCache::read(CredentialFileCache::Entry &entry) const {
+  uint32_t lengths[FIELD_COUNT];
+  char data[MAX_CREDENTIAL_SIZE];
+  int64_t staleTime = 0;
+  int64_t prefetchTime = 0;
+
+  for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+    const uint64_t before = record_->sequence.load(std::memory_order_acquire);
+    if (before == 0) {
+      return false;  // Never written
+    }
+    if (before & 1) {
+      std::this_thread::yield();
+      continue;
+    }
+    const bool valid = record_->magic == RECORD_MAGIC;
+    std::memcpy(lengths, record_->lengths, sizeof(lengths));
+    staleTime = record_->staleTime;
+    prefetchTime = record_->prefetchTime;
+    std::memcpy(data, record_->data, sizeof(data));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (record_->sequence.load(std::memory_order_relaxed) != before) {
+      continue;  // Overlapped a write, the copy may be torn
+    }
+    if (!valid) {
+      return false;
+    }
+
+    std::string fields[FIELD_COUNT];
+    size_t offset = 0;
+    for (int i = 0; i < FIELD_COUNT; ++i) {
+      if (lengths[i] > MAX_CREDENTIAL_SIZE - offset) {
+        return false;
+      }
+      fields[i].assign(data + offset, lengths[i]);
+      offset += lengths[i];
+    }
+    CredentialFileCache::Entry loaded;
+    if (!fields[0].empty()) loaded.credential.setAccessKeyId(fields[0]);
+    if (!fields[1].empty()) loaded.credential.setAccessKeySecret(fields[1]);
+    if (!fields[2].empty()) loaded.credential.setSecurityToken(fields[2]);
+    if (!fields[3].empty()) loaded.credential.setBearerToken(fields[3]);
+    if (!fields[4].empty()) loaded.credential.setType(fields[4]);
+    if (!fields[5].empty()) loaded.credential.setProviderName(fields[5]);
+    loaded.staleTime = staleTime;
+    loaded.prefetchTime = prefetchTime;
+    entry = std::move(loaded);
+    return true;
+  }
+  return false;
+}
+
+bool SharedCredentialCache::write(const CredentialFileCache::Entry &entry) {
+  const std::string fields[FIELD_COUNT] = {
+      entry.credential.getAccessKeyId(),  entry.credential.getAccessKeySecret(),
+      entry.credential.getSecurityToken(), entry.credential.getBearerToken(),
+      entry.credential.getType(),          entry.credential.getProviderName(),
+  };
+  size_t total = 0;
+  for (const auto &field : fields) {
+    total += field.size();
+  }
+  if (total > MAX_CREDENTIAL_SIZE) {
+    return false;
+  }
+
+  const int64_t now = static_cast<int64_t>(time(nullptr));
+  uint64_t sequence = record_->sequence.load(std::memory_order_relaxed);
+  uint64_t writing = sequence + 1;
+  if (sequence & 1) {
+    // Only overwrite a write whose process died in the middle of it
+    if (record_->writeStartedAt.load(std::memory_order_relaxed) + LEASE_SECONDS > now) {
+      return false;
+    }
+    writing = sequence + 2;
+  }
+  if (!record_->sequence.compare_exchange_strong(sequence, writing,
+                                                 std::memory_order_acq_rel)) {
+    return false;
+  }
+  record_->writeStartedAt.store(now, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  size_t offset = 0;
+  for (int i = 0; i < FIELD_COUNT; ++i) {
+    std::memcpy(record_->data + offset, fields[i].data(), fields[i].size());
+    record_->lengths[i] = static_cast<uint32_t>(fields[i].size());
+    offset += fields[i].size();
+  }
+  record_->staleTime = entry.staleTime;
+  record_->prefetchTime = entry.prefetchTime;
+  record_->magic = RECORD_MAGIC;
+
+  record_->sequence.store(writing + 1, std::memory_order_release);
+  return true;
+}
+
+bool SharedCredentialCache::tryAcquireLease(int64_t now) {
+  uint64_t current = record_->lease.load(std::memory_order_acquire);
+  for (;;) {
+    const uint32_t owner = static_cast<uint32_t>(current);
+    const int64_t expiry = static_cast<int64_t>(current >> 32);
+    if (owner != 0 && owner != ownerId_ && expiry > now) {
+      return false;
+    }
+    const uint64_t next =
+        (static_cast<uint64_t>(now + LEASE_SECONDS) << 32) | ownerId_;
+    if (record_->lease.compare_exchange_weak(current, next,
+                                             std::memory_order_acq_rel)) {
+      return true;
+    }
+  }
+}
+
+void SharedCredentialCache::releaseLease() {
+  uint64_t current = record_->lease.load(std::memory_order_acquire);
+  while (static_cast<uint32_t>(current) == ownerId_) {
+    if (record_->lease.compare_exchange_weak(current, 0,
+                                             std::memory_order_acq_rel)) {
+      return;
+    }
+  }
+}
+
+uint64_t SharedCredentialCache::getVersion() const {
+  return record_->sequence.load(std::memory_order_acquire) / 2;
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
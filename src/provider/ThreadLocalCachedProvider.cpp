@@ -0,0 +1,100 @@
+#include <algorithm>
+
+#include <darabonba/Exception.hpp>
+
+#include <alibabacloud/credential/provider/ThreadLocalCachedProvider.hpp>
+
+namespace AlibabaCloud {
+namespace Credential {
+
+// C++11 requires out-of-class definition for constexpr static members
+constexpr int64_t ThreadLocalCachedProvider::DEFAULT_REVALIDATE_INTERVAL_MS;
+
+namespace {
+
+const uint64_t CLOCK_CHECKS_PER_INTERVAL = 8;
+const uint64_t MAX_READS_PER_CLOCK_CHECK = 64;
+
+} // namespace
+
+struct ThreadLocalCachedProvider::Entry {
+  uint64_t epoch = 0;  // Provider::getEpoch() when loaded
+  std::chrono::steady_clock::time_point revalidateAt;
+  uint64_t reads = 0;           // Since the last reload
+  uint64_t readsPerCheck = 1;   // Reads between two clock reads
+  uint64_t readsUntilCheck = 1; // Reads left before the next clock read
+  std::shared_ptr<const CredentialSnapshot> snapshot;
+  Models::CredentialModel credential;
+};
+
+ThreadLocalCachedProvider::ThreadLocalCachedProvider(
+    std::shared_ptr<Provider> provider,
+    std::chrono::milliseconds revalidateInterval)
+    : provider_(std::move(provider)), revalidateInterval_(revalidateInterval),
+      id_(PinnedValues::nextOwner()), alive_(std::make_shared<char>()) {
+  if (provider_ == nullptr) {
+    throw Darabonba::Exception("ThreadLocalCachedProvider requires a provider");
+  }
+}
+
+Models::CredentialModel &ThreadLocalCachedProvider::getCredential() {
+  return entry().credential;
+}
+
+const Models::CredentialModel &ThreadLocalCachedProvider::getCredential() const {
+  return entry().credential;
+}
+
+std::shared_ptr<const CredentialSnapshot>
+ThreadLocalCachedProvider::getSnapshot() const {
+  return entry().snapshot;
+}
+
+ThreadLocalCachedProvider::Entry &ThreadLocalCachedProvider::entry() const {
+  // The entry lives on the heap, so its address survives the thread's table
+  // growing or being swept while other providers are called
+  PinnedValues::Slot &slot = PinnedValues::slot(id_, alive_);
+  Entry *found = static_cast<Entry *>(const_cast<void *>(slot.value.get()));
+  if (found == nullptr) {
+    auto added = std::make_shared<Entry>();
+    found = added.get();
+    slot.value = std::move(added);
+    reload(*found, Provider::getEpoch());
+    return *found;
+  }
+
+  const uint64_t epoch = Provider::getEpoch();
+  ++found->reads;
+  if (found->epoch != epoch) {
+    reload(*found, epoch);
+  } else if (--found->readsUntilCheck == 0) {
+    if (std::chrono::steady_clock::now() >= found->revalidateAt) {
+      reload(*found, epoch);
+    } else {
+      found->readsUntilCheck = found->readsPerCheck;
+    }
+  }
+  return *found;
+}
+
+void ThreadLocalCachedProvider::reload(Entry &entry, uint64_t epoch) const {
+  // The epoch was read before the credential, so a refresh racing with this
+  // reload is seen as a new epoch on the next call
+  auto snapshot = provider_->getSnapshot();
+  if (snapshot != entry.snapshot) {
+    entry.credential = snapshot->toCredentialModel();
+    entry.snapshot = std::move(snapshot);
+  }
+  entry.epoch = epoch;
+  entry.revalidateAt = std::chrono::steady_clock::now() + revalidateInterval_;
+  // Sized from the reads since the last reload: a thread reading at the same
+  // rate checks the clock about CLOCK_CHECKS_PER_INTERVAL times per interval
+  entry.readsPerCheck = std::max<uint64_t>(
+      1, std::min(MAX_READS_PER_CLOCK_CHECK,
+                  entry.reads / CLOCK_CHECKS_PER_INTERVAL));
+  entry.readsUntilCheck = entry.readsPerCheck;
+  entry.reads = 0;
+}
+
+} // namespace Credential
+} // namespace AlibabaCloud
@@ -0,0 +1,355 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/AgentServer.hpp>
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/provider/AgentProvider.hpp>
+#include <darabonba/Exception.hpp>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== AgentProtocol Tests ====================
+
+TEST(AgentProtocolTest, CredentialRoundTrip) {
+  Models::CredentialModel credential;
+  credential.setType(Constant::STS)
+      .setAccessKeyId("ak")
+      .setAccessKeySecret("sk")
+      .setSecurityToken("token")
+      .setProviderName("static");
+  CredentialSnapshot snapshot(credential, 1700000000);
+
+  const std::string frame = AgentProtocol::encodeFrame(
+      AgentProtocol::MessageType::CREDENTIAL,
+      AgentProtocol::encodeCredential(snapshot, 7));
+  AgentProtocol::Message message;
+  ASSERT_EQ(frame.size(), AgentProtocol::decodeFrame(frame, message));
+  EXPECT_EQ(AgentProtocol::MessageType::CREDENTIAL, message.type);
+
+  AgentProtocol::Credential decoded;
+  ASSERT_TRUE(AgentProtocol::decodeCredential(message.payload, decoded));
+  EXPECT_EQ(7u, decoded.generation);
+  EXPECT_EQ(1700000000, decoded.expiration);
+  EXPECT_EQ("ak", decoded.credential.getAccessKeyId());
+  EXPECT_EQ("sk", decoded.credential.getAccessKeySecret());
+  EXPECT_EQ("token", decoded.credential.getSecurityToken());
+  EXPECT_FALSE(decoded.credential.hasBearerToken());
+  EXPECT_EQ(Constant::STS, decoded.credential.getType());
+  EXPECT_EQ("static", decoded.credential.getProviderName());
+}
+
+TEST(AgentProtocolTest, IncompleteAndInvalidFrames) {
+  const std::string frame = AgentProtocol::encodeFrame(
+      AgentProtocol::MessageType::FAILURE, "no credentials");
+  AgentProtocol::Message message;
+  EXPECT_EQ(0u, AgentProtocol::decodeFrame(frame.substr(0, 4), message));
+  EXPECT_EQ(0u, AgentProtocol::decodeFrame(frame.substr(0, frame.size() - 1),
+                                           message));
+  EXPECT_THROW(AgentProtocol::decodeFrame("XX" + frame.substr(2), message),
+               Darabonba::Exception);
+
+  AgentProtocol::Credential decoded;
+  EXPECT_FALSE(AgentProtocol::decodeCredential("short", decoded));
+  EXPECT_FALSE(AgentProtocol::decodeCredential(std::string(18, '\xff'), decoded));
+}
+
+TEST(AgentProtocolTest, DefaultSocketInPerUserDirectory) {
+  const char *socket = std::getenv(Constant::ENV_CREDENTIALS_AGENT_SOCKET.c_str());
+  const char *runtime = std::getenv("XDG_RUNTIME_DIR");
+  const std::string savedSocket = socket != nullptr ? socket : "";
+  const std::string savedRuntime = runtime != nullptr ? runtime : "";
+  unsetenv(Constant::ENV_CREDENTIALS_AGENT_SOCKET.c_str());
+
+  setenv("XDG_RUNTIME_DIR", "/run/user/1234", 1);
+  EXPECT_EQ("/run/user/1234/alibabacloud-credential-agent.sock",
+            AgentProtocol::getDefaultSocketPath());
+  unsetenv("XDG_RUNTIME_DIR");
+  EXPECT_EQ("/tmp/alibabacloud-credential-agent-" + std::to_string(getuid()) +
+                "/agent.sock",
+            AgentProtocol::getDefaultSocketPath());
+  setenv(Constant::ENV_CREDENTIALS_AGENT_SOCKET.c_str(), "/run/agent.sock", 1);
+  EXPECT_EQ("/run/agent.sock", AgentProtocol::getDefaultSocketPath());
+
+  if (socket != nullptr) {
+    setenv(Constant::ENV_CREDENTIALS_AGENT_SOCKET.c_str(), savedSocket.c_str(), 1);
+  } else {
+    unsetenv(Constant::ENV_CREDENTIALS_AGENT_SOCKET.c_str());
+  }
+  if (runtime != nullptr) {
+    setenv("XDG_RUNTIME_DIR", savedRuntime.c_str(), 1);
+  }
+}
+
+// ==================== AgentServer / AgentProvider Tests ====================
+
+// Provider whose credential the test rotates
+class RotatingProvider : public Provider {
+public:
+  RotatingProvider() { rotate("ak_1"); }
+
+  void rotate(const std::string &accessKeyId) {
+    Models::CredentialModel credential;
+    credential.setType(Constant::STS)
+        .setAccessKeyId(accessKeyId)
+        .setAccessKeySecret("sk")
+        .setSecurityToken("token")
+        .setProviderName("rotating");
+    std::lock_guard<std::mutex> lock(mutex_);
+    credential_ = credential;
+    snapshot_ = std::make_shared<const CredentialSnapshot>(
+        credential, static_cast<int64_t>(time(nullptr)) + 3600);
+  }
+
+  void fail(bool failing) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failing_ = failing;
+  }
+
+  Models::CredentialModel &getCredential() override { return credential_; }
+  const Models::CredentialModel &getCredential() const override {
+    return credential_;
+  }
+
+  std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (failing_) {
+      throw Darabonba::Exception("no credentials configured");
+    }
+    return snapshot_;
+  }
+
+  std::string getProviderName() const override { return "rotating"; }
+
+private:
+  mutable std::mutex mutex_;
+  Models::CredentialModel credential_;
+  std::shared_ptr<const CredentialSnapshot> snapshot_;
+  bool failing_ = false;
+};
+
+class AgentTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    static int counter = 0;
+    socketPath_ = "/tmp/credential_agent_test_" + std::to_string(getpid()) +
+                  "_" + std::to_string(++counter) + ".sock";
+    provider_ = std::make_shared<RotatingProvider>();
+  }
+
+  void TearDown() override { unlink(socketPath_.c_str()); }
+
+  // Wait until the provider's generation reaches `generation`
+  static bool waitForGeneration(const AgentProvider &provider,
+                                uint64_t generation) {
+    for (int i = 0; i < 200; ++i) {
+      if (provider.getGeneration() >= generation) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+  }
+
+  std::string socketPath_;
+  std::shared_ptr<RotatingProvider> provider_;
+};
+
+TEST_F(AgentTest, ServesCredential) {
+  AgentServer server(provider_, socketPath_, 20);
+  server.start();
+
+  AgentProvider agent(socketPath_);
+  const auto &credential = agent.getCredential();
+  EXPECT_EQ("ak_1", credential.getAccessKeyId());
+  EXPECT_EQ("sk", credential.getAccessKeySecret());
+  EXPECT_EQ("token", credential.getSecurityToken());
+  EXPECT_EQ("rotating", credential.getProviderName());
+  EXPECT_EQ("agent", agent.getProviderName());
+  EXPECT_GT(agent.getSnapshot()->getExpiration(), 0);
+  EXPECT_EQ(1u, server.getGeneration());
+}
+
+TEST_F(AgentTest, PushesRotation) {
+  AgentServer server(provider_, socketPath_, 20);
+  server.start();
+
+  AgentProvider agent(socketPath_);
+  ASSERT_TRUE(waitForGeneration(agent, 1));
+  EXPECT_EQ("ak_1", agent.getCredential().getAccessKeyId());
+
+  provider_->rotate("ak_2");
+  ASSERT_TRUE(waitForGeneration(agent, 2));
+  EXPECT_EQ("ak_2", agent.getCredential().getAccessKeyId());
+  EXPECT_EQ(2u, server.getGeneration());
+}
+
+TEST_F(AgentTest, ClientThatStopsReadingDoesNotStallOthers) {
+  AgentServer server(provider_, socketPath_, 20);
+  server.start();
+
+  // Requests far more responses than the socket buffers and the server's
+  // pending limit hold, and never reads them
+  int slow = AgentProtocol::connectTo(socketPath_, 1000);
+  ASSERT_GE(slow, 0);
+  const std::string get =
+      AgentProtocol::encodeFrame(AgentProtocol::MessageType::GET, "");
+  std::string requests;
+  for (int i = 0; i < 1000; ++i) {
+    requests += get;
+  }
+  for (int i = 0; i < 100; ++i) {
+    if (!AgentProtocol::writeFrame(slow, requests)) {
+      break;  // Dropped by the server
+    }
+  }
+
+  AgentProvider agent(socketPath_);
+  EXPECT_EQ("ak_1", agent.getCredential().getAccessKeyId());
+  close(slow);
+}
+
+TEST_F(AgentTest, ReconnectsAfterAgentRestart) {
+  std::unique_ptr<AgentServer> server(new AgentServer(provider_, socketPath_, 20));
+  server->start();
+  AgentProvider agent(socketPath_);
+  ASSERT_TRUE(waitForGeneration(agent, 1));
+
+  server->stop();
+  // The cached credential stays available while the agent is down
+  EXPECT_EQ("ak_1", agent.getCredential().getAccessKeyId());
+
+  provider_->rotate("ak_2");
+  server.reset(new AgentServer(provider_, socketPath_, 20));
+  server->start();
+  ASSERT_TRUE(waitForGeneration(agent, 2));
+  EXPECT_EQ("ak_2", agent.getCredential().getAccessKeyId());
+}
+
+TEST_F(AgentTest, ReportsProviderFailure) {
+  provider_->fail(true);
+  AgentServer server(provider_, socketPath_, 20);
+  server.start();
+
+  AgentProvider agent(socketPath_);
+  try {
+    agent.getCredential();
+    FAIL() << "Expected Darabonba::Exception";
+  } catch (const Darabonba::Exception &e) {
+    EXPECT_NE(std::string::npos,
+              std::string(e.what()).find("no credentials configured"));
+  }
+
+  // Served as soon as the agent's provider recovers
+  provider_->fail(false);
+  ASSERT_TRUE(waitForGeneration(agent, 1));
+  EXPECT_EQ("ak_1", agent.getCredential().getAccessKeyId());
+}
+
+TEST_F(AgentTest, UnreachableAgentThrows) {
+  AgentProvider agent(socketPath_, 100);
+  EXPECT_THROW(agent.getCredential(), Darabonba::Exception);
+  EXPECT_EQ(0u, agent.getGeneration());
+}
+
+TEST_F(AgentTest, SecondAgentOnSameSocketRejected) {
+  AgentServer server(provider_, socketPath_, 20);
+  server.start();
+  AgentServer second(provider_, socketPath_, 20);
+  EXPECT_THROW(second.start(), Darabonba::Exception);
+
+  // The running agent keeps its socket
+  AgentProvider agent(socketPath_);
+  EXPECT_EQ("ak_1", agent.getCredential().getAccessKeyId());
+}
+
+TEST_F(AgentTest, CreatesPrivateSocketDirectory) {
+  const std::string directory = socketPath_ + ".d";
+  AgentServer server(provider_, directory + "/agent.sock", 20);
+  server.start();
+
+  struct stat status;
+  ASSERT_EQ(0, stat(directory.c_str(), &status));
+  EXPECT_EQ(0700u, status.st_mode & 0777u);
+  AgentProvider agent(server.getSocketPath());
+  EXPECT_EQ("ak_1", agent.getCredential().getAccessKeyId());
+
+  server.stop();
+  rmdir(directory.c_str());
+}
+
+TEST_F(AgentTest, AgentOfAnotherUserIgnored) {
+  if (getuid() != 0) {
+    GTEST_SKIP() << "Running a fake agent as another user requires root";
+  }
+  Models::CredentialModel credential;
+  credential.setType(Constant::ACCESS_KEY)
+      .setAccessKeyId("ak_planted")
+      .setAccessKeySecret("secret");
+  // Encoded before forking: the child only makes system calls
+  const std::string frame = AgentProtocol::encodeFrame(
+      AgentProtocol::MessageType::CREDENTIAL,
+      AgentProtocol::encodeCredential(CredentialSnapshot(credential, 0), 1));
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::memcpy(address.sun_path, socketPath_.c_str(), socketPath_.size());
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // Another user planting a socket where the provider looks
+    int fd = -1;
+    if (setuid(65534) != 0 || (fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0 ||
+        bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(fd, 8) != 0) {
+      _exit(1);
+    }
+    for (;;) {
+      int client = accept(fd, nullptr, nullptr);
+      if (client < 0) {
+        _exit(0);
+      }
+      char request[AgentProtocol::HEADER_SIZE];
+      if (recv(client, request, sizeof(request), 0) > 0) {
+        send(client, frame.data(), frame.size(), MSG_NOSIGNAL);
+      }
+      close(client);
+    }
+  }
+
+  bool listening = false;
+  for (int i = 0; i < 200 && !listening; ++i) {
+    int fd = AgentProtocol::connectTo(socketPath_, 100);
+    if (fd >= 0) {
+      EXPECT_FALSE(AgentProtocol::isTrustedPeer(fd));
+      close(fd);
+      listening = true;
+    } else {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  EXPECT_TRUE(listening);
+  {
+    AgentProvider agent(socketPath_, 200);
+    EXPECT_THROW(agent.getCredential(), Darabonba::Exception);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(0u, agent.getGeneration());
+  }
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+}
+
+#endif
@@ -13,6 +13,7 @@ static inline int unsetenv(const char* name) {
 
 #include <alibabacloud/credential/Constant.hpp>
 #include <darabonba/Exception.hpp>
+#include <cstdio>
 #include <fstream>
 
 using namespace AlibabaCloud::Credential;
@@ -155,3 +156,27 @@ TEST_F(CLIProfileProviderTest, SupportsMultipleGetCredentialCalls) {
     provider.getCredential();
   }, Darabonba::Exception);
 }
+
+TEST_F(CLIProfileProviderTest, ProvidersShareProfileFromRegistry) {
+  const std::string path = ::testing::TempDir() + "cli_profile_shared.json";
+  auto writeConfig = [&path](const std::string &accessKeyId) {
+    std::ofstream ofs(path, std::ios::trunc);
+    ofs << "{\"profiles\": [{\"name\": \"dev\", \"mode\": \"AK\","
+        << " \"access_key_id\": \"" << accessKeyId << "\","
+        << " \"access_key_secret\": \"sk\"}]}";
+  };
+  writeConfig("ak_1");
+  SetEnvKV("ALIBABA_CLOUD_CLI_PROFILE_PATH", path.c_str());
+
+  auto registry = std::make_shared<ProfileRegistry>(0);
+  CLIProfileProvider first("dev", registry);
+  CLIProfileProvider second("dev", registry);
+  EXPECT_EQ(&first.getCredential(), &second.getCredential());
+  EXPECT_EQ("ak_1", second.getCredential().getAccessKeyId());
+
+  writeConfig("ak_22");
+  EXPECT_EQ("ak_22", first.getCredential().getAccessKeyId());
+  EXPECT_EQ(&first.getCredential(), &second.getCredential());
+
+  std::remove(path.c_str());
+}
@@ -2,8 +2,13 @@
 #include <alibabacloud/credential/Credential.hpp>
 #include <alibabacloud/credential/Constant.hpp>
 #include <alibabacloud/credential/provider/AccessKeyProvider.hpp>
+#include <darabonba/Exception.hpp>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <cstdio>
+#include <mutex>
+#include <vector>
 
 using namespace AlibabaCloud::Credential;
 
@@ -423,3 +428,117 @@ TEST(ClientTest, CopyConstructor) {
   EXPECT_EQ(client1.getAccessKeySecret(), client2.getAccessKeySecret());
   EXPECT_EQ(client1.getType(), client2.getType());
 }
+
+// Provider whose first fetch blocks until `expected` fetches have started
+class GatedProvider : public Provider {
+public:
+  struct Gate {
+    std::mutex mutex;
+    std::condition_variable cond;
+    int started = 0;
+    int expected = 0;
+  };
+
+  GatedProvider(std::shared_ptr<Gate> gate, std::string accessKeyId,
+                bool fail = false)
+      : gate_(std::move(gate)), fail_(fail) {
+    credential_.setType(Constant::ACCESS_KEY)
+        .setAccessKeyId(std::move(accessKeyId))
+        .setAccessKeySecret("secret");
+  }
+
+  Models::CredentialModel &getCredential() override {
+    wait();
+    return credential_;
+  }
+  const Models::CredentialModel &getCredential() const override {
+    wait();
+    return credential_;
+  }
+  std::string getProviderName() const override { return "gated"; }
+
+private:
+  void wait() const {
+    std::unique_lock<std::mutex> lock(gate_->mutex);
+    ++gate_->started;
+    gate_->cond.notify_all();
+    // Times out unless the other warm-ups run at the same time
+    if (!gate_->cond.wait_for(lock, std::chrono::seconds(5), [this] {
+          return gate_->started >= gate_->expected;
+        })) {
+      throw Darabonba::Exception("warm-ups did not overlap");
+    }
+    if (fail_) {
+      throw Darabonba::Exception("fetch failed");
+    }
+  }
+
+  std::shared_ptr<Gate> gate_;
+  Models::CredentialModel credential_;
+  bool fail_;
+};
+
+TEST(ClientTest, WarmUpReturnsCredential) {
+  auto gate = std::make_shared<GatedProvider::Gate>();
+  gate->expected = 1;
+  Client client(std::make_shared<GatedProvider>(gate, "warm_ak"));
+
+  auto warmUp = client.warmUp();
+  auto snapshot = warmUp.get();
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_EQ("warm_ak", snapshot->getAccessKeyId());
+  EXPECT_EQ("secret", snapshot->getAccessKeySecret());
+}
+
+TEST(ClientTest, WarmUpsRunInParallel) {
+  const int count = 4;
+  auto gate = std::make_shared<GatedProvider::Gate>();
+  gate->expected = count;
+
+  std::vector<Client> clients;
+  for (int i = 0; i < count; ++i) {
+    clients.emplace_back(std::make_shared<GatedProvider>(
+        gate, "parallel_ak_" + std::to_string(i)));
+  }
+  std::vector<std::shared_future<std::shared_ptr<const CredentialSnapshot>>>
+      warmUps;
+  for (const auto &client : clients) {
+    warmUps.push_back(client.warmUp());
+  }
+  for (int i = 0; i < count; ++i) {
+    EXPECT_EQ("parallel_ak_" + std::to_string(i),
+              warmUps[i].get()->getAccessKeyId());
+  }
+}
+
+TEST(ClientTest, WarmUpPropagatesFailure) {
+  auto gate = std::make_shared<GatedProvider::Gate>();
+  gate->expected = 1;
+  Client client(std::make_shared<GatedProvider>(gate, "failing_ak", true));
+
+  auto warmUp = client.warmUp();
+  EXPECT_THROW(warmUp.get(), Darabonba::Exception);
+}
+
+TEST(ClientTest, DiscardedWarmUpDoesNotBlock) {
+  auto gate = std::make_shared<GatedProvider::Gate>();
+  gate->expected = 2;
+  Client client(std::make_shared<GatedProvider>(gate, "background_ak"));
+
+  auto start = std::chrono::steady_clock::now();
+  client.warmUp();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+  // Releases the first warm-up, still running in the background
+  EXPECT_EQ("background_ak", client.warmUp().get()->getAccessKeyId());
+}
+
+TEST(ClientTest, WarmUpOutlivesClient) {
+  auto gate = std::make_shared<GatedProvider::Gate>();
+  gate->expected = 1;
+  std::shared_future<std::shared_ptr<const CredentialSnapshot>> warmUp;
+  {
+    Client client(std::make_shared<GatedProvider>(gate, "orphan_ak"));
+    warmUp = client.warmUp();
+  }
+  EXPECT_EQ("orphan_ak", warmUp.get()->getAccessKeyId());
+}
@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/provider/CredentialFileCache.hpp>
+#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== CredentialFileCache Tests ====================
+
+class CredentialFileCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char dir[] = "/tmp/credential_cache_test_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(dir));
+    root_ = dir;
+    directory_ = root_ + "/cache";
+  }
+
+  void TearDown() override {
+    std::system(("rm -rf " + root_).c_str());
+  }
+
+  std::shared_ptr<CredentialFileCache> makeCache(bool encrypt = false) {
+    CredentialFileCache::Options options;
+    options.directory = directory_;
+    options.encrypt = encrypt;
+    return std::make_shared<CredentialFileCache>(options);
+  }
+
+  static CredentialFileCache::Entry makeEntry(const std::string &accessKeyId) {
+    CredentialFileCache::Entry entry;
+    entry.credential.setType(Constant::RAM_ROLE_ARN)
+        .setAccessKeyId(accessKeyId)
+        .setAccessKeySecret("secret")
+        .setSecurityToken("token")
+        .setProviderName("test");
+    entry.staleTime = static_cast<int64_t>(time(nullptr)) + 3600;
+    entry.prefetchTime = static_cast<int64_t>(time(nullptr)) + 1800;
+    return entry;
+  }
+
+  std::string root_;
+  std::string directory_;
+};
+
+TEST_F(CredentialFileCacheTest, StoreAndLoad) {
+  auto cache = makeCache();
+  auto stored = makeEntry("ak");
+  ASSERT_TRUE(cache->store("key", stored));
+
+  CredentialFileCache::Entry loaded;
+  ASSERT_TRUE(cache->load("key", loaded));
+  EXPECT_EQ("ak", loaded.credential.getAccessKeyId());
+  EXPECT_EQ("secret", loaded.credential.getAccessKeySecret());
+  EXPECT_EQ("token", loaded.credential.getSecurityToken());
+  EXPECT_EQ(Constant::RAM_ROLE_ARN, loaded.credential.getType());
+  EXPECT_EQ(stored.staleTime, loaded.staleTime);
+  EXPECT_EQ(stored.prefetchTime, loaded.prefetchTime);
+
+  EXPECT_FALSE(cache->load("other", loaded));
+  cache->remove("key");
+  EXPECT_FALSE(cache->load("key", loaded));
+}
+
+TEST_F(CredentialFileCacheTest, ConcurrentStoresOfOneKey) {
+  auto cache = makeCache();
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&cache, &failures, i] {
+      for (int j = 0; j < 50; ++j) {
+        if (!cache->store("key", makeEntry("ak_" + std::to_string(i)))) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, failures);
+
+  CredentialFileCache::Entry loaded;
+  ASSERT_TRUE(cache->load("key", loaded));
+  EXPECT_EQ(0u, loaded.credential.getAccessKeyId().find("ak_"));
+
+  // No temporary file is left behind
+  size_t files = 0;
+  DIR *dir = opendir(directory_.c_str());
+  ASSERT_NE(nullptr, dir);
+  while (const dirent *entry = readdir(dir)) {
+    files += entry->d_name[0] != '.';
+  }
+  closedir(dir);
+  EXPECT_EQ(1u, files);
+}
+
+TEST_F(CredentialFileCacheTest, FilesArePrivate) {
+  auto cache = makeCache();
+  ASSERT_TRUE(cache->store("key", makeEntry("ak")));
+
+  struct stat st;
+  ASSERT_EQ(0, stat(directory_.c_str(), &st));
+  EXPECT_EQ(0700u, st.st_mode & 0777u);
+  ASSERT_EQ(0, stat(cache->getPath("key").c_str(), &st));
+  EXPECT_EQ(0600u, st.st_mode & 0777u);
+
+  // Entries readable by others are ignored
+  ASSERT_EQ(0, chmod(cache->getPath("key").c_str(), 0644));
+  CredentialFileCache::Entry loaded;
+  EXPECT_FALSE(cache->load("key", loaded));
+}
+
+TEST_F(CredentialFileCacheTest, KeysAreHashed) {
+  auto cache = makeCache();
+  auto path = cache->getPath("role-arn-with-secret");
+  EXPECT_EQ(std::string::npos, path.find("secret"));
+  EXPECT_NE(cache->getPath("a"), cache->getPath("b"));
+  EXPECT_NE(CredentialFileCache::makeKey({"ab", "c"}),
+            CredentialFileCache::makeKey({"a", "bc"}));
+}
+
+TEST_F(CredentialFileCacheTest, EncryptedEntries) {
+  auto cache = makeCache(true);
+  ASSERT_TRUE(cache->store("key", makeEntry("ak_sealed")));
+
+  std::ifstream in(cache->getPath("key"), std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_EQ(std::string::npos, content.find("ak_sealed"));
+
+  CredentialFileCache::Entry loaded;
+  ASSERT_TRUE(cache->load("key", loaded));
+  EXPECT_EQ("ak_sealed", loaded.credential.getAccessKeyId());
+
+  // Plain readers cannot use sealed files
+  EXPECT_FALSE(makeCache(false)->load("key", loaded));
+}
+
+TEST_F(CredentialFileCacheTest, TamperedEntryRejected) {
+  auto cache = makeCache(true);
+  ASSERT_TRUE(cache->store("key", makeEntry("ak")));
+  {
+    std::fstream file(cache->getPath("key"),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    // Flip bits of the last byte so it always differs
+    file.seekg(-1, std::ios::end);
+    const char last = static_cast<char>(file.get());
+    file.seekp(-1, std::ios::end);
+    file.put(static_cast<char>(last ^ 0x7f));
+  }
+  CredentialFileCache::Entry loaded;
+  EXPECT_FALSE(cache->load("key", loaded));
+}
+
+TEST_F(CredentialFileCacheTest, CorruptEntryRejected) {
+  auto cache = makeCache();
+  ASSERT_TRUE(cache->store("key", makeEntry("ak")));
+  {
+    std::ofstream file(cache->getPath("key"), std::ios::trunc);
+    file << "{not json";
+  }
+  CredentialFileCache::Entry loaded;
+  EXPECT_FALSE(cache->load("key", loaded));
+}
+
+// Refreshable provider counting network refreshes
+class CachedRefreshableProvider : public RefreshableProvider {
+public:
+  explicit CachedRefreshableProvider(std::string key) : key_(std::move(key)) {}
+  ~CachedRefreshableProvider() { shutdown(); }
+
+  std::string getProviderName() const override { return "cached_test"; }
+
+  mutable int refreshCount = 0;
+
+protected:
+  RefreshResult doRefresh() const override {
+    ++refreshCount;
+    Models::CredentialModel credential;
+    credential.setType(Constant::STS)
+        .setAccessKeyId("ak_" + key_)
+        .setAccessKeySecret("sk")
+        .setSecurityToken("token");
+    return makeRefreshResult(credential, getCurrentTime() + 3600);
+  }
+
+  std::string getCacheKey() const override { return key_; }
+
+private:
+  std::string key_;
+};
+
+TEST_F(CredentialFileCacheTest, RefreshableProviderSeedsFromCache) {
+  auto cache = makeCache();
+  {
+    CachedRefreshableProvider first("role");
+    first.setCredentialFileCache(cache);
+    EXPECT_EQ("ak_role", first.getCredential().getAccessKeyId());
+    EXPECT_EQ(1, first.refreshCount);
+  }
+
+  // A new process starts from the file instead of the network
+  CachedRefreshableProvider second("role");
+  second.setCredentialFileCache(cache);
+  EXPECT_EQ("ak_role", second.getCredential().getAccessKeyId());
+  EXPECT_EQ("token", second.getCredential().getSecurityToken());
+  EXPECT_EQ(0, second.refreshCount);
+  EXPECT_EQ(1u, second.getGeneration());
+
+  // Another identity does not share the entry
+  CachedRefreshableProvider other("other");
+  other.setCredentialFileCache(cache);
+  EXPECT_EQ("ak_other", other.getCredential().getAccessKeyId());
+  EXPECT_EQ(1, other.refreshCount);
+}
+
+TEST_F(CredentialFileCacheTest, ExpiredEntryNotUsed) {
+  auto cache = makeCache();
+  auto entry = makeEntry("ak_old");
+  entry.staleTime = static_cast<int64_t>(time(nullptr)) - 1;
+  ASSERT_TRUE(cache->store("role", entry));
+
+  CachedRefreshableProvider provider("role");
+  provider.setCredentialFileCache(cache);
+  EXPECT_EQ("ak_role", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ(1, provider.refreshCount);
+
+  // The refreshed credential replaced the expired entry
+  CredentialFileCache::Entry loaded;
+  ASSERT_TRUE(cache->load("role", loaded));
+  EXPECT_EQ("ak_role", loaded.credential.getAccessKeyId());
+}
+
+// NeedFreshProvider counting refreshes
+class CachedNeedFreshProvider : public NeedFreshProvider {
+public:
+  std::string getProviderName() const override { return "cached_need_fresh"; }
+
+  mutable int refreshCount = 0;
+
+protected:
+  bool refreshCredential() const override {
+    ++refreshCount;
+    credential_.setAccessKeyId("ak_need_fresh").setAccessKeySecret("sk");
+    expiration_ = static_cast<int64_t>(time(nullptr)) + 3600;
+    return true;
+  }
+
+  std::string getCacheKey() const override { return "need_fresh"; }
+};
+
+TEST_F(CredentialFileCacheTest, NeedFreshProviderSeedsFromCache) {
+  auto cache = makeCache();
+  {
+    CachedNeedFreshProvider first;
+    first.setCredentialFileCache(cache);
+    EXPECT_EQ("ak_need_fresh", first.getCredential().getAccessKeyId());
+    EXPECT_EQ(1, first.refreshCount);
+  }
+
+  CachedNeedFreshProvider second;
+  second.setCredentialFileCache(cache);
+  EXPECT_EQ("ak_need_fresh", second.getCredential().getAccessKeyId());
+  EXPECT_EQ(0, second.refreshCount);
+}
+
+#endif
@@ -0,0 +1,277 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/Credential.hpp>
+#include <alibabacloud/credential/CredentialSnapshot.hpp>
+#include <alibabacloud/credential/provider/AccessKeyProvider.hpp>
+#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
+#include <atomic>
+#include <memory>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== CredentialSnapshot Tests ====================
+
+namespace {
+
+// Refreshes on every call and rotates AK/SK together
+class RotatingProvider : public NeedFreshProvider {
+public:
+  std::string getProviderName() const override { return "rotating"; }
+
+protected:
+  bool refreshCredential() const override {
+    std::string suffix = std::to_string(++rotation_);
+    credential_.setAccessKeyId("ak_" + suffix)
+        .setAccessKeySecret("sk_" + suffix);
+    expiration_ = 0;
+    return true;
+  }
+
+private:
+  mutable int rotation_ = 0;
+};
+
+class CountingRefreshableProvider : public RefreshableProvider {
+public:
+  CountingRefreshableProvider()
+      : RefreshableProvider(StaleValueBehavior::STRICT_,
+                            std::make_shared<OneCallerBlocksPrefetch>()) {}
+  ~CountingRefreshableProvider() { shutdown(); }
+
+  void expireNow() { staleTime_ = getCurrentTime() - 1; }
+
+  std::string getProviderName() const override { return "counting"; }
+
+protected:
+  RefreshResult doRefresh() const override {
+    std::string suffix = std::to_string(++count_);
+    Models::CredentialModel credential;
+    credential.setAccessKeyId("ak_" + suffix).setAccessKeySecret("sk_" + suffix);
+    int64_t stale = staleTime_ != 0 ? staleTime_ : getCurrentTime() + 3600;
+    staleTime_ = 0;
+    return RefreshResult(credential, stale, stale);
+  }
+
+private:
+  mutable int count_ = 0;
+  mutable int64_t staleTime_ = 0;
+};
+
+} // namespace
+
+TEST(CredentialSnapshotTest, CopiesModelFields) {
+  Models::CredentialModel model;
+  model.setAccessKeyId("ak")
+      .setAccessKeySecret("sk")
+      .setSecurityToken("token")
+      .setType(Constant::STS)
+      .setProviderName("static_sts");
+
+  CredentialSnapshot snapshot(model, 1234);
+  model.setAccessKeyId("changed");
+
+  EXPECT_EQ("ak", snapshot.getAccessKeyId());
+  EXPECT_EQ("sk", snapshot.getAccessKeySecret());
+  EXPECT_EQ("token", snapshot.getSecurityToken());
+  EXPECT_EQ("", snapshot.getBearerToken());
+  EXPECT_EQ(Constant::STS, snapshot.getType());
+  EXPECT_EQ("static_sts", snapshot.getProviderName());
+  EXPECT_EQ(1234, snapshot.getExpiration());
+
+  auto copy = snapshot.toCredentialModel();
+  EXPECT_EQ("ak", copy.getAccessKeyId());
+  EXPECT_EQ("token", copy.getSecurityToken());
+  EXPECT_FALSE(copy.hasBearerToken());
+}
+
+TEST(CredentialSnapshotTest, CopyOwnsItsBuffer) {
+  Models::CredentialModel model;
+  model.setAccessKeyId("ak").setAccessKeySecret("sk");
+  std::unique_ptr<CredentialSnapshot> original(new CredentialSnapshot(model, 7));
+
+  CredentialSnapshot copy(*original);
+  original.reset();
+
+  EXPECT_EQ("ak", copy.getAccessKeyId());
+  EXPECT_EQ("sk", copy.getAccessKeySecret());
+  EXPECT_TRUE(copy.getSecurityToken().empty());
+  EXPECT_EQ(7, copy.getExpiration());
+}
+
+TEST(CredentialSnapshotTest, EmptyCredential) {
+  CredentialSnapshot snapshot{Models::CredentialModel()};
+
+  EXPECT_TRUE(snapshot.getAccessKeyId().empty());
+  EXPECT_TRUE(snapshot.getProviderName().empty());
+  EXPECT_TRUE(snapshot.toCredentialModel().empty());
+}
+
+TEST(CredentialSnapshotTest, ToMapMatchesModel) {
+  Models::CredentialModel model;
+  model.setAccessKeyId("ak")
+      .setAccessKeySecret("sk")
+      .setBearerToken("bearer")
+      .setType(Constant::BEARER);
+
+  CredentialSnapshot snapshot(model);
+  EXPECT_EQ(model.toMap(), snapshot.toMap());
+
+  Models::CredentialModel restored;
+  restored.fromMap(snapshot.toMap());
+  EXPECT_EQ("bearer", restored.getBearerToken());
+}
+
+TEST(CredentialSnapshotTest, StringViewAccessors) {
+  Models::CredentialModel model;
+  model.setAccessKeyId("LTAI_example");
+  CredentialSnapshot snapshot(model);
+
+  StringView ak = snapshot.getAccessKeyId();
+  EXPECT_EQ(12u, ak.size());
+  EXPECT_EQ("LTAI", ak.substr(0, 4));
+  EXPECT_EQ(std::string("LTAI_example"), std::string(ak));
+  EXPECT_TRUE(ak != StringView("other"));
+}
+
+TEST(CredentialSnapshotTest, StaticProviderSharesSnapshot) {
+  AccessKeyProvider provider("ak", "sk");
+
+  auto first = provider.getSnapshot();
+  auto second = provider.getSnapshot();
+
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ("ak", first->getAccessKeyId());
+  EXPECT_EQ(Constant::ACCESS_KEY, first->getType());
+}
+
+TEST(CredentialSnapshotTest, RefreshableProviderSnapshotSurvivesRefresh) {
+  CountingRefreshableProvider provider;
+
+  provider.expireNow();
+  auto first = provider.getSnapshot();
+  EXPECT_EQ("ak_1", first->getAccessKeyId());
+
+  auto second = provider.getSnapshot();
+  EXPECT_EQ("ak_2", second->getAccessKeyId());
+  EXPECT_EQ(second.get(), provider.getSnapshot().get());
+
+  // The old snapshot is untouched by the refresh
+  EXPECT_EQ("ak_1", first->getAccessKeyId());
+  EXPECT_EQ("sk_1", first->getAccessKeySecret());
+}
+
+TEST(CredentialSnapshotTest, SnapshotFieldsComeFromOneRotation) {
+  RotatingProvider provider;
+  std::atomic<bool> mismatch(false);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&provider, &mismatch]() {
+      for (int j = 0; j < 500; ++j) {
+        auto snapshot = provider.getSnapshot();
+        if (snapshot->getAccessKeyId().substr(3) !=
+            snapshot->getAccessKeySecret().substr(3)) {
+          mismatch = true;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_FALSE(mismatch.load());
+}
+
+// ==================== Generation Tests ====================
+
+namespace {
+
+// Refreshes on every call with identical keys
+class SameKeyProvider : public RefreshableProvider {
+public:
+  SameKeyProvider()
+      : RefreshableProvider(StaleValueBehavior::STRICT_,
+                            std::make_shared<OneCallerBlocksPrefetch>()) {}
+  ~SameKeyProvider() { shutdown(); }
+
+  std::string getProviderName() const override { return "same_key"; }
+
+  mutable int refreshCount = 0;
+
+protected:
+  RefreshResult doRefresh() const override {
+    ++refreshCount;
+    Models::CredentialModel credential;
+    credential.setAccessKeyId("ak").setAccessKeySecret("sk");
+    int64_t stale = getCurrentTime() - 1;
+    return RefreshResult(credential, stale, stale);
+  }
+};
+
+} // namespace
+
+TEST(CredentialGenerationTest, StaticProviderNeverChanges) {
+  AccessKeyProvider provider("ak", "sk");
+  EXPECT_EQ(1u, provider.getGeneration());
+  provider.getCredential();
+  EXPECT_EQ(1u, provider.getGeneration());
+}
+
+TEST(CredentialGenerationTest, RefreshableProviderBumpsOnNewKeys) {
+  CountingRefreshableProvider provider;
+  EXPECT_EQ(0u, provider.getGeneration());
+
+  provider.expireNow();
+  provider.getCredential();  // Installs ak_1, stale immediately
+  EXPECT_EQ(1u, provider.getGeneration());
+
+  provider.getCredential();  // Installs ak_2
+  EXPECT_EQ(2u, provider.getGeneration());
+
+  // Cache hit: same generation
+  provider.getCredential();
+  EXPECT_EQ(2u, provider.getGeneration());
+}
+
+TEST(CredentialGenerationTest, RefreshWithSameKeysKeepsGeneration) {
+  SameKeyProvider provider;
+
+  provider.getCredential();
+  provider.getCredential();
+  provider.getCredential();
+
+  EXPECT_EQ(3, provider.refreshCount);
+  EXPECT_EQ(1u, provider.getGeneration());
+}
+
+TEST(CredentialGenerationTest, NeedFreshProviderBumpsOnRotation) {
+  RotatingProvider provider;
+  EXPECT_EQ(0u, provider.getGeneration());
+
+  auto first = provider.getSnapshot();
+  uint64_t generation = provider.getGeneration();
+  EXPECT_EQ(1u, generation);
+
+  auto second = provider.getSnapshot();
+  EXPECT_NE(first->getAccessKeyId(), second->getAccessKeyId());
+  EXPECT_EQ(generation + 1, provider.getGeneration());
+}
+
+TEST(CredentialSnapshotTest, ClientGetSnapshot) {
+  Models::Config config;
+  config.setType(Constant::ACCESS_KEY)
+      .setAccessKeyId("client_ak")
+      .setAccessKeySecret("client_sk");
+  Client client(config);
+
+  auto snapshot = client.getSnapshot();
+  ASSERT_NE(nullptr, snapshot);
+  EXPECT_EQ("client_ak", snapshot->getAccessKeyId());
+  EXPECT_EQ("client_sk", snapshot->getAccessKeySecret());
+  EXPECT_EQ(1u, client.getGeneration());
+}
@@ -548,3 +548,52 @@ TEST_F(EcsRamRoleTest, StaleTimeWindowConstant) {
   // Should inherit STALE_TIME_WINDOW from RefreshableProvider
   EXPECT_EQ(15 * 60, RefreshableProvider::STALE_TIME_WINDOW);
 }
+
+// ==================== IMDSv2 Token Cache Tests ====================
+
+// Counts token requests instead of calling the metadata service
+class TokenCountingEcsProvider : public EcsRamRoleProvider {
+public:
+  explicit TokenCountingEcsProvider(std::string token)
+      : EcsRamRoleProvider("test_role"), token_(std::move(token)) {}
+
+  using EcsRamRoleProvider::getMetadataToken;
+  using EcsRamRoleProvider::invalidateMetadataToken;
+
+  mutable int fetches = 0;
+
+protected:
+  std::string fetchMetadataToken() const override {
+    ++fetches;
+    return token_.empty() ? "" : token_ + std::to_string(fetches);
+  }
+
+private:
+  std::string token_;
+};
+
+TEST_F(EcsRamRoleTest, MetadataTokenCachedUntilInvalidated) {
+  TokenCountingEcsProvider provider("token-");
+  EXPECT_EQ("token-1", provider.getMetadataToken());
+  EXPECT_EQ("token-1", provider.getMetadataToken());
+  EXPECT_EQ(1, provider.fetches);
+
+  // What a 401 from the metadata service does
+  provider.invalidateMetadataToken();
+  EXPECT_EQ("token-2", provider.getMetadataToken());
+  EXPECT_EQ(2, provider.fetches);
+}
+
+TEST_F(EcsRamRoleTest, MetadataTokenFallbackNotCached) {
+  // Empty token: IMDSv1 fallback, requested again next time
+  TokenCountingEcsProvider provider("");
+  EXPECT_EQ("", provider.getMetadataToken());
+  EXPECT_EQ("", provider.getMetadataToken());
+  EXPECT_EQ(2, provider.fetches);
+}
+
+TEST_F(EcsRamRoleTest, MetadataTokenRenewedBeforeTtl) {
+  EXPECT_GT(EcsRamRoleProvider::METADATA_TOKEN_RENEW_BEFORE, 0);
+  EXPECT_LT(EcsRamRoleProvider::METADATA_TOKEN_RENEW_BEFORE,
+            EcsRamRoleProvider::DEFAULT_METADATA_TOKEN_DURATION);
+}
@@ -127,6 +127,35 @@ TEST_F(OIDCEnvPriorityTest, SessionNameDefaultValue) {
   });
 }
 
+// Exposes the settings an OIDCRoleArnProvider resolved
+class InspectedOIDCProvider : public OIDCRoleArnProvider {
+public:
+  using OIDCRoleArnProvider::OIDCRoleArnProvider;
+
+  const std::string &roleArn() const { return roleArn_; }
+  const std::string &oidcProviderArn() const { return oidcProviderArn_; }
+  const std::string &roleSessionName() const { return roleSessionName_; }
+  const std::string &regionId() const { return regionId_; }
+};
+
+TEST_F(OIDCEnvPriorityTest, ReadsInjectedEnvironment) {
+  env_set("ALIBABA_CLOUD_ROLE_ARN", "process_role_arn");
+  auto environment = std::make_shared<EnvironmentSource>(
+      EnvironmentSource::Variables{
+          {"ALIBABA_CLOUD_ROLE_ARN", "source_role_arn"},
+          {"ALIBABA_CLOUD_OIDC_PROVIDER_ARN", "source_oidc_provider"},
+          {"ALIBABA_CLOUD_OIDC_TOKEN_FILE", "/source/token/file"},
+          {"ALIBABA_CLOUD_STS_REGION", "cn-shanghai"}});
+  auto config = std::make_shared<Models::Config>();
+  config->setRegionId("cn-hangzhou");
+
+  InspectedOIDCProvider provider(config, environment);
+  EXPECT_EQ("source_role_arn", provider.roleArn());
+  EXPECT_EQ("source_oidc_provider", provider.oidcProviderArn());
+  EXPECT_EQ("defaultSessionName", provider.roleSessionName());
+  EXPECT_EQ("cn-shanghai", provider.regionId());
+}
+
 // ==================== CloudSSO Provider Environment Priority Tests ====================
 
 class CloudSSOEnvPriorityTest : public ::testing::Test {
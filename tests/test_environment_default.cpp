@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
+#include <thread>
 
 #if defined(_WIN32) || defined(_WIN64)
 static inline int setenv(const char* name, const char* value, int /*overwrite*/) {
@@ -13,6 +16,7 @@ static inline int unsetenv(const char* name) {
 #include <alibabacloud/credential/provider/EnvironmentVariableProvider.hpp>
 #include <alibabacloud/credential/provider/DefaultProvider.hpp>
 #include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/EnvironmentSource.hpp>
 #include <darabonba/Env.hpp>
 
 using namespace AlibabaCloud::Credential;
@@ -154,6 +158,87 @@ TEST_F(EnvironmentVariableProviderTest, SecurityTokenOptional) {
   EXPECT_EQ(Constant::ACCESS_KEY, credential.getType());
 }
 
+TEST_F(EnvironmentVariableProviderTest, InjectedSourceIgnoresProcessEnvironment) {
+  unset_env("ALIBABA_CLOUD_ACCESS_KEY_ID");
+  unset_env("ALIBABA_CLOUD_ACCESS_KEY_SECRET");
+  auto environment = std::make_shared<EnvironmentSource>(
+      EnvironmentSource::Variables{
+          {"ALIBABA_CLOUD_ACCESS_KEY_ID", "injected_ak"},
+          {"ALIBABA_CLOUD_ACCESS_KEY_SECRET", "injected_secret"},
+          {"ALIBABA_CLOUD_SECURITY_TOKEN", "injected_token"}});
+
+  EnvironmentVariableProvider provider(environment);
+  EXPECT_EQ("injected_ak", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ(Constant::STS, provider.getCredential().getType());
+
+  // A fixed source never reads the process environment
+  environment->reload();
+  EXPECT_EQ(0u, environment->getVersion());
+}
+
+TEST_F(EnvironmentVariableProviderTest, ProviderKeptUntilReload) {
+  set_env("ALIBABA_CLOUD_ACCESS_KEY_ID", "snapshot_ak");
+  set_env("ALIBABA_CLOUD_ACCESS_KEY_SECRET", "snapshot_secret");
+  unset_env("ALIBABA_CLOUD_SECURITY_TOKEN");
+  auto environment = EnvironmentSource::fromProcess();
+  EnvironmentVariableProvider provider(environment);
+
+  const auto *credential = &provider.getCredential();
+  EXPECT_EQ("snapshot_ak", credential->getAccessKeyId());
+  EXPECT_EQ(credential, &provider.getCredential());
+
+  // Changes to the process environment show up only after a reload
+  set_env("ALIBABA_CLOUD_ACCESS_KEY_ID", "reloaded_ak");
+  EXPECT_EQ("snapshot_ak", provider.getCredential().getAccessKeyId());
+  const uint64_t epoch = Provider::getEpoch();
+  environment->reload();
+  EXPECT_EQ(1u, environment->getVersion());
+  EXPECT_EQ("reloaded_ak", provider.getCredential().getAccessKeyId());
+  EXPECT_NE(epoch, Provider::getEpoch());
+
+  // Reloading unchanged variables keeps the provider
+  environment->reload();
+  EXPECT_EQ(1u, environment->getVersion());
+}
+
+TEST_F(EnvironmentVariableProviderTest, FailureCachedUntilReload) {
+  auto environment =
+      std::make_shared<EnvironmentSource>(EnvironmentSource::Variables{
+          {"ALIBABA_CLOUD_ACCESS_KEY_ID", "ak"}});
+  EnvironmentVariableProvider provider(environment);
+  EXPECT_THROW(provider.getCredential(), Darabonba::Exception);
+
+  environment->reload({{"ALIBABA_CLOUD_ACCESS_KEY_ID", "ak"},
+                       {"ALIBABA_CLOUD_ACCESS_KEY_SECRET", "secret"}});
+  EXPECT_EQ("secret", provider.getCredential().getAccessKeySecret());
+
+  environment->reload(EnvironmentSource::Variables());
+  EXPECT_THROW(provider.getCredential(), Darabonba::Exception);
+}
+
+TEST_F(EnvironmentVariableProviderTest, ReplacedProviderOutlivesReferences) {
+  auto environment =
+      std::make_shared<EnvironmentSource>(EnvironmentSource::Variables{
+          {"ALIBABA_CLOUD_ACCESS_KEY_ID", "ak_0"},
+          {"ALIBABA_CLOUD_ACCESS_KEY_SECRET", "secret"}});
+  EnvironmentVariableProvider provider(environment);
+  const auto &first = provider.getCredential();
+
+  // Another thread sees every reload and replaces the inner provider
+  std::thread other([&environment, &provider]() {
+    for (int i = 1; i < 8; ++i) {
+      const std::string accessKeyId = "ak_" + std::to_string(i);
+      environment->reload({{"ALIBABA_CLOUD_ACCESS_KEY_ID", accessKeyId},
+                           {"ALIBABA_CLOUD_ACCESS_KEY_SECRET", "secret"}});
+      EXPECT_EQ(accessKeyId, provider.getCredential().getAccessKeyId());
+    }
+  });
+  other.join();
+
+  EXPECT_EQ("ak_0", first.getAccessKeyId());
+  EXPECT_EQ("ak_7", provider.getCredential().getAccessKeyId());
+}
+
 // ==================== DefaultProvider Tests ====================
 
 class DefaultProviderTest : public ::testing::Test {
@@ -172,6 +257,7 @@ protected:
     saveEnv("ALIBABA_CLOUD_CREDENTIALS_URI");
     saveEnv("ALIBABA_CLOUD_CREDENTIALS_FILE");
     saveEnv("ALIBABA_CLOUD_PROFILE");
+    saveEnv("ALIBABA_CLOUD_CREDENTIALS_PARALLEL_RESOLUTION");
     
     // Clear all for clean test environment
     unset_env("ALIBABA_CLOUD_ACCESS_KEY_ID");
@@ -186,6 +272,7 @@ protected:
     unset_env("ALIBABA_CLOUD_CREDENTIALS_URI");
     unset_env("ALIBABA_CLOUD_CREDENTIALS_FILE");
     unset_env("ALIBABA_CLOUD_PROFILE");
+    unset_env("ALIBABA_CLOUD_CREDENTIALS_PARALLEL_RESOLUTION");
   }
   
   void TearDown() override {
@@ -202,6 +289,7 @@ protected:
     restoreEnv("ALIBABA_CLOUD_CREDENTIALS_URI");
     restoreEnv("ALIBABA_CLOUD_CREDENTIALS_FILE");
     restoreEnv("ALIBABA_CLOUD_PROFILE");
+    restoreEnv("ALIBABA_CLOUD_CREDENTIALS_PARALLEL_RESOLUTION");
   }
   
   void saveEnv(const std::string &name) {
@@ -234,6 +322,21 @@ TEST_F(DefaultProviderTest, UsesEnvironmentVariableProvider) {
   EXPECT_EQ(Constant::ACCESS_KEY, credential.getType());
 }
 
+TEST_F(DefaultProviderTest, ConfiguredFromInjectedSource) {
+  set_env("ALIBABA_CLOUD_ACCESS_KEY_ID", "process_ak");
+  set_env("ALIBABA_CLOUD_ACCESS_KEY_SECRET", "process_secret");
+  auto environment = std::make_shared<EnvironmentSource>(
+      EnvironmentSource::Variables{
+          {"ALIBABA_CLOUD_ACCESS_KEY_ID", "injected_ak"},
+          {"ALIBABA_CLOUD_ACCESS_KEY_SECRET", "injected_secret"}});
+
+  DefaultProvider provider(environment);
+  EXPECT_EQ("injected_ak", provider.getCredential().getAccessKeyId());
+
+  DefaultProvider fromConfig(std::make_shared<Models::Config>(), environment);
+  EXPECT_EQ("injected_ak", fromConfig.getCredential().getAccessKeyId());
+}
+
 TEST_F(DefaultProviderTest, EcsMetadataDisabled) {
   set_env("ALIBABA_CLOUD_ECS_METADATA_DISABLED", "true");
   set_env("ALIBABA_CLOUD_ECS_METADATA", "test_role");
@@ -322,3 +425,344 @@ TEST_F(DefaultProviderTest, ConstGetCredential) {
   EXPECT_EQ("const_ak", credential.getAccessKeyId());
   EXPECT_EQ("const_secret", credential.getAccessKeySecret());
 }
+
+// Provider answering after a delay; an empty access key id fails
+class DelayedProvider : public Provider {
+public:
+  DelayedProvider(int delayMs, const std::string &accessKeyId,
+                  std::atomic<int> *calls = nullptr)
+      : delayMs_(delayMs), calls_(calls) {
+    credential_.setType(Constant::ACCESS_KEY)
+        .setAccessKeyId(accessKeyId)
+        .setAccessKeySecret("secret");
+  }
+
+  Models::CredentialModel &getCredential() override {
+    return const_cast<Models::CredentialModel &>(
+        static_cast<const DelayedProvider *>(this)->getCredential());
+  }
+  const Models::CredentialModel &getCredential() const override {
+    if (calls_ != nullptr) {
+      ++*calls_;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(delayMs_));
+    if (credential_.getAccessKeyId().empty()) {
+      throw Darabonba::Exception("not configured");
+    }
+    return credential_;
+  }
+  std::string getProviderName() const override { return "delayed"; }
+
+private:
+  int delayMs_;
+  std::atomic<int> *calls_;
+  Models::CredentialModel credential_;
+};
+
+// DefaultProvider resolving a test chain
+class TestChain : public DefaultProvider {
+public:
+  TestChain(std::vector<std::unique_ptr<Provider>> providers, bool parallel,
+            bool reuse = false) {
+    for (auto &provider : providers) {
+      providers_.emplace_back(std::move(provider));
+    }
+    parallelResolutionEnabled_ = parallel;
+    reuseLastProviderEnabled_ = reuse;
+  }
+};
+
+static std::vector<std::unique_ptr<Provider>>
+makeChain(std::initializer_list<DelayedProvider *> providers) {
+  std::vector<std::unique_ptr<Provider>> chain;
+  for (auto provider : providers) {
+    chain.emplace_back(provider);
+  }
+  return chain;
+}
+
+TEST_F(DefaultProviderTest, ParallelResolutionHonoursPriority) {
+  // The fast lower-priority provider must not win over the slow one
+  TestChain provider(makeChain({new DelayedProvider(0, ""),
+                                new DelayedProvider(200, "slow_ak"),
+                                new DelayedProvider(0, "fast_ak")}),
+                     true);
+  EXPECT_EQ("slow_ak", provider.getCredential().getAccessKeyId());
+}
+
+TEST_F(DefaultProviderTest, ParallelResolutionOverlapsProbes) {
+  TestChain provider(makeChain({new DelayedProvider(300, ""),
+                                new DelayedProvider(300, ""),
+                                new DelayedProvider(300, "last_ak")}),
+                     true);
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ("last_ak", provider.getSnapshot()->getAccessKeyId());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  // Serial probing would take 900ms plus the winner's second read
+  EXPECT_LT(elapsed, std::chrono::milliseconds(850));
+}
+
+TEST_F(DefaultProviderTest, ParallelResolutionReusesWinner) {
+  std::atomic<int> failingCalls{0};
+  std::atomic<int> winnerCalls{0};
+  TestChain provider(makeChain({new DelayedProvider(0, "", &failingCalls),
+                                new DelayedProvider(0, "ak", &winnerCalls)}),
+                     true);
+  EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  const int afterResolution = winnerCalls;
+  EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ(1, failingCalls);
+  EXPECT_EQ(afterResolution + 1, winnerCalls);
+}
+
+TEST_F(DefaultProviderTest, ParallelResolutionAllFail) {
+  TestChain provider(makeChain({new DelayedProvider(0, ""),
+                                new DelayedProvider(50, "")}),
+                     true);
+  EXPECT_THROW(provider.getCredential(), Darabonba::Exception);
+}
+
+TEST_F(DefaultProviderTest, ParallelResolutionFromConfigAndEnv) {
+  set_env("ALIBABA_CLOUD_ACCESS_KEY_ID", "parallel_ak");
+  set_env("ALIBABA_CLOUD_ACCESS_KEY_SECRET", "parallel_secret");
+
+  auto config = std::make_shared<Models::Config>();
+  config->setParallelResolutionEnabled(true);
+  DefaultProvider fromConfig(config);
+  EXPECT_EQ("parallel_ak", fromConfig.getCredential().getAccessKeyId());
+
+  set_env("ALIBABA_CLOUD_CREDENTIALS_PARALLEL_RESOLUTION", "true");
+  DefaultProvider fromEnv;
+  EXPECT_EQ("parallel_ak", fromEnv.getCredential().getAccessKeyId());
+}
+
+TEST_F(DefaultProviderTest, NegativeCacheSkipsFailedProviders) {
+  std::atomic<int> failingCalls{0};
+  std::atomic<int> winnerCalls{0};
+  TestChain provider(makeChain({new DelayedProvider(0, "", &failingCalls),
+                                new DelayedProvider(0, "ak", &winnerCalls)}),
+                     false);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+    EXPECT_EQ("ak", provider.getSnapshot()->getAccessKeyId());
+  }
+  EXPECT_EQ("delayed", provider.getProviderName());
+  // Probed once; every later read goes straight to the winner
+  EXPECT_EQ(1, failingCalls);
+  EXPECT_EQ(21, winnerCalls);
+}
+
+TEST_F(DefaultProviderTest, FailedProviderRetriedAfterBackoff) {
+  std::atomic<int> failingCalls{0};
+  TestChain provider(makeChain({new DelayedProvider(0, "", &failingCalls),
+                                new DelayedProvider(0, "ak")}),
+                     false);
+  EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ(1, failingCalls);
+
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(DefaultProvider::INITIAL_BACKOFF_MS + 100));
+  EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ(2, failingCalls);
+  // The backoff doubled
+  EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ(2, failingCalls);
+}
+
+TEST_F(DefaultProviderTest, ReprobeDoesNotBlockOtherReaders) {
+  std::atomic<int> failingCalls{0};
+  TestChain provider(makeChain({new DelayedProvider(500, "", &failingCalls),
+                                new DelayedProvider(0, "ak")}),
+                     false);
+  EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(DefaultProvider::INITIAL_BACKOFF_MS + 100));
+  std::thread reprobe([&provider] {
+    EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  });
+  while (failingCalls < 2) {
+    std::this_thread::yield();
+  }
+  // Served by the memoized provider while the failed one is probed again
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ("ak", provider.getSnapshot()->getAccessKeyId());
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(250));
+  reprobe.join();
+  EXPECT_EQ(2, failingCalls);
+}
+
+TEST_F(DefaultProviderTest, ReuseKeepsWinnerWithoutReprobing) {
+  std::atomic<int> failingCalls{0};
+  TestChain provider(makeChain({new DelayedProvider(0, "", &failingCalls),
+                                new DelayedProvider(0, "ak")}),
+                     false, true);
+  EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(DefaultProvider::INITIAL_BACKOFF_MS + 100));
+  EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ(1, failingCalls);
+}
+
+TEST_F(DefaultProviderTest, AllProvidersFailingIsNegativelyCached) {
+  std::atomic<int> calls{0};
+  TestChain provider(makeChain({new DelayedProvider(0, "", &calls),
+                                new DelayedProvider(0, "", &calls)}),
+                     false);
+  EXPECT_THROW(provider.getCredential(), Darabonba::Exception);
+  EXPECT_THROW(provider.getCredential(), Darabonba::Exception);
+  EXPECT_THROW(provider.getProviderName(), Darabonba::Exception);
+  EXPECT_EQ(2, calls);
+}
+
+TEST_F(DefaultProviderTest, ConcurrentResolutionProbesOnce) {
+  std::atomic<int> failingCalls{0};
+  TestChain provider(makeChain({new DelayedProvider(50, "", &failingCalls),
+                                new DelayedProvider(0, "ak")}),
+                     false);
+  std::atomic<int> successes{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&] {
+      if (provider.getSnapshot()->getAccessKeyId() == "ak") {
+        ++successes;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(8, successes);
+  EXPECT_EQ(1, failingCalls);
+}
+
+TEST_F(DefaultProviderTest, GenerationFollowsEnvironmentReload) {
+  auto environment =
+      std::make_shared<EnvironmentSource>(EnvironmentSource::Variables{
+          {"ALIBABA_CLOUD_ACCESS_KEY_ID", "ak_1"},
+          {"ALIBABA_CLOUD_ACCESS_KEY_SECRET", "secret"}});
+  DefaultProvider provider(environment);
+  EXPECT_EQ(0u, provider.getGeneration());
+
+  EXPECT_EQ("ak_1", provider.getCredential().getAccessKeyId());
+  const uint64_t first = provider.getGeneration();
+  EXPECT_NE(0u, first);
+  EXPECT_EQ(first, provider.getGeneration());
+
+  environment->reload({{"ALIBABA_CLOUD_ACCESS_KEY_ID", "ak_2"},
+                       {"ALIBABA_CLOUD_ACCESS_KEY_SECRET", "secret"}});
+  EXPECT_EQ("ak_2", provider.getCredential().getAccessKeyId());
+  EXPECT_GT(provider.getGeneration(), first);
+}
+
+// Access key provider that fails while disabled
+class SwitchedProvider : public Provider {
+public:
+  SwitchedProvider(const std::string &accessKeyId, std::atomic<bool> *enabled)
+      : enabled_(enabled) {
+    credential_.setType(Constant::ACCESS_KEY)
+        .setAccessKeyId(accessKeyId)
+        .setAccessKeySecret("secret");
+  }
+
+  Models::CredentialModel &getCredential() override {
+    return const_cast<Models::CredentialModel &>(
+        static_cast<const SwitchedProvider *>(this)->getCredential());
+  }
+  const Models::CredentialModel &getCredential() const override {
+    if (!*enabled_) {
+      throw Darabonba::Exception("disabled");
+    }
+    return credential_;
+  }
+  uint64_t getGeneration() const override { return 1; }
+  std::string getProviderName() const override { return "switched"; }
+
+private:
+  std::atomic<bool> *enabled_;
+  Models::CredentialModel credential_;
+};
+
+TEST_F(DefaultProviderTest, GenerationAdvancesWhenWinnerChanges) {
+  std::atomic<bool> firstEnabled{false};
+  std::atomic<bool> secondEnabled{true};
+  std::vector<std::unique_ptr<Provider>> chain;
+  chain.emplace_back(new SwitchedProvider("first_ak", &firstEnabled));
+  chain.emplace_back(new SwitchedProvider("second_ak", &secondEnabled));
+  TestChain provider(std::move(chain), false);
+
+  EXPECT_EQ("second_ak", provider.getCredential().getAccessKeyId());
+  const uint64_t second = provider.getGeneration();
+  EXPECT_NE(0u, second);
+
+  // Both providers report the same generation; the swap still shows
+  firstEnabled = true;
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(DefaultProvider::INITIAL_BACKOFF_MS + 100));
+  EXPECT_EQ("first_ak", provider.getCredential().getAccessKeyId());
+  const uint64_t first = provider.getGeneration();
+  EXPECT_GT(first, second);
+
+  // Falling back after the winner fails is a swap as well
+  firstEnabled = false;
+  EXPECT_EQ("second_ak", provider.getCredential().getAccessKeyId());
+  EXPECT_GT(provider.getGeneration(), first);
+}
+
+// Provider failing with a standard exception rather than Darabonba's
+class StdThrowingProvider : public Provider {
+public:
+  Models::CredentialModel &getCredential() override {
+    throw std::runtime_error("not configured");
+  }
+  const Models::CredentialModel &getCredential() const override {
+    throw std::runtime_error("not configured");
+  }
+  std::string getProviderName() const override { return "throwing"; }
+};
+
+TEST_F(DefaultProviderTest, StandardExceptionFailsProbe) {
+  for (bool parallel : {false, true}) {
+    std::vector<std::unique_ptr<Provider>> chain;
+    chain.emplace_back(new StdThrowingProvider());
+    chain.emplace_back(new DelayedProvider(0, "ak"));
+    TestChain provider(std::move(chain), parallel);
+    EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  }
+}
+
+TEST_F(DefaultProviderTest, SlowProbeOutlivesProvider) {
+  auto start = std::chrono::steady_clock::now();
+  {
+    TestChain provider(makeChain({new DelayedProvider(0, "ak"),
+                                  new DelayedProvider(1000, "")}),
+                       true);
+    EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  }
+  // Neither the winner nor the destructor waits for the lower-priority probe
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+}
+
+TEST_F(DefaultProviderTest, RunningProbeNotStartedAgain) {
+  std::atomic<bool> winnerEnabled{true};
+  // Static: the probe thread outlives the test
+  static std::atomic<int> slowCalls{0};
+  std::vector<std::unique_ptr<Provider>> chain;
+  chain.emplace_back(new SwitchedProvider("ak", &winnerEnabled));
+  chain.emplace_back(new DelayedProvider(1000, "slow_ak", &slowCalls));
+  TestChain provider(std::move(chain), true);
+  EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(1, slowCalls);
+
+  // The slow provider is still in its first probe: it fails this
+  // resolution instead of being probed again
+  winnerEnabled = false;
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_THROW(provider.getCredential(), Darabonba::Exception);
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+  EXPECT_EQ(1, slowCalls);
+}
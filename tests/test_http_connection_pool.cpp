@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/HttpConnectionPool.hpp>
+#include <darabonba/Exception.hpp>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== HttpConnectionPool Tests ====================
+
+// Keep-alive HTTP/1.1 server on a loopback port answering every request
+// with a fixed body
+class LoopbackServer {
+public:
+  explicit LoopbackServer(const std::string &body) : body_(body) {
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    socklen_t length = sizeof(addr);
+    getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &length);
+    port_ = ntohs(addr.sin_port);
+    listen(fd_, 16);
+    acceptor_ = std::thread(&LoopbackServer::acceptLoop, this);
+  }
+
+  ~LoopbackServer() {
+    shutdown(fd_, SHUT_RDWR);
+    close(fd_);
+    acceptor_.join();
+    for (auto &connection : connections_) {
+      connection.join();
+    }
+  }
+
+  std::string url(const std::string &path = "/") const {
+    return "http://127.0.0.1:" + std::to_string(port_) + path;
+  }
+
+  int accepted() const { return accepted_.load(); }
+
+  std::string lastRequest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastRequest_;
+  }
+
+private:
+  void acceptLoop() {
+    for (;;) {
+      const int client = accept(fd_, nullptr, nullptr);
+      if (client < 0) {
+        return;
+      }
+      ++accepted_;
+      connections_.emplace_back(&LoopbackServer::serve, this, client);
+    }
+  }
+
+  void serve(int client) {
+    std::string buffer;
+    char chunk[4096];
+    for (;;) {
+      const auto headerEnd = buffer.find("\r\n\r\n");
+      if (headerEnd == std::string::npos) {
+        const ssize_t n = recv(client, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+          break;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+        continue;
+      }
+      size_t contentLength = 0;
+      const auto lengthAt = buffer.find("Content-Length: ");
+      if (lengthAt != std::string::npos && lengthAt < headerEnd) {
+        contentLength = std::stoul(buffer.substr(lengthAt + 16));
+      }
+      const size_t requestEnd = headerEnd + 4 + contentLength;
+      if (buffer.size() < requestEnd) {
+        const ssize_t n = recv(client, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+          break;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+        continue;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastRequest_ = buffer.substr(0, requestEnd);
+      }
+      buffer.erase(0, requestEnd);
+      const std::string response =
+          "HTTP/1.1 200 OK\r\nContent-Length: " +
+          std::to_string(body_.size()) + "\r\n\r\n" + body_;
+      send(client, response.data(), response.size(), MSG_NOSIGNAL);
+    }
+    close(client);
+  }
+
+  const std::string body_;
+  int fd_ = -1;
+  int port_ = 0;
+  std::atomic<int> accepted_{0};
+  std::thread acceptor_;
+  std::vector<std::thread> connections_;  // Touched by acceptor_ only
+  mutable std::mutex mutex_;
+  std::string lastRequest_;
+};
+
+TEST(HttpConnectionPoolTest, ReusesConnectionToSameEndpoint) {
+  LoopbackServer server("{\"Code\":\"Success\"}");
+  HttpConnectionPool pool{HttpConnectionPool::Options()};
+
+  for (int i = 0; i < 3; ++i) {
+    const auto response = pool.send(HttpRequest(server.url("/refresh")));
+    EXPECT_EQ(200, response.statusCode);
+    EXPECT_EQ("{\"Code\":\"Success\"}", response.body);
+  }
+
+  EXPECT_EQ(1, server.accepted());
+  EXPECT_EQ(1u, pool.idleConnections());
+  EXPECT_EQ(1u, pool.getStats().connectionsOpened);
+  EXPECT_EQ(2u, pool.getStats().connectionsReused);
+}
+
+TEST(HttpConnectionPoolTest, SendsMethodQueryHeadersAndBody) {
+  LoopbackServer server("{}");
+  HttpConnectionPool pool{HttpConnectionPool::Options()};
+
+  HttpRequest request(server.url("/token"));
+  request.method = "POST";
+  request.query = {{"Action", "AssumeRole"}};
+  request.headers["x-acs-action"] = "AssumeRole";
+  request.body = "grant_type=client_credentials";
+  pool.send(request);
+
+  const std::string sent = server.lastRequest();
+  EXPECT_EQ(0u, sent.find("POST /token?Action=AssumeRole HTTP/1.1\r\n"));
+  EXPECT_NE(std::string::npos, sent.find("x-acs-action: AssumeRole\r\n"));
+  EXPECT_NE(std::string::npos,
+            sent.find("\r\n\r\ngrant_type=client_credentials"));
+}
+
+TEST(HttpConnectionPoolTest, IdleConnectionsBoundedPerEndpoint) {
+  LoopbackServer server("{}");
+  HttpConnectionPool::Options options;
+  options.maxIdlePerEndpoint = 0;
+  HttpConnectionPool pool(options);
+
+  pool.send(HttpRequest(server.url()));
+  pool.send(HttpRequest(server.url()));
+
+  EXPECT_EQ(0u, pool.idleConnections());
+  EXPECT_EQ(2u, pool.getStats().connectionsOpened);
+}
+
+TEST(HttpConnectionPoolTest, IdleConnectionsExpire) {
+  LoopbackServer server("{}");
+  HttpConnectionPool::Options options;
+  options.idleTimeoutMs = 50;
+  HttpConnectionPool pool(options);
+
+  pool.send(HttpRequest(server.url()));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  pool.send(HttpRequest(server.url()));
+
+  EXPECT_EQ(2, server.accepted());
+  EXPECT_EQ(0u, pool.getStats().connectionsReused);
+}
+
+TEST(HttpConnectionPoolTest, ConnectionFailureThrows) {
+  HttpConnectionPool pool{HttpConnectionPool::Options()};
+  int port = 0;
+  {
+    // A port nothing listens on any more
+    LoopbackServer server("{}");
+    port = std::stoi(server.url().substr(17));
+  }
+
+  HttpRequest request("http://127.0.0.1:" + std::to_string(port) + "/");
+  request.connectTimeoutMs = 1000;
+  EXPECT_THROW(pool.send(request), Darabonba::Exception);
+  EXPECT_EQ(0u, pool.idleConnections());
+}
+
+#endif
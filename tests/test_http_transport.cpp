@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/Credential.hpp>
+#include <alibabacloud/credential/HttpTransport.hpp>
+#include <alibabacloud/credential/provider/URLProvider.hpp>
+#include <darabonba/Exception.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== HttpTransport Tests ====================
+
+// Answers every request with a fixed response and records the requests
+class FakeHttpTransport : public HttpTransport {
+public:
+  FakeHttpTransport(int statusCode, const std::string &body) {
+    response_.statusCode = statusCode;
+    response_.body = body;
+  }
+
+  HttpResponse send(const HttpRequest &request) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.push_back(request);
+    return response_;
+  }
+
+  std::vector<HttpRequest> requests() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_;
+  }
+
+private:
+  HttpResponse response_;
+  mutable std::mutex mutex_;
+  std::vector<HttpRequest> requests_;
+};
+
+class FailingHttpTransport : public HttpTransport {
+public:
+  HttpResponse send(const HttpRequest &) override {
+    throw Darabonba::Exception("connection refused");
+  }
+};
+
+static const char *const ASSUME_ROLE_RESPONSE =
+    "{\"Code\":\"Success\",\"Credentials\":{\"AccessKeyId\":\"STS.fake\","
+    "\"AccessKeySecret\":\"fakeSecret\",\"SecurityToken\":\"fakeToken\","
+    "\"Expiration\":\"2099-01-01T00:00:00Z\"}}";
+
+static const char *const URL_RESPONSE =
+    "{\"Code\":\"Success\",\"AccessKeyId\":\"STS.url\","
+    "\"AccessKeySecret\":\"urlSecret\",\"SecurityToken\":\"urlToken\","
+    "\"Expiration\":\"2099-01-01T00:00:00Z\"}";
+
+TEST(HttpTransportTest, ConfigTransportUsedByClient) {
+  auto transport = std::make_shared<FakeHttpTransport>(200, ASSUME_ROLE_RESPONSE);
+  Models::Config config;
+  config.setType("ram_role_arn")
+      .setAccessKeyId("akid")
+      .setAccessKeySecret("aksecret")
+      .setRoleArn("acs:ram::123456:role/test")
+      .setRoleSessionName("session")
+      .setConnectTimeout(1500)
+      .setTimeout(2500)
+      .setHttpTransport(transport);
+  Client client(config);
+
+  const auto credential = client.getCredential();
+  EXPECT_EQ("STS.fake", credential.getAccessKeyId());
+  EXPECT_EQ("fakeSecret", credential.getAccessKeySecret());
+  EXPECT_EQ("fakeToken", credential.getSecurityToken());
+
+  const auto requests = transport->requests();
+  ASSERT_EQ(1u, requests.size());
+  const auto &request = requests[0];
+  EXPECT_EQ("POST", request.method);
+  EXPECT_EQ("https://sts.aliyuncs.com/", request.url);
+  EXPECT_EQ("acs:ram::123456:role/test", request.query.at("RoleArn"));
+  EXPECT_EQ("AssumeRole", request.headers.at("x-acs-action"));
+  EXPECT_EQ(0u, request.headers.at("Authorization").find("ACS3-HMAC-SHA256"));
+  EXPECT_EQ(1500, request.connectTimeoutMs);
+  EXPECT_EQ(2500, request.readTimeoutMs);
+}
+
+TEST(HttpTransportTest, ProviderTransportSetDirectly) {
+  auto transport = std::make_shared<FakeHttpTransport>(200, URL_RESPONSE);
+  URLProvider provider("http://localhost:8080/credentials");
+  provider.setHttpTransport(transport);
+
+  EXPECT_EQ("STS.url", provider.getCredential().getAccessKeyId());
+  ASSERT_EQ(1u, transport->requests().size());
+  EXPECT_EQ("GET", transport->requests()[0].method);
+  EXPECT_EQ("http://localhost:8080/credentials", transport->requests()[0].url);
+}
+
+TEST(HttpTransportTest, ErrorStatusFailsRefresh) {
+  auto transport = std::make_shared<FakeHttpTransport>(500, "internal error");
+  URLProvider provider("http://localhost:8080/credentials");
+  provider.setHttpTransport(transport);
+
+  EXPECT_ANY_THROW(provider.getCredential());
+  EXPECT_FALSE(transport->requests().empty());
+}
+
+TEST(HttpTransportTest, TimedTransportReportsEachRequest) {
+  std::vector<int> statusCodes;
+  std::vector<int64_t> durations;
+  auto listener = [&](const HttpRequest &, int statusCode, int64_t elapsedUs) {
+    statusCodes.push_back(statusCode);
+    durations.push_back(elapsedUs);
+  };
+  TimedHttpTransport timed(std::make_shared<FakeHttpTransport>(404, ""),
+                           listener);
+  TimedHttpTransport failing(std::make_shared<FailingHttpTransport>(),
+                             listener);
+
+  EXPECT_EQ(404, timed.send(HttpRequest("http://localhost/")).statusCode);
+  EXPECT_THROW(failing.send(HttpRequest("http://localhost/")),
+               Darabonba::Exception);
+
+  ASSERT_EQ(2u, statusCodes.size());
+  EXPECT_EQ(404, statusCodes[0]);
+  EXPECT_EQ(0, statusCodes[1]);
+  EXPECT_GE(durations[0], 0);
+  EXPECT_GE(durations[1], 0);
+}
+
+TEST(HttpTransportTest, DefaultTransportIsShared) {
+  EXPECT_NE(nullptr, HttpTransport::getDefault());
+  EXPECT_EQ(HttpTransport::getDefault(), HttpTransport::getDefault());
+}
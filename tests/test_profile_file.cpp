@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/ProfileFile.hpp>
+#include <darabonba/Exception.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== ProfileFile Tests ====================
+
+class ProfileFileParserTest : public ::testing::Test {
+protected:
+  void SetUp() override { path_ = ::testing::TempDir() + "profile_file_test"; }
+
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  void write(const std::string &content) {
+    std::ofstream ofs(path_, std::ios::binary | std::ios::trunc);
+    ofs << content;
+  }
+
+  static std::string value(const ProfileFile::Section &section,
+                           const std::string &key) {
+    const auto *field = ProfileFile::find(section, key);
+    return field == nullptr ? "<missing>" : field->str();
+  }
+
+  std::string path_;
+};
+
+TEST_F(ProfileFileParserTest, IniSection) {
+  write("# comment\n"
+        "[default]\n"
+        "enable = true\n"
+        "access_key_id = ak_default\n"
+        "\n"
+        "[  dev  ]\r\n"
+        "  access_key_id=ak_dev  \r\n"
+        "; access_key_secret = commented\r\n"
+        "access_key_secret = a=b\r\n"
+        "[prod]\n"
+        "access_key_id = ak_prod\n"
+        "[dev]\n"
+        "access_key_id = ak_dev_override\n"
+        "region_id = cn-hangzhou");
+  ProfileFile file(path_);
+  EXPECT_FALSE(file.isJson());
+
+  ProfileFile::Section section;
+  ASSERT_TRUE(file.findSection("dev", section));
+  // Repeated sections are merged and later keys win
+  EXPECT_EQ("ak_dev_override", value(section, "access_key_id"));
+  EXPECT_EQ("a=b", value(section, "access_key_secret"));
+  EXPECT_EQ("cn-hangzhou", value(section, "region_id"));
+  EXPECT_EQ("<missing>", value(section, "enable"));
+
+  ASSERT_TRUE(file.findSection("default", section));
+  EXPECT_EQ("true", value(section, "enable"));
+  EXPECT_EQ("ak_default", value(section, "access_key_id"));
+
+  EXPECT_FALSE(file.findSection("missing", section));
+  EXPECT_TRUE(section.empty());
+}
+
+TEST_F(ProfileFileParserTest, JsonProfile) {
+  write("{\n"
+        "  \"current\": \"dev\",\n"
+        "  \"meta\": {\"nested\": [1, 2.5e3, true, null, {\"a\": \"}\"}]},\n"
+        "  \"profiles\": [\n"
+        "    {\"name\": \"default\", \"mode\": \"AK\", \"access_key_id\": \"ak_1\"},\n"
+        "    {\"name\": \"dev\", \"mode\": \"AK\", \"retry\": 3,\n"
+        "     \"extra\": {\"name\": \"ignored\"},\n"
+        "     \"access_key_id\": \"ak_\\\"quoted\\\"\\\\\",\n"
+        "     \"access_key_secret\": \"caf\\u00e9 \\ud83d\\ude00\"},\n"
+        "    {\"name\": \"dev\", \"mode\": \"StsToken\"}\n"
+        "  ]\n"
+        "}\n");
+  ProfileFile file(path_);
+  EXPECT_TRUE(file.isJson());
+
+  ProfileFile::Section section;
+  ASSERT_TRUE(file.findJsonProfile("dev", section));
+  // The first profile of a name wins
+  EXPECT_EQ("AK", value(section, "mode"));
+  EXPECT_EQ("ak_\"quoted\"\\", value(section, "access_key_id"));
+  EXPECT_EQ("caf\xc3\xa9 \xf0\x9f\x98\x80", value(section, "access_key_secret"));
+  EXPECT_EQ("<missing>", value(section, "retry"));
+
+  ASSERT_TRUE(file.findJsonProfile("default", section));
+  EXPECT_EQ("ak_1", value(section, "access_key_id"));
+  EXPECT_FALSE(file.findJsonProfile("missing", section));
+}
+
+TEST_F(ProfileFileParserTest, MalformedJsonThrows) {
+  ProfileFile::Section section;
+
+  write("{\"profiles\": [{\"name\": \"a\", ");
+  EXPECT_THROW(ProfileFile(path_).findJsonProfile("a", section),
+               Darabonba::Exception);
+
+  write("{\"profiles\": {\"name\": \"a\"}}");
+  EXPECT_THROW(ProfileFile(path_).findJsonProfile("a", section),
+               Darabonba::Exception);
+
+  write("{\"current\": \"a\"}");
+  EXPECT_THROW(ProfileFile(path_).findJsonProfile("a", section),
+               Darabonba::Exception);
+
+  write("{\"profiles\": [{\"name\": \"unterminated}]}");
+  EXPECT_THROW(ProfileFile(path_).findJsonProfile("a", section),
+               Darabonba::Exception);
+}
+
+TEST_F(ProfileFileParserTest, EmptyAndMissingFiles) {
+  write("");
+  ProfileFile empty(path_);
+  ProfileFile::Section section;
+  EXPECT_TRUE(empty.content().empty());
+  EXPECT_FALSE(empty.findSection("default", section));
+
+  std::remove(path_.c_str());
+  EXPECT_THROW(ProfileFile file(path_), Darabonba::Exception);
+}
+
+TEST_F(ProfileFileParserTest, TruncationAfterOpenIgnored) {
+  std::string content = "[default]\naccess_key_id = ak_default\n";
+  content.append(64 * 1024, '#');
+  write(content);
+  ProfileFile file(path_);
+
+  // Scanning a mapping of the truncated file would fault
+  write("");
+  ProfileFile::Section section;
+  ASSERT_TRUE(file.findSection("default", section));
+  EXPECT_EQ("ak_default", value(section, "access_key_id"));
+  EXPECT_EQ(content.size(), file.content().size());
+}
+
+TEST_F(ProfileFileParserTest, IniIndex) {
+  write("access_key_id = outside\n"
+        "[default]\n"
+        "access_key_id = ak_default\n"
+        "[ dev ]\n"
+        "; comment = ignored\n"
+        "access_key_id = ak_dev\n"
+        "[default]\n"
+        "region_id = cn-hangzhou\n"
+        "[empty]\n");
+  ProfileFile file(path_);
+  ProfileFile::Index index;
+  file.indexSections(index);
+
+  ASSERT_EQ(3u, index.size());
+  EXPECT_EQ("ak_default", value(index["default"], "access_key_id"));
+  EXPECT_EQ("cn-hangzhou", value(index["default"], "region_id"));
+  EXPECT_EQ("ak_dev", value(index["dev"], "access_key_id"));
+  EXPECT_EQ(1u, index["dev"].size());
+  EXPECT_TRUE(index["empty"].empty());
+}
+
+TEST_F(ProfileFileParserTest, JsonIndex) {
+  write("{\"profiles\": [\n"
+        "  {\"name\": \"a\", \"access_key_id\": \"ak_a\"},\n"
+        "  {\"mode\": \"AK\"},\n"
+        "  {\"name\": \"b\\u0021\", \"access_key_id\": \"ak_b\"},\n"
+        "  {\"name\": \"a\", \"access_key_id\": \"ak_a_later\"}\n"
+        "]}");
+  ProfileFile file(path_);
+  ProfileFile::Index index;
+  file.indexJsonProfiles(index);
+
+  ASSERT_EQ(2u, index.size());
+  // The first profile of a name wins
+  EXPECT_EQ("ak_a", value(index["a"], "access_key_id"));
+  EXPECT_EQ("ak_b", value(index["b!"], "access_key_id"));
+
+  // Profiles before a syntax error are kept
+  write("{\"profiles\": [{\"name\": \"a\"}, {\"name\": ");
+  EXPECT_THROW(ProfileFile(path_).indexJsonProfiles(index),
+               Darabonba::Exception);
+  EXPECT_EQ(1u, index.count("a"));
+}
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
+#include <alibabacloud/credential/AuthUtil.hpp>
 #include <alibabacloud/credential/provider/ProfileProvider.hpp>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <thread>
 
 #if defined(_WIN32) || defined(_WIN64)
 static inline int setenv(const char* name, const char* value, int /*overwrite*/) {
@@ -140,3 +144,105 @@ TEST_F(ProfileProviderTest, ProfileSupportsRsaKeyPair) {
     ProfileProvider provider;
   });
 }
+
+// ==================== Cached Profile Tests ====================
+
+class ProfileFileTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    const char *file = std::getenv("ALIBABA_CLOUD_CREDENTIALS_FILE");
+    hadFile_ = file != nullptr;
+    if (hadFile_) {
+      originalFile_ = file;
+    }
+    path_ = ::testing::TempDir() + "profile_provider_test.ini";
+    std::remove(path_.c_str());
+    SetUpEnv("ALIBABA_CLOUD_CREDENTIALS_FILE", path_.c_str());
+  }
+
+  void TearDown() override {
+    std::remove(path_.c_str());
+    if (hadFile_) {
+      SetUpEnv("ALIBABA_CLOUD_CREDENTIALS_FILE", originalFile_.c_str());
+    } else {
+      UnsetEnv("ALIBABA_CLOUD_CREDENTIALS_FILE");
+    }
+  }
+
+  // Replace the profile file with an access_key profile
+  void writeProfile(const std::string &accessKeyId) {
+    std::ofstream ofs(path_, std::ios::trunc);
+    ofs << "[" << AuthUtil::clientType() << "]\n"
+        << "enable = true\n"
+        << "type = access_key\n"
+        << "access_key_id = " << accessKeyId << "\n"
+        << "access_key_secret = secret\n";
+  }
+
+  std::string path_;
+  std::string originalFile_;
+  bool hadFile_ = false;
+};
+
+TEST_F(ProfileFileTest, InnerProviderReusedWhileFileUnchanged) {
+  writeProfile("ak_1");
+  ProfileProvider provider(0);
+
+  const auto &first = provider.getCredential();
+  EXPECT_EQ("ak_1", first.getAccessKeyId());
+  // The same inner provider answers, so the credential is the same object
+  EXPECT_EQ(&first, &provider.getCredential());
+  EXPECT_EQ(provider.getSnapshot(), provider.getSnapshot());
+}
+
+TEST_F(ProfileFileTest, RebuiltWhenFileChanges) {
+  writeProfile("ak_1");
+  ProfileProvider provider(0);
+  EXPECT_EQ("ak_1", provider.getCredential().getAccessKeyId());
+
+  const uint64_t epoch = Provider::getEpoch();
+  writeProfile("ak_22");
+  EXPECT_EQ("ak_22", provider.getCredential().getAccessKeyId());
+  EXPECT_GT(Provider::getEpoch(), epoch);
+}
+
+TEST_F(ProfileFileTest, FileCheckedOncePerRevalidationInterval) {
+  writeProfile("ak_1");
+  ProfileProvider provider(60000);
+  EXPECT_EQ("ak_1", provider.getCredential().getAccessKeyId());
+
+  writeProfile("ak_22");
+  EXPECT_EQ("ak_1", provider.getCredential().getAccessKeyId());
+}
+
+TEST_F(ProfileFileTest, MissingFileThrowsUntilCreated) {
+  ProfileProvider provider(0);
+  EXPECT_THROW(provider.getCredential(), Darabonba::Exception);
+  EXPECT_THROW(provider.getProviderName(), Darabonba::Exception);
+
+  writeProfile("ak_1");
+  EXPECT_EQ("ak_1", provider.getCredential().getAccessKeyId());
+
+  std::remove(path_.c_str());
+  EXPECT_THROW(provider.getSnapshot(), Darabonba::Exception);
+}
+
+TEST_F(ProfileFileTest, ReplacedProviderOutlivesReferences) {
+  writeProfile("ak_1");
+  ProfileProvider provider(0);
+  const auto &first = provider.getCredential();
+
+  // Another thread sees every rewrite and replaces the inner provider
+  std::thread other([this, &provider]() {
+    std::string accessKeyId = "ak_";
+    for (int i = 2; i < 8; ++i) {
+      accessKeyId += std::to_string(i);
+      writeProfile(accessKeyId);
+      EXPECT_EQ(accessKeyId, provider.getCredential().getAccessKeyId());
+    }
+  });
+  other.join();
+
+  EXPECT_EQ("ak_1", first.getAccessKeyId());
+  EXPECT_EQ("ak_234567", provider.getCredential().getAccessKeyId());
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/provider/ProfileRegistry.hpp>
+#include <darabonba/Exception.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== ProfileRegistry Tests ====================
+
+class ProfileRegistryTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    jsonPath_ = ::testing::TempDir() + "profile_registry_test.json";
+    iniPath_ = ::testing::TempDir() + "profile_registry_test.ini";
+  }
+
+  void TearDown() override {
+    std::remove(jsonPath_.c_str());
+    std::remove(iniPath_.c_str());
+  }
+
+  // Replace the JSON file with AK profiles "a", "b" and "c"
+  void writeJson(const std::string &accessKeyIdOfB) {
+    std::ofstream ofs(jsonPath_, std::ios::trunc);
+    ofs << "{\"current\": \"a\", \"profiles\": ["
+        << "{\"name\": \"a\", \"mode\": \"AK\", \"access_key_id\": \"ak_a\","
+        << " \"access_key_secret\": \"sk_a\"},"
+        << "{\"name\": \"b\", \"mode\": \"AK\", \"access_key_id\": \""
+        << accessKeyIdOfB << "\", \"access_key_secret\": \"sk_b\"},"
+        << "{\"name\": \"c\", \"mode\": \"AK\", \"access_key_id\": \"ak_c\","
+        << " \"access_key_secret\": \"sk_c\", \"region_id\": \"cn-hangzhou\"}"
+        << "]}";
+  }
+
+  std::string jsonPath_;
+  std::string iniPath_;
+};
+
+TEST_F(ProfileRegistryTest, JsonProfilesLookedUpByName) {
+  writeJson("ak_b");
+  ProfileRegistry registry(0);
+
+  EXPECT_EQ("ak_a", registry.getConfig(jsonPath_, "a")->getAccessKeyId());
+  EXPECT_EQ("ak_b", registry.getConfig(jsonPath_, "b")->getAccessKeyId());
+  EXPECT_EQ("cn-hangzhou", registry.getConfig(jsonPath_, "c")->getRegionId());
+  EXPECT_EQ("ak_c",
+            registry.getProvider(jsonPath_, "c")->getCredential().getAccessKeyId());
+  EXPECT_THROW(registry.getProvider(jsonPath_, "missing"), Darabonba::Exception);
+}
+
+TEST_F(ProfileRegistryTest, ProvidersSharedPerProfile) {
+  writeJson("ak_b");
+  ProfileRegistry registry;
+
+  auto a = registry.getProvider(jsonPath_, "a");
+  EXPECT_EQ(a, registry.getProvider(jsonPath_, "a"));
+  EXPECT_NE(a, registry.getProvider(jsonPath_, "b"));
+}
+
+TEST_F(ProfileRegistryTest, ReloadKeepsProvidersOfUnchangedProfiles) {
+  writeJson("ak_b");
+  ProfileRegistry registry(0);
+  auto a = registry.getProvider(jsonPath_, "a");
+  auto b = registry.getProvider(jsonPath_, "b");
+
+  writeJson("ak_b_rotated");
+  EXPECT_EQ(a, registry.getProvider(jsonPath_, "a"));
+  auto rotated = registry.getProvider(jsonPath_, "b");
+  EXPECT_NE(b, rotated);
+  EXPECT_EQ("ak_b_rotated", rotated->getCredential().getAccessKeyId());
+  // Providers handed out before the reload stay usable
+  EXPECT_EQ("ak_b", b->getCredential().getAccessKeyId());
+}
+
+TEST_F(ProfileRegistryTest, FileCheckedOncePerRevalidationInterval) {
+  writeJson("ak_b");
+  ProfileRegistry registry(60000);
+  auto b = registry.getProvider(jsonPath_, "b");
+
+  writeJson("ak_b_rotated");
+  EXPECT_EQ(b, registry.getProvider(jsonPath_, "b"));
+
+  registry.clear();
+  EXPECT_EQ("ak_b_rotated",
+            registry.getProvider(jsonPath_, "b")->getCredential().getAccessKeyId());
+}
+
+TEST_F(ProfileRegistryTest, FileReadOncePerVersion) {
+  writeJson("ak_b");
+  ProfileRegistry registry(60000);
+  EXPECT_EQ("ak_a", registry.getConfig(jsonPath_, "a")->getAccessKeyId());
+
+  // Profiles looked up later come from the index built with the first
+  std::remove(jsonPath_.c_str());
+  EXPECT_EQ("ak_b", registry.getConfig(jsonPath_, "b")->getAccessKeyId());
+  EXPECT_EQ("ak_c", registry.getConfig(jsonPath_, "c")->getAccessKeyId());
+  EXPECT_THROW(registry.getConfig(jsonPath_, "missing"), Darabonba::Exception);
+}
+
+TEST_F(ProfileRegistryTest, IniSections) {
+  {
+    std::ofstream ofs(iniPath_);
+    ofs << "[enabled]\n"
+        << "enable = true\n"
+        << "type = access_key\n"
+        << "access_key_id = ak_ini\n"
+        << "access_key_secret = sk_ini\n"
+        << "[disabled]\n"
+        << "enable = false\n"
+        << "type = access_key\n"
+        << "access_key_id = ak_off\n"
+        << "access_key_secret = sk_off\n"
+        << "[incomplete]\n"
+        << "enable = true\n"
+        << "type = access_key\n";
+  }
+  ProfileRegistry registry(0);
+
+  EXPECT_EQ("ak_ini", registry.getProvider(iniPath_, "enabled")
+                          ->getCredential()
+                          .getAccessKeyId());
+  EXPECT_THROW(registry.getProvider(iniPath_, "disabled"), Darabonba::Exception);
+  EXPECT_THROW(registry.getProvider(iniPath_, "incomplete"), Darabonba::Exception);
+}
+
+TEST_F(ProfileRegistryTest, MissingOrInvalidFileThrows) {
+  ProfileRegistry registry(0);
+  EXPECT_THROW(registry.getProvider(jsonPath_, "a"), Darabonba::Exception);
+  EXPECT_THROW(registry.getProvider("", "a"), Darabonba::Exception);
+
+  {
+    std::ofstream ofs(jsonPath_);
+    ofs << "{\"profiles\": ";
+  }
+  EXPECT_THROW(registry.getProvider(jsonPath_, "a"), Darabonba::Exception);
+
+  writeJson("ak_b");
+  EXPECT_EQ("ak_a",
+            registry.getProvider(jsonPath_, "a")->getCredential().getAccessKeyId());
+}
@@ -8,7 +8,11 @@
 #include <alibabacloud/credential/provider/URLProvider.hpp>
 #include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
 #include <alibabacloud/credential/Constant.hpp>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <thread>
+#include <vector>
 
 using namespace AlibabaCloud::Credential;
 
@@ -311,5 +315,72 @@ TEST(NeedFreshProviderTest, AutoRefresh) {
   EXPECT_EQ("refreshed_secret", credential.getAccessKeySecret());
 }
 
+class SlowNeedFreshProvider : public NeedFreshProvider {
+public:
+  explicit SlowNeedFreshProvider(int64_t expiration)
+      : NeedFreshProvider(expiration) {
+    credential_.setAccessKeyId("initial_ak");
+  }
+
+  std::string getProviderName() const override { return "slow_need_fresh"; }
+
+  void setExpirationForTest(int64_t expiration) { expiration_ = expiration; }
+
+  mutable std::atomic<int> refreshStarted{0};
+  mutable std::atomic<int> refreshCount{0};
+
+protected:
+  virtual bool refreshCredential() const override {
+    ++refreshStarted;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    int count = ++refreshCount;
+    credential_.setAccessKeyId("refreshed_ak_" + std::to_string(count));
+    expiration_ = static_cast<int64_t>(time(nullptr)) + 3600;
+    return true;
+  }
+};
+
+TEST(NeedFreshProviderTest, ConcurrentExpiredCallersRefreshOnce) {
+  SlowNeedFreshProvider provider(static_cast<int64_t>(time(nullptr)) - 100);
+
+  std::vector<std::thread> threads;
+  std::vector<std::string> results(64);
+  for (size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&provider, &results, i]() {
+      results[i] = provider.getCredential().getAccessKeyId();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(1, provider.refreshCount.load());
+  for (const auto &ak : results) {
+    EXPECT_EQ("refreshed_ak_1", ak);
+  }
+}
+
+TEST(NeedFreshProviderTest, ValidCredentialServedDuringRefresh) {
+  // Inside the refresh window but not expired yet
+  SlowNeedFreshProvider provider(static_cast<int64_t>(time(nullptr)) + 100);
+  // Publish the initial credential while it needs no refresh yet
+  provider.setExpirationForTest(static_cast<int64_t>(time(nullptr)) + 3600);
+  EXPECT_EQ("initial_ak", provider.getCredential().getAccessKeyId());
+  provider.setExpirationForTest(static_cast<int64_t>(time(nullptr)) + 100);
+
+  std::thread refresher([&provider]() { provider.getCredential(); });
+  while (provider.refreshStarted.load() == 0) {
+    std::this_thread::yield();
+  }
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ("initial_ak", provider.getCredential().getAccessKeyId());
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(50));
+  refresher.join();
+
+  EXPECT_EQ(1, provider.refreshCount.load());
+  EXPECT_EQ("refreshed_ak_1", provider.getCredential().getAccessKeyId());
+}
+
 // Note: strtotime and gmt_datetime are protected methods,
 // they are tested indirectly through the provider refresh mechanism
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/provider/PublishedValue.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== PublishedValue Tests ====================
+
+TEST(PublishedValueTest, EmptyUntilStored) {
+  PublishedValue<std::string> value;
+  EXPECT_EQ(nullptr, value.load());
+  EXPECT_EQ(nullptr, value.pin());
+
+  value.store(std::make_shared<const std::string>("first"));
+  ASSERT_NE(nullptr, value.pin());
+  EXPECT_EQ("first", *value.pin());
+  EXPECT_EQ("first", *value.load());
+}
+
+TEST(PublishedValueTest, PinnedValueOutlivesStores) {
+  PublishedValue<std::string> value;
+  value.store(std::make_shared<const std::string>("first"));
+  std::weak_ptr<const std::string> first = value.load();
+  const std::string *pinned = value.pin();
+
+  std::thread writer([&value]() {
+    for (int i = 0; i < 10; ++i) {
+      value.store(std::make_shared<const std::string>(std::to_string(i)));
+    }
+  });
+  writer.join();
+
+  // Kept alive by this thread's pin only
+  EXPECT_FALSE(first.expired());
+  EXPECT_EQ("first", *pinned);
+
+  // Released by the next pin
+  EXPECT_EQ("9", *value.pin());
+  EXPECT_TRUE(first.expired());
+}
+
+TEST(PublishedValueTest, PinsAreKeptPerThread) {
+  PublishedValue<std::string> value;
+  value.store(std::make_shared<const std::string>("first"));
+  const std::string *pinned = value.pin();
+
+  std::thread reader([&value]() {
+    value.store(std::make_shared<const std::string>("second"));
+    EXPECT_EQ("second", *value.pin());
+  });
+  reader.join();
+
+  EXPECT_EQ("first", *pinned);
+  EXPECT_EQ("second", *value.pin());
+}
+
+TEST(PublishedValueTest, SlotsOfDestroyedValuesAreReleased) {
+  std::weak_ptr<const std::string> released;
+  {
+    PublishedValue<std::string> value;
+    value.store(std::make_shared<const std::string>("destroyed"));
+    released = value.load();
+    value.pin();
+  }
+  // Still held by this thread's slot until the table is swept
+  EXPECT_FALSE(released.expired());
+
+  for (size_t i = 0; i <= PinnedValues::SWEEP_THRESHOLD; ++i) {
+    PublishedValue<std::string> other;
+    other.store(std::make_shared<const std::string>("other"));
+    other.pin();
+  }
+  EXPECT_TRUE(released.expired());
+}
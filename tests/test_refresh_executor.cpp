@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/provider/RefreshExecutor.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== RefreshExecutor Tests ====================
+
+static RefreshExecutor::Options singleThreadOptions() {
+  RefreshExecutor::Options options;
+  options.threadCount = 1;
+  return options;
+}
+
+// Blocks the worker until released
+class Gate {
+public:
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    entered_ = true;
+    cond_.notify_all();
+    cond_.wait(lock, [this]() { return open_; });
+  }
+  void waitEntered() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return entered_; });
+  }
+  void open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+    cond_.notify_all();
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool entered_ = false;
+  bool open_ = false;
+};
+
+TEST(RefreshExecutorTest, RunsSubmittedTask) {
+  RefreshExecutor executor(singleThreadOptions());
+  std::atomic<int> count(0);
+
+  EXPECT_TRUE(executor.submit(nullptr, [&count]() { ++count; }));
+
+  for (int i = 0; i < 100 && count.load() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(1, count.load());
+}
+
+TEST(RefreshExecutorTest, DeduplicatesQueuedTasksPerOwner) {
+  RefreshExecutor executor(singleThreadOptions());
+  Gate gate;
+  int owner = 0;
+  std::atomic<int> count(0);
+
+  // Occupy the only worker
+  executor.submit(nullptr, [&gate]() { gate.wait(); });
+  gate.waitEntered();
+
+  EXPECT_TRUE(executor.submit(&owner, [&count]() { ++count; }));
+  EXPECT_FALSE(executor.submit(&owner, [&count]() { ++count; }));
+  EXPECT_FALSE(executor.submit(&owner, [&count]() { ++count; }));
+  EXPECT_EQ(1u, executor.pendingCount());
+
+  gate.open();
+  for (int i = 0; i < 100 && count.load() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(1, count.load());
+}
+
+TEST(RefreshExecutorTest, CancelDropsQueuedTasks) {
+  RefreshExecutor executor(singleThreadOptions());
+  Gate gate;
+  int owner = 0;
+  std::atomic<int> count(0);
+
+  executor.submit(nullptr, [&gate]() { gate.wait(); });
+  gate.waitEntered();
+  executor.submit(&owner, [&count]() { ++count; });
+
+  executor.cancel(&owner);
+  EXPECT_EQ(0u, executor.pendingCount());
+  gate.open();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(0, count.load());
+}
+
+TEST(RefreshExecutorTest, CancelWaitsForRunningTask) {
+  RefreshExecutor executor(singleThreadOptions());
+  int owner = 0;
+  std::atomic<bool> started(false);
+  std::atomic<bool> finished(false);
+
+  executor.submit(&owner, [&started, &finished]() {
+    started = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    finished = true;
+  });
+  while (!started.load()) {
+    std::this_thread::yield();
+  }
+
+  executor.cancel(&owner);
+  EXPECT_TRUE(finished.load());
+}
+
+TEST(RefreshExecutorTest, TaskExceptionDoesNotStopWorker) {
+  RefreshExecutor executor(singleThreadOptions());
+  int owner = 0;
+  std::atomic<int> count(0);
+
+  executor.submit(nullptr, []() { throw std::runtime_error("boom"); });
+  executor.submit(&owner, [&count]() { ++count; });
+  for (int i = 0; i < 100 && count.load() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(1, count.load());
+}
+
+TEST(RefreshExecutorTest, TaskExceptionReportedToHook) {
+  std::mutex mutex;
+  std::vector<std::string> errors;
+  RefreshExecutor::Options options = singleThreadOptions();
+  options.onTaskError = [&](std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    try {
+      std::rethrow_exception(error);
+    } catch (const std::exception &e) {
+      errors.push_back(e.what());
+    } catch (...) {
+      errors.push_back("unknown");
+    }
+    throw std::runtime_error("hook failures are ignored");
+  };
+  RefreshExecutor executor(options);
+  std::atomic<int> count(0);
+
+  executor.submit(nullptr, []() { throw std::runtime_error("boom"); });
+  executor.submit(nullptr, []() { throw 42; });
+  executor.submit(nullptr, [&count]() { ++count; });
+  for (int i = 0; i < 100 && count.load() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(1, count.load());
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(2u, errors.size());
+  EXPECT_EQ("boom", errors[0]);
+  EXPECT_EQ("unknown", errors[1]);
+}
+
+TEST(RefreshExecutorTest, ThreadCountFromOptions) {
+  RefreshExecutor::Options options;
+  options.threadCount = 3;
+  options.cpuAffinity.push_back(0);
+  RefreshExecutor executor(options);
+
+  EXPECT_EQ(3u, executor.threadCount());
+}
+
+TEST(RefreshExecutorTest, NonBlockingPrefetchUsesExecutor) {
+  RefreshExecutor executor(singleThreadOptions());
+  NonBlockingPrefetch strategy(executor);
+  Gate gate;
+  int owner = 0;
+  std::atomic<int> count(0);
+
+  executor.submit(nullptr, [&gate]() { gate.wait(); });
+  gate.waitEntered();
+
+  strategy.prefetch(&owner, [&count]() { ++count; });
+  strategy.prefetch(&owner, [&count]() { ++count; });
+  EXPECT_EQ(1u, executor.pendingCount());
+
+  strategy.cancel(&owner);
+  EXPECT_EQ(0u, executor.pendingCount());
+  gate.open();
+}
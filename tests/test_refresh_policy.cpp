@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/provider/RefreshPolicy.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <set>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== RefreshPolicy Tests ====================
+
+static RefreshPolicy::Options seeded(uint64_t seed) {
+  RefreshPolicy::Options options;
+  options.jitterSeed = seed;
+  return options;
+}
+
+TEST(RefreshPolicyTest, DefaultOptions) {
+  RefreshPolicy::Options options;
+  EXPECT_DOUBLE_EQ(1.0, options.prefetchFraction);
+  EXPECT_DOUBLE_EQ(0.1, options.jitterFraction);
+  EXPECT_EQ(60, options.minRefreshIntervalSeconds);
+  EXPECT_EQ(0, options.maxRefreshIntervalSeconds);
+  EXPECT_EQ(180, options.staleLeadSeconds);
+}
+
+TEST(RefreshPolicyTest, StaleTime) {
+  RefreshPolicy policy;
+  EXPECT_EQ(1000 - 180, policy.getStaleTime(1000));
+}
+
+TEST(RefreshPolicyTest, JitterIsDeterministicPerSeed) {
+  RefreshPolicy a(seeded(42));
+  RefreshPolicy b(seeded(42));
+  EXPECT_DOUBLE_EQ(a.getJitter(), b.getJitter());
+  EXPECT_DOUBLE_EQ(RefreshPolicy().getJitter(), RefreshPolicy().getJitter());
+
+  std::set<double> values;
+  for (uint64_t seed = 1; seed <= 100; ++seed) {
+    double jitter = RefreshPolicy(seeded(seed)).getJitter();
+    EXPECT_GE(jitter, -1.0);
+    EXPECT_LE(jitter, 1.0);
+    values.insert(jitter);
+  }
+  EXPECT_EQ(100u, values.size());
+}
+
+TEST(RefreshPolicyTest, DefaultPrefetchAtStaleTime) {
+  RefreshPolicy::Options options;
+  options.jitterFraction = 0;
+  RefreshPolicy policy(options);
+  const int64_t now = 1000000;
+
+  // Refreshed as often as when credentials were only renewed near expiry
+  EXPECT_EQ(now + 3600 - 180, policy.getPrefetchTime(now, now + 3600));
+  EXPECT_EQ(now + 6 * 3600 - 180, policy.getPrefetchTime(now, now + 6 * 3600));
+
+  for (uint64_t seed = 1; seed <= 200; ++seed) {
+    int64_t prefetch = RefreshPolicy(seeded(seed)).getPrefetchTime(now, now + 3600);
+    // Capped at the stale time, then up to 10% earlier
+    EXPECT_GE(prefetch, now + 3078);
+    EXPECT_LE(prefetch, now + 3600 - 180);
+  }
+}
+
+TEST(RefreshPolicyTest, DefaultPrefetchDiffersForOppositeJitter) {
+  uint64_t negative = 0;
+  uint64_t positive = 0;
+  for (uint64_t seed = 1; seed <= 100 && (negative == 0 || positive == 0);
+       ++seed) {
+    const double jitter = RefreshPolicy(seeded(seed)).getJitter();
+    if (jitter < -0.5) {
+      negative = seed;
+    } else if (jitter > 0.5) {
+      positive = seed;
+    }
+  }
+  ASSERT_NE(0u, negative);
+  ASSERT_NE(0u, positive);
+
+  // Delays capped at the stale time are still spread, rather than the whole
+  // fleet with positive jitter meeting there
+  const int64_t now = 1000000;
+  const int64_t staleTime = now + 3600 - 180;
+  const int64_t negativePrefetch =
+      RefreshPolicy(seeded(negative)).getPrefetchTime(now, now + 3600);
+  const int64_t positivePrefetch =
+      RefreshPolicy(seeded(positive)).getPrefetchTime(now, now + 3600);
+  EXPECT_NE(negativePrefetch, positivePrefetch);
+  EXPECT_LT(positivePrefetch, staleTime);
+}
+
+TEST(RefreshPolicyTest, PrefetchSpreadWithinJitterBand) {
+  const int64_t now = 1000000;
+  const int64_t expiration = now + 3600;
+  int64_t earliest = expiration;
+  int64_t latest = now;
+  for (uint64_t seed = 1; seed <= 200; ++seed) {
+    RefreshPolicy::Options options = seeded(seed);
+    options.prefetchFraction = 0.5;
+    int64_t prefetch = RefreshPolicy(options).getPrefetchTime(now, expiration);
+    // 1800s, up to 10% earlier
+    EXPECT_GE(prefetch, now + 1620);
+    EXPECT_LE(prefetch, now + 1800);
+    earliest = std::min(earliest, prefetch);
+    latest = std::max(latest, prefetch);
+  }
+  EXPECT_GT(latest - earliest, 90);
+}
+
+TEST(RefreshPolicyTest, PrefetchClampedToIntervals) {
+  RefreshPolicy::Options options;
+  options.prefetchFraction = 0.5;
+  options.jitterFraction = 0;
+  options.minRefreshIntervalSeconds = 120;
+  options.maxRefreshIntervalSeconds = 600;
+  options.staleLeadSeconds = 10;
+  RefreshPolicy policy(options);
+  const int64_t now = 1000000;
+
+  EXPECT_EQ(now + 600, policy.getPrefetchTime(now, now + 6 * 3600));
+  EXPECT_EQ(now + 120, policy.getPrefetchTime(now, now + 200));
+  // Never after the stale time, never before now
+  EXPECT_EQ(now + 90, policy.getPrefetchTime(now, now + 100));
+  EXPECT_EQ(now, policy.getPrefetchTime(now, now + 5));
+}
+
+TEST(RefreshPolicyTest, NeedsRefresh) {
+  RefreshPolicy::Options options;
+  options.prefetchFraction = 0.5;
+  options.jitterFraction = 0;
+  RefreshPolicy policy(options);
+  const int64_t now = 1000000;
+
+  EXPECT_FALSE(policy.needsRefresh(now, 0, now + 1000));
+  EXPECT_TRUE(policy.needsRefresh(now, 0, now + 180));
+  EXPECT_TRUE(policy.needsRefresh(now, 0, now - 1));
+  // Fetched 1000s ago with 1000s left: past the halfway prefetch point
+  EXPECT_TRUE(policy.needsRefresh(now, now - 1000, now + 1000));
+  EXPECT_FALSE(policy.needsRefresh(now, now - 100, now + 1000));
+}
+
+TEST(RefreshPolicyTest, InvalidOptionsAreNormalized) {
+  RefreshPolicy::Options options;
+  options.prefetchFraction = 3;
+  options.jitterFraction = -1;
+  options.minRefreshIntervalSeconds = 900;
+  options.maxRefreshIntervalSeconds = 100;
+  RefreshPolicy policy(options);
+  EXPECT_DOUBLE_EQ(1.0, policy.getOptions().prefetchFraction);
+  EXPECT_DOUBLE_EQ(0.0, policy.getOptions().jitterFraction);
+  EXPECT_EQ(900, policy.getOptions().maxRefreshIntervalSeconds);
+}
+
+TEST(RefreshPolicyTest, OptionsFromEnvironment) {
+  setenv(Constant::ENV_REFRESH_PREFETCH_FRACTION.c_str(), "0.75", 1);
+  setenv(Constant::ENV_REFRESH_JITTER_FRACTION.c_str(), "0.2", 1);
+  setenv(Constant::ENV_REFRESH_MIN_INTERVAL.c_str(), "30", 1);
+  setenv(Constant::ENV_REFRESH_MAX_INTERVAL.c_str(), "invalid", 1);
+
+  auto options = RefreshPolicy::defaultOptions();
+  EXPECT_DOUBLE_EQ(0.75, options.prefetchFraction);
+  EXPECT_DOUBLE_EQ(0.2, options.jitterFraction);
+  EXPECT_EQ(30, options.minRefreshIntervalSeconds);
+  EXPECT_EQ(0, options.maxRefreshIntervalSeconds);
+
+  unsetenv(Constant::ENV_REFRESH_PREFETCH_FRACTION.c_str());
+  unsetenv(Constant::ENV_REFRESH_JITTER_FRACTION.c_str());
+  unsetenv(Constant::ENV_REFRESH_MIN_INTERVAL.c_str());
+  unsetenv(Constant::ENV_REFRESH_MAX_INTERVAL.c_str());
+}
+
+// NeedFreshProvider refreshing early through its policy
+class PolicyNeedFreshProvider : public NeedFreshProvider {
+public:
+  explicit PolicyNeedFreshProvider(std::shared_ptr<const RefreshPolicy> policy)
+      : NeedFreshProvider(std::move(policy)) {}
+
+  std::string getProviderName() const override { return "policy_test"; }
+
+  void setExpiration(int64_t expiration) { expiration_ = expiration; }
+
+  mutable int refreshCount = 0;
+  bool shouldFail = false;
+
+protected:
+  bool refreshCredential() const override {
+    ++refreshCount;
+    if (shouldFail) {
+      throw std::runtime_error("refresh failed");
+    }
+    credential_.setAccessKeyId("ak_" + std::to_string(refreshCount));
+    expiration_ = static_cast<int64_t>(time(nullptr)) + 3600;
+    return true;
+  }
+};
+
+TEST(RefreshPolicyTest, NeedFreshProviderPrefetchesEarly) {
+  RefreshPolicy::Options options;
+  options.jitterFraction = 0;
+  options.minRefreshIntervalSeconds = 0;
+  options.prefetchFraction = 0;
+  PolicyNeedFreshProvider provider(std::make_shared<RefreshPolicy>(options));
+
+  EXPECT_EQ("ak_1", provider.getCredential().getAccessKeyId());
+  // Prefetch time reached immediately, long before the stale time
+  EXPECT_EQ("ak_2", provider.getCredential().getAccessKeyId());
+
+  // A failed early refresh keeps the valid credential
+  provider.shouldFail = true;
+  EXPECT_EQ("ak_2", provider.getCredential().getAccessKeyId());
+
+  // A failed refresh of a stale credential is reported
+  provider.setExpiration(static_cast<int64_t>(time(nullptr)) + 10);
+  EXPECT_THROW(provider.getCredential(), std::runtime_error);
+}
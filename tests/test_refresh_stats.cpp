@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/provider/RefreshStats.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
+#include <chrono>
+#include <stdexcept>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== RefreshStats Tests ====================
+
+using std::chrono::milliseconds;
+
+TEST(RefreshStatsTest, EmptyStats) {
+  RefreshStats stats;
+  EXPECT_EQ(0u, stats.getSampleCount());
+  EXPECT_EQ(0, stats.getP99LatencyMillis());
+  EXPECT_DOUBLE_EQ(0.0, stats.getFailureRate());
+  EXPECT_EQ(RefreshStats::MIN_PREFETCH_LEAD_SECONDS,
+            stats.getPrefetchLeadSeconds());
+}
+
+TEST(RefreshStatsTest, P99TracksSlowTail) {
+  RefreshStats stats;
+  for (int i = 0; i < 99; ++i) {
+    stats.recordSuccess(milliseconds(2));
+  }
+  EXPECT_EQ(2, stats.getP99LatencyMillis());
+  stats.recordSuccess(milliseconds(8000));
+  stats.recordSuccess(milliseconds(9000));
+  EXPECT_EQ(8000, stats.getP99LatencyMillis());
+  EXPECT_EQ(101u, stats.getSampleCount());
+}
+
+TEST(RefreshStatsTest, OldSamplesAgeOut) {
+  RefreshStats stats;
+  for (size_t i = 0; i < RefreshStats::LATENCY_SAMPLES; ++i) {
+    stats.recordSuccess(milliseconds(10000));
+  }
+  EXPECT_EQ(10000, stats.getP99LatencyMillis());
+  for (size_t i = 0; i < RefreshStats::LATENCY_SAMPLES; ++i) {
+    stats.recordSuccess(milliseconds(3));
+  }
+  EXPECT_EQ(3, stats.getP99LatencyMillis());
+  EXPECT_EQ(RefreshStats::LATENCY_SAMPLES, stats.getSampleCount());
+  EXPECT_EQ(RefreshStats::MIN_PREFETCH_LEAD_SECONDS,
+            stats.getPrefetchLeadSeconds());
+}
+
+TEST(RefreshStatsTest, LeadWidensWhenSlow) {
+  RefreshStats stats;
+  stats.recordSuccess(milliseconds(10000));
+  // One attempt, twice the p99
+  EXPECT_EQ(20, stats.getPrefetchLeadSeconds());
+}
+
+TEST(RefreshStatsTest, LeadWidensWhenFlaky) {
+  RefreshStats stats;
+  stats.recordSuccess(milliseconds(10000));
+  const int64_t healthy = stats.getPrefetchLeadSeconds();
+  for (int i = 0; i < 5; ++i) {
+    stats.recordFailure(milliseconds(10000));
+  }
+  EXPECT_GT(stats.getFailureRate(), 0.5);
+  EXPECT_GT(stats.getPrefetchLeadSeconds(), healthy);
+  EXPECT_LE(stats.getPrefetchLeadSeconds(),
+            RefreshStats::MAX_PREFETCH_LEAD_SECONDS);
+
+  // Recovers as refreshes succeed again
+  for (int i = 0; i < 50; ++i) {
+    stats.recordSuccess(milliseconds(10000));
+  }
+  EXPECT_LT(stats.getFailureRate(), 0.01);
+  EXPECT_EQ(healthy, stats.getPrefetchLeadSeconds());
+}
+
+// Provider whose refreshes can be made to fail
+class StatsRefreshableProvider : public RefreshableProvider {
+public:
+  ~StatsRefreshableProvider() { shutdown(); }
+
+  std::string getProviderName() const override { return "stats_test"; }
+
+  using RefreshableProvider::makeRefreshResult;
+
+  bool shouldFail = false;
+  int64_t expiration = 0;
+
+protected:
+  RefreshResult doRefresh() const override {
+    if (shouldFail) {
+      throw std::runtime_error("refresh failed");
+    }
+    Models::CredentialModel credential;
+    credential.setType(Constant::ACCESS_KEY)
+        .setAccessKeyId("ak")
+        .setAccessKeySecret("sk");
+    return makeRefreshResult(credential, expiration);
+  }
+};
+
+TEST(RefreshStatsTest, ProviderRecordsRefreshes) {
+  StatsRefreshableProvider provider;
+  provider.expiration = static_cast<int64_t>(std::time(nullptr)) + 3600;
+  provider.getCredential();
+  EXPECT_EQ(1u, provider.getRefreshStats().getSampleCount());
+  EXPECT_DOUBLE_EQ(0.0, provider.getRefreshStats().getFailureRate());
+
+  // A fresh provider fails on its first refresh
+  StatsRefreshableProvider failing;
+  failing.shouldFail = true;
+  EXPECT_THROW(failing.getCredential(), std::runtime_error);
+  EXPECT_EQ(1u, failing.getRefreshStats().getSampleCount());
+  EXPECT_GT(failing.getRefreshStats().getFailureRate(), 0.0);
+}
+
+TEST(RefreshStatsTest, PrefetchKeepsLeadBeforeStaleTime) {
+  StatsRefreshableProvider provider;
+  Models::CredentialModel credential;
+  const int64_t now = static_cast<int64_t>(std::time(nullptr));
+
+  // 15 minute credential: stale at now + 720
+  auto result = provider.makeRefreshResult(credential, now + 900);
+  EXPECT_EQ(now + 720, result.staleTime);
+  EXPECT_LE(result.prefetchTime,
+            result.staleTime - RefreshStats::MIN_PREFETCH_LEAD_SECONDS);
+  EXPECT_GE(result.prefetchTime, now);
+}
@@ -13,11 +13,17 @@ class TestRefreshableProvider : public RefreshableProvider {
 public:
   TestRefreshableProvider(
       StaleValueBehavior behavior = StaleValueBehavior::STRICT_,
-      std::shared_ptr<PrefetchStrategy> strategy = std::make_shared<NonBlockingPrefetch>())
-      : RefreshableProvider(behavior, strategy), 
+      std::shared_ptr<PrefetchStrategy> strategy = std::make_shared<NonBlockingPrefetch>(),
+      std::shared_ptr<const RefreshPolicy> policy = nullptr)
+      : RefreshableProvider(behavior, strategy, policy), 
         refreshCount_(0),
         shouldFail_(false),
         customExpiration_(0) {}
+
+  ~TestRefreshableProvider() { shutdown(); }
+
+  using RefreshableProvider::makeRefreshResult;
+  using RefreshableProvider::requestRefresh;
   
   void setShouldFail(bool fail) {
     shouldFail_ = fail;
@@ -164,6 +170,77 @@ TEST(RefreshableProviderTest, RefreshFailureWithNoCacheThrows) {
   }, std::exception);
 }
 
+TEST(RefreshableProviderTest, RefreshFailureKeepsExceptionType) {
+  TestRefreshableProvider provider(StaleValueBehavior::STRICT_);
+  provider.setShouldFail(true);
+
+  try {
+    provider.getCredential();
+    FAIL() << "Expected refresh failure";
+  } catch (const std::runtime_error &e) {
+    EXPECT_STREQ("Simulated refresh failure", e.what());
+  }
+}
+
+TEST(RefreshableProviderTest, MakeRefreshResultTimes) {
+  RefreshPolicy::Options options;
+  options.prefetchFraction = 0.5;
+  options.jitterFraction = 0;
+  options.maxRefreshIntervalSeconds = 3600;
+  TestRefreshableProvider provider(StaleValueBehavior::STRICT_,
+                                   std::make_shared<NonBlockingPrefetch>(),
+                                   std::make_shared<RefreshPolicy>(options));
+  Models::CredentialModel credential;
+  int64_t now = static_cast<int64_t>(std::time(nullptr));
+
+  // One hour credential: prefetch starts halfway through its lifetime, less
+  // the share of the minimum lead
+  auto hour = provider.makeRefreshResult(credential, now + 3600);
+  EXPECT_EQ(now + 3600 - RefreshableProvider::PREFETCH_THRESHOLD, hour.staleTime);
+  EXPECT_NEAR(static_cast<double>(now + 1800),
+              static_cast<double>(hour.prefetchTime), 10.0);
+
+  // Twelve hour credential: capped by the maximum refresh interval
+  auto day = provider.makeRefreshResult(credential, now + 12 * 3600);
+  EXPECT_NEAR(static_cast<double>(now + 3600),
+              static_cast<double>(day.prefetchTime), 1.0);
+
+  // Short credential: never prefetched after the stale time
+  auto shortLived = provider.makeRefreshResult(credential, now + 200);
+  EXPECT_EQ(now + 20, shortLived.staleTime);
+  EXPECT_LE(shortLived.prefetchTime, shortLived.staleTime);
+}
+
+TEST(RefreshableProviderTest, LeadKeepsJitteredPrefetchTimesApart) {
+  // A process whose jitter moves its prefetch into the minimum lead before
+  // the stale time, and one without jitter
+  RefreshPolicy::Options jittered;
+  jittered.jitterFraction = RefreshStats::MIN_PREFETCH_LEAD_SECONDS / 3420.0;
+  for (uint64_t seed = 1; jittered.jitterSeed == 0; ++seed) {
+    jittered.jitterSeed = seed;
+    if (RefreshPolicy(jittered).getJitter() < 0.5) {
+      jittered.jitterSeed = 0;
+    }
+  }
+  RefreshPolicy::Options exact = jittered;
+  exact.jitterFraction = 0;
+  TestRefreshableProvider first(StaleValueBehavior::STRICT_,
+                                std::make_shared<NonBlockingPrefetch>(),
+                                std::make_shared<RefreshPolicy>(jittered));
+  TestRefreshableProvider second(StaleValueBehavior::STRICT_,
+                                 std::make_shared<NonBlockingPrefetch>(),
+                                 std::make_shared<RefreshPolicy>(exact));
+  Models::CredentialModel credential;
+  const int64_t expiration = static_cast<int64_t>(std::time(nullptr)) + 3600;
+
+  // Both keep the lead without being moved onto the same instant
+  auto a = first.makeRefreshResult(credential, expiration);
+  auto b = second.makeRefreshResult(credential, expiration);
+  EXPECT_LE(b.prefetchTime,
+            b.staleTime - RefreshStats::MIN_PREFETCH_LEAD_SECONDS);
+  EXPECT_LT(a.prefetchTime + 2, b.prefetchTime);
+}
+
 TEST(RefreshableProviderTest, RefreshFailureWithValidCacheReturnsCache) {
   TestRefreshableProvider provider(StaleValueBehavior::STRICT_);
   
@@ -179,6 +256,25 @@ TEST(RefreshableProviderTest, RefreshFailureWithValidCacheReturnsCache) {
   EXPECT_EQ(credential1.getAccessKeyId(), credential2.getAccessKeyId());
 }
 
+TEST(RefreshableProviderTest, FailedPrefetchBacksOff) {
+  TestRefreshableProvider provider(StaleValueBehavior::STRICT_,
+                                   std::make_shared<OneCallerBlocksPrefetch>());
+  // Inside the prefetch window but not stale
+  int64_t nearFuture = static_cast<int64_t>(std::time(nullptr)) +
+                       RefreshableProvider::PREFETCH_THRESHOLD - 10;
+  provider.setCustomExpiration(nearFuture);
+  EXPECT_EQ("test_ak_1", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ(1, provider.getRefreshCount());
+
+  // The first call prefetches and fails; the next ones keep serving the
+  // valid credential without retrying until the backoff passed
+  provider.setShouldFail(true);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ("test_ak_1", provider.getCredential().getAccessKeyId());
+  }
+  EXPECT_EQ(2, provider.getRefreshCount());
+}
+
 TEST(RefreshableProviderTest, StrictBehaviorWithExpiredCacheThrows) {
   TestRefreshableProvider provider(StaleValueBehavior::STRICT_);
   
@@ -330,3 +426,100 @@ TEST(RefreshableProviderTest, RefreshResultDefaultConstructor) {
   EXPECT_EQ(0, result.prefetchTime);
   EXPECT_TRUE(result.credential.empty());
 }
+
+// Records prefetch requests without running them
+class RecordingPrefetch : public PrefetchStrategy {
+public:
+  void prefetch(std::function<void()> action) override {
+    ++count;
+    pending = action;
+  }
+  int count = 0;
+  std::function<void()> pending;
+};
+
+TEST(RefreshableProviderTest, ConcurrentColdStartRefreshesOnce) {
+  TestRefreshableProvider provider;
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < 16; ++i) {
+    threads.emplace_back([&provider]() {
+      auto credential = provider.getCredential();
+      EXPECT_EQ("test_ak_1", credential.getAccessKeyId());
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(1, provider.getRefreshCount());
+}
+
+TEST(RefreshableProviderTest, PrefetchIsNotRequeuedWhilePending) {
+  auto strategy = std::make_shared<RecordingPrefetch>();
+  TestRefreshableProvider provider(StaleValueBehavior::STRICT_, strategy);
+
+  // Inside the prefetch window but not stale
+  int64_t nearFuture = static_cast<int64_t>(std::time(nullptr)) +
+                       RefreshableProvider::PREFETCH_THRESHOLD - 10;
+  provider.setCustomExpiration(nearFuture);
+  provider.getCredential();
+
+  for (int i = 0; i < 10; ++i) {
+    provider.getCredential();
+  }
+  EXPECT_EQ(1, strategy->count);
+
+  // Once the pending prefetch completes a new one may be requested
+  provider.setCustomExpiration(0);
+  strategy->pending();
+  EXPECT_EQ(2, provider.getRefreshCount());
+  provider.getCredential();
+  EXPECT_EQ(1, strategy->count);
+}
+
+TEST(RefreshableProviderTest, ReferenceSurvivesRefresh) {
+  TestRefreshableProvider provider;
+  int64_t pastTime = static_cast<int64_t>(std::time(nullptr)) - 100;
+  provider.setCustomExpiration(pastTime);
+
+  const auto& first = provider.getCredential();
+  EXPECT_EQ("test_ak_1", first.getAccessKeyId());
+  provider.setCustomExpiration(0);
+  const auto& second = provider.getCredential();
+  EXPECT_EQ("test_ak_2", second.getAccessKeyId());
+}
+
+TEST(RefreshableProviderTest, ReferenceSurvivesRefreshesOfOtherThreads) {
+  TestRefreshableProvider provider;
+  // Stale as soon as fetched: every call refreshes and publishes
+  int64_t pastTime = static_cast<int64_t>(std::time(nullptr)) - 100;
+  provider.setCustomExpiration(pastTime);
+
+  const auto& first = provider.getCredential();
+  std::thread other([&provider]() {
+    for (int i = 0; i < 10; ++i) {
+      provider.getCredential();
+    }
+  });
+  other.join();
+
+  EXPECT_EQ(11, provider.getRefreshCount());
+  EXPECT_EQ("test_ak_1", first.getAccessKeyId());
+  EXPECT_EQ("test_secret_1", first.getAccessKeySecret());
+}
+
+TEST(RefreshableProviderTest, RequestRefreshFetchesBeforePrefetchTime) {
+  TestRefreshableProvider provider(StaleValueBehavior::STRICT_,
+                                   std::make_shared<OneCallerBlocksPrefetch>());
+  // Nothing fetched yet: nothing to refresh
+  provider.requestRefresh();
+  EXPECT_EQ(0, provider.getRefreshCount());
+
+  EXPECT_EQ("test_ak_1", provider.getCredential().getAccessKeyId());
+  provider.requestRefresh();
+  EXPECT_EQ(2, provider.getRefreshCount());
+  EXPECT_EQ("test_ak_2", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ(2, provider.getRefreshCount());
+}
@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/HttpTransport.hpp>
+#include <alibabacloud/credential/provider/CloudSSOCredentialsProvider.hpp>
+#include <alibabacloud/credential/provider/OAuthCredentialsProvider.hpp>
+#include <alibabacloud/credential/provider/OIDCRoleArnProvider.hpp>
+#include <alibabacloud/credential/provider/RamRoleArnProvider.hpp>
+#include <alibabacloud/credential/provider/RsaKeyPairProvider.hpp>
+#include <alibabacloud/credential/provider/URLProvider.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== Remote Provider Refresh Tests ====================
+//
+// Each provider that moved from NeedFreshProvider to RefreshableProvider is
+// driven through a scripted transport: the first credential is inside its
+// prefetch window, so the next read must be served from the cache while
+// doRefresh() runs in the background.
+
+namespace {
+
+// Builds the response body of one provider for a credential valid for
+// `lifetimeSeconds`
+typedef std::function<std::string(const std::string &accessKeyId,
+                                  int64_t lifetimeSeconds)>
+    ResponseBuilder;
+
+// Lifetime putting the credential 5 seconds before its stale time and past
+// its prefetch time
+const int64_t PREFETCH_DUE_LIFETIME = 185;
+const int64_t LONG_LIFETIME = 3600;
+
+std::string expiration(int64_t lifetimeSeconds) {
+  time_t at = time(nullptr) + static_cast<time_t>(lifetimeSeconds);
+  std::tm tm{};
+#ifdef _WIN32
+  gmtime_s(&tm, &at);
+#else
+  gmtime_r(&at, &tm);
+#endif
+  char buf[21];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+  return buf;
+}
+
+std::string stsResponse(const std::string &accessKeyId, int64_t lifetime) {
+  return "{\"Code\":\"Success\",\"Credentials\":{\"AccessKeyId\":\"" +
+         accessKeyId + "\",\"AccessKeySecret\":\"secret\","
+         "\"SecurityToken\":\"token\",\"Expiration\":\"" +
+         expiration(lifetime) + "\"}}";
+}
+
+std::string urlResponse(const std::string &accessKeyId, int64_t lifetime) {
+  return "{\"Code\":\"Success\",\"AccessKeyId\":\"" + accessKeyId +
+         "\",\"AccessKeySecret\":\"secret\",\"SecurityToken\":\"token\","
+         "\"Expiration\":\"" + expiration(lifetime) + "\"}";
+}
+
+std::string rsaKeyPairResponse(const std::string &accessKeyId,
+                               int64_t lifetime) {
+  return "{\"Code\":\"Success\",\"SessionAccessKey\":{"
+         "\"SessionAccessKeyId\":\"" + accessKeyId +
+         "\",\"SessionAccessKeySecret\":\"secret\",\"Expiration\":\"" +
+         expiration(lifetime) + "\"}}";
+}
+
+std::string cloudSSOResponse(const std::string &accessKeyId,
+                             int64_t lifetime) {
+  return "{\"RoleCredentials\":{\"AccessKeyId\":\"" + accessKeyId +
+         "\",\"AccessKeySecret\":\"secret\",\"SecurityToken\":\"token\","
+         "\"Expiration\":\"" + expiration(lifetime) + "\"}}";
+}
+
+std::string oauthResponse(const std::string &accessKeyId, int64_t lifetime) {
+  return "{\"access_token\":\"bearer\",\"expires_in\":" +
+         std::to_string(lifetime) + ",\"access_key_id\":\"" + accessKeyId +
+         "\"}";
+}
+
+// Answers with the scripted response; hold() makes the next requests wait
+// for release()
+class ScriptedHttpTransport : public HttpTransport {
+public:
+  explicit ScriptedHttpTransport(ResponseBuilder builder)
+      : builder_(std::move(builder)) {}
+
+  HttpResponse send(const HttpRequest &) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++requests_;
+    changed_.notify_all();
+    changed_.wait_for(lock, std::chrono::seconds(5),
+                      [this]() { return !held_; });
+    HttpResponse response;
+    response.statusCode = statusCode_;
+    response.body = statusCode_ == 200 ? builder_(accessKeyId_, lifetime_)
+                                       : "{\"Code\":\"InternalError\"}";
+    return response;
+  }
+
+  void respond(const std::string &accessKeyId, int64_t lifetime) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statusCode_ = 200;
+    accessKeyId_ = accessKeyId;
+    lifetime_ = lifetime;
+  }
+
+  void fail() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statusCode_ = 500;
+  }
+
+  void hold() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_ = true;
+  }
+
+  void release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_ = false;
+    changed_.notify_all();
+  }
+
+  bool waitForRequests(int count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, std::chrono::seconds(5),
+                             [this, count]() { return requests_ >= count; });
+  }
+
+  int requests() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_;
+  }
+
+private:
+  ResponseBuilder builder_;
+  mutable std::mutex mutex_;
+  std::condition_variable changed_;
+  int requests_ = 0;
+  bool held_ = false;
+  int statusCode_ = 200;
+  std::string accessKeyId_;
+  int64_t lifetime_ = LONG_LIFETIME;
+};
+
+typedef std::function<std::unique_ptr<RefreshableProvider>()> ProviderFactory;
+
+std::unique_ptr<RefreshableProvider>
+prepare(std::unique_ptr<RefreshableProvider> provider,
+        std::shared_ptr<ScriptedHttpTransport> transport) {
+  provider->setHttpTransport(transport);
+  provider->setCredentialFileCache(nullptr);
+  provider->setSharedCacheEnabled(false);
+  return provider;
+}
+
+// A read crossing the prefetch time returns the cached credential while the
+// next one is fetched in the background
+void expectPrefetchInBackground(const ProviderFactory &factory,
+                                std::shared_ptr<ScriptedHttpTransport> transport) {
+  transport->respond("ak_1", PREFETCH_DUE_LIFETIME);
+  auto provider = prepare(factory(), transport);
+  EXPECT_EQ("ak_1", provider->getCredential().getAccessKeyId());
+  EXPECT_EQ(1, transport->requests());
+
+  transport->respond("ak_2", LONG_LIFETIME);
+  transport->hold();
+  EXPECT_EQ("ak_1", provider->getCredential().getAccessKeyId());
+  EXPECT_TRUE(transport->waitForRequests(2));
+  // The refresh is still waiting for its response
+  EXPECT_EQ("ak_1", provider->getCredential().getAccessKeyId());
+  transport->release();
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (provider->getCredential().getAccessKeyId() != "ak_2" &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ("ak_2", provider->getCredential().getAccessKeyId());
+  EXPECT_EQ(2, transport->requests());
+}
+
+// A failed prefetch keeps the valid cached credential and backs off
+// instead of retrying on every read
+void expectCacheKeptWhenPrefetchFails(
+    const ProviderFactory &factory,
+    std::shared_ptr<ScriptedHttpTransport> transport) {
+  transport->respond("ak_1", PREFETCH_DUE_LIFETIME);
+  auto provider = prepare(factory(), transport);
+  EXPECT_EQ("ak_1", provider->getCredential().getAccessKeyId());
+
+  transport->fail();
+  EXPECT_EQ("ak_1", provider->getCredential().getAccessKeyId());
+  EXPECT_TRUE(transport->waitForRequests(2));
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (provider->getRefreshStats().getFailureRate() == 0.0 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ("ak_1", provider->getCredential().getAccessKeyId());
+  }
+  EXPECT_EQ(2, transport->requests());
+}
+
+void expectRemoteRefresh(const ProviderFactory &factory,
+                         const ResponseBuilder &builder) {
+  expectPrefetchInBackground(factory,
+                             std::make_shared<ScriptedHttpTransport>(builder));
+  expectCacheKeptWhenPrefetchFails(
+      factory, std::make_shared<ScriptedHttpTransport>(builder));
+}
+
+} // namespace
+
+TEST(RemoteProviderRefreshTest, RamRoleArn) {
+  expectRemoteRefresh(
+      []() {
+        return std::unique_ptr<RefreshableProvider>(new RamRoleArnProvider(
+            "akid", "aksecret", "acs:ram::123456:role/test", "session"));
+      },
+      stsResponse);
+}
+
+TEST(RemoteProviderRefreshTest, OIDCRoleArn) {
+  const std::string tokenPath = "/tmp/test_remote_refresh_oidc_token.txt";
+  std::ofstream(tokenPath) << "oidc_token";
+  expectRemoteRefresh(
+      [&tokenPath]() {
+        return std::unique_ptr<RefreshableProvider>(new OIDCRoleArnProvider(
+            "acs:ram::123456:role/test",
+            "acs:ram::123456:oidc-provider/test", tokenPath));
+      },
+      stsResponse);
+  std::remove(tokenPath.c_str());
+}
+
+TEST(RemoteProviderRefreshTest, URL) {
+  expectRemoteRefresh(
+      []() {
+        return std::unique_ptr<RefreshableProvider>(
+            new URLProvider("http://localhost:8080/credentials"));
+      },
+      urlResponse);
+}
+
+TEST(RemoteProviderRefreshTest, RsaKeyPair) {
+  expectRemoteRefresh(
+      []() {
+        return std::unique_ptr<RefreshableProvider>(
+            new RsaKeyPairProvider("publicKeyId", "privateKey"));
+      },
+      rsaKeyPairResponse);
+}
+
+TEST(RemoteProviderRefreshTest, CloudSSO) {
+  expectRemoteRefresh(
+      []() {
+        return std::unique_ptr<RefreshableProvider>(
+            new CloudSSOCredentialsProvider("role"));
+      },
+      cloudSSOResponse);
+}
+
+TEST(RemoteProviderRefreshTest, OAuth) {
+  expectRemoteRefresh(
+      []() {
+        return std::unique_ptr<RefreshableProvider>(new OAuthCredentialsProvider(
+            "client_id", "client_secret", "https://oauth.example.com/token"));
+      },
+      oauthResponse);
+}
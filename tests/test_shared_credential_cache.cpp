@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/Constant.hpp>
+#include <alibabacloud/credential/provider/RefreshableProvider.hpp>
+#include <alibabacloud/credential/provider/SharedCredentialCache.hpp>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== SharedCredentialCache Tests ====================
+
+class SharedCredentialCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    static int counter = 0;
+    key_ = "shared_test_" + std::to_string(getpid()) + "_" +
+           std::to_string(++counter);
+  }
+
+  void TearDown() override { SharedCredentialCache::unlink(key_); }
+
+  static CredentialFileCache::Entry makeEntry(const std::string &accessKeyId) {
+    CredentialFileCache::Entry entry;
+    entry.credential.setType(Constant::STS)
+        .setAccessKeyId(accessKeyId)
+        .setAccessKeySecret("secret")
+        .setSecurityToken("token");
+    entry.staleTime = static_cast<int64_t>(time(nullptr)) + 3600;
+    entry.prefetchTime = static_cast<int64_t>(time(nullptr)) + 1800;
+    return entry;
+  }
+
+  std::string key_;
+};
+
+TEST_F(SharedCredentialCacheTest, EmptyRecord) {
+  auto cache = SharedCredentialCache::open(key_);
+  ASSERT_NE(nullptr, cache);
+  CredentialFileCache::Entry entry;
+  EXPECT_FALSE(cache->read(entry));
+  EXPECT_EQ(0u, cache->getVersion());
+}
+
+TEST_F(SharedCredentialCacheTest, WriteVisibleToOtherMappings) {
+  auto writer = SharedCredentialCache::open(key_);
+  auto reader = SharedCredentialCache::open(key_);
+  ASSERT_NE(nullptr, writer);
+  ASSERT_NE(nullptr, reader);
+
+  auto stored = makeEntry("ak_1");
+  ASSERT_TRUE(writer->write(stored));
+  EXPECT_EQ(1u, reader->getVersion());
+
+  CredentialFileCache::Entry loaded;
+  ASSERT_TRUE(reader->read(loaded));
+  EXPECT_EQ("ak_1", loaded.credential.getAccessKeyId());
+  EXPECT_EQ("secret", loaded.credential.getAccessKeySecret());
+  EXPECT_EQ("token", loaded.credential.getSecurityToken());
+  EXPECT_FALSE(loaded.credential.hasBearerToken());
+  EXPECT_EQ(stored.staleTime, loaded.staleTime);
+  EXPECT_EQ(stored.prefetchTime, loaded.prefetchTime);
+
+  ASSERT_TRUE(writer->write(makeEntry("ak_2")));
+  ASSERT_TRUE(reader->read(loaded));
+  EXPECT_EQ("ak_2", loaded.credential.getAccessKeyId());
+  EXPECT_EQ(2u, reader->getVersion());
+}
+
+TEST_F(SharedCredentialCacheTest, OversizedCredentialRejected) {
+  auto cache = SharedCredentialCache::open(key_);
+  ASSERT_NE(nullptr, cache);
+  auto entry = makeEntry(std::string(SharedCredentialCache::MAX_CREDENTIAL_SIZE, 'a'));
+  EXPECT_FALSE(cache->write(entry));
+}
+
+TEST_F(SharedCredentialCacheTest, LeaseIsExclusive) {
+  auto first = SharedCredentialCache::open(key_);
+  auto second = SharedCredentialCache::open(key_);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  const int64_t now = static_cast<int64_t>(time(nullptr));
+
+  EXPECT_TRUE(first->tryAcquireLease(now));
+  EXPECT_TRUE(first->tryAcquireLease(now));  // Renewal
+  EXPECT_FALSE(second->tryAcquireLease(now));
+
+  first->releaseLease();
+  EXPECT_TRUE(second->tryAcquireLease(now));
+  EXPECT_FALSE(first->tryAcquireLease(now));
+}
+
+TEST_F(SharedCredentialCacheTest, LeaseOfCrashedProcessExpires) {
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // Take the lease and die without releasing it
+    auto cache = SharedCredentialCache::open(key_);
+    bool ok = cache != nullptr &&
+              cache->tryAcquireLease(static_cast<int64_t>(time(nullptr)));
+    _exit(ok ? 0 : 1);
+  }
+  int status = 0;
+  ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(0, WEXITSTATUS(status));
+
+  auto cache = SharedCredentialCache::open(key_);
+  ASSERT_NE(nullptr, cache);
+  const int64_t now = static_cast<int64_t>(time(nullptr));
+  EXPECT_FALSE(cache->tryAcquireLease(now));
+  EXPECT_TRUE(cache->tryAcquireLease(now + SharedCredentialCache::LEASE_SECONDS + 1));
+}
+
+// Provider counting how often it calls the remote service
+class SharedRefreshableProvider : public RefreshableProvider {
+public:
+  explicit SharedRefreshableProvider(std::string key) : key_(std::move(key)) {
+    setCredentialFileCache(nullptr);
+    setSharedCacheEnabled(true);
+  }
+  ~SharedRefreshableProvider() { shutdown(); }
+
+  std::string getProviderName() const override { return "shared_test"; }
+
+  mutable int refreshCount = 0;
+  bool fail = false;
+
+protected:
+  RefreshResult doRefresh() const override {
+    ++refreshCount;
+    if (fail) {
+      throw std::runtime_error("Simulated refresh failure");
+    }
+    Models::CredentialModel credential;
+    credential.setType(Constant::STS)
+        .setAccessKeyId("ak_" + std::to_string(getpid()))
+        .setAccessKeySecret("sk")
+        .setSecurityToken("token");
+    return makeRefreshResult(credential, getCurrentTime() + 3600);
+  }
+
+  std::string getCacheKey() const override { return key_; }
+
+private:
+  std::string key_;
+};
+
+TEST_F(SharedCredentialCacheTest, ProcessesShareOneRefresh) {
+  SharedRefreshableProvider parent(key_);
+  EXPECT_EQ("ak_" + std::to_string(getpid()),
+            parent.getCredential().getAccessKeyId());
+  EXPECT_EQ(1, parent.refreshCount);
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // Leaked on purpose: _exit() skips destructors touching parent threads
+    auto child = new SharedRefreshableProvider(key_);
+    bool ok = child->getCredential().getAccessKeyId() ==
+                  "ak_" + std::to_string(getppid()) &&
+              child->refreshCount == 0;
+    _exit(ok ? 0 : 1);
+  }
+  int status = 0;
+  ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(0, WEXITSTATUS(status));
+}
+
+TEST_F(SharedCredentialCacheTest, FailedRefreshReleasesLease) {
+  SharedRefreshableProvider provider(key_);
+  provider.fail = true;
+  EXPECT_THROW(provider.getCredential(), std::runtime_error);
+  EXPECT_EQ(1, provider.refreshCount);
+
+  // Another process may refresh now rather than after LEASE_SECONDS
+  auto other = SharedCredentialCache::open(key_);
+  ASSERT_NE(nullptr, other);
+  EXPECT_TRUE(other->tryAcquireLease(static_cast<int64_t>(time(nullptr))));
+}
+
+TEST_F(SharedCredentialCacheTest, ProvidersServeLeaseHolderRecord) {
+  SharedRefreshableProvider first(key_);
+  SharedRefreshableProvider second(key_);
+
+  // Another process holds the lease and has published a credential
+  auto other = SharedCredentialCache::open(key_);
+  ASSERT_NE(nullptr, other);
+  ASSERT_TRUE(other->tryAcquireLease(static_cast<int64_t>(time(nullptr))));
+  other->write(makeEntry("ak_other"));
+
+  EXPECT_EQ("ak_other", first.getCredential().getAccessKeyId());
+  EXPECT_EQ("ak_other", second.getCredential().getAccessKeyId());
+  EXPECT_EQ(0, first.refreshCount);
+  EXPECT_EQ(0, second.refreshCount);
+}
+
+#endif
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/provider/AccessKeyProvider.hpp>
+#include <alibabacloud/credential/provider/NeedFreshProvider.hpp>
+#include <alibabacloud/credential/provider/ThreadLocalCachedProvider.hpp>
+#include <darabonba/Exception.hpp>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== ThreadLocalCachedProvider Tests ====================
+
+namespace {
+
+// Counts calls reaching the wrapped provider
+class CountingProvider : public AccessKeyProvider {
+public:
+  CountingProvider() : AccessKeyProvider("ak", "sk") {}
+
+  std::shared_ptr<const CredentialSnapshot> getSnapshot() const override {
+    ++calls;
+    return AccessKeyProvider::getSnapshot();
+  }
+
+  mutable std::atomic<int> calls{0};
+};
+
+// Rotates keys on the next call after rotate()
+class ManualRotationProvider : public NeedFreshProvider {
+public:
+  ManualRotationProvider() : NeedFreshProvider(farFuture()) {
+    credential_.setAccessKeyId("ak_0");
+  }
+
+  void rotate() { expiration_ = 0; }
+
+  std::string getProviderName() const override { return "manual"; }
+
+protected:
+  bool refreshCredential() const override {
+    credential_.setAccessKeyId("ak_" + std::to_string(++rotation_));
+    expiration_ = farFuture();
+    return true;
+  }
+
+private:
+  static int64_t farFuture() {
+    return static_cast<int64_t>(time(nullptr)) + 3600;
+  }
+
+  mutable int rotation_ = 0;
+};
+
+} // namespace
+
+TEST(ThreadLocalCachedProviderTest, NullProviderThrows) {
+  EXPECT_THROW(ThreadLocalCachedProvider(nullptr), Darabonba::Exception);
+}
+
+TEST(ThreadLocalCachedProviderTest, WarmReadsStayOnThread) {
+  auto inner = std::make_shared<CountingProvider>();
+  ThreadLocalCachedProvider provider(inner, std::chrono::hours(1));
+
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  }
+  EXPECT_EQ(1, inner->calls.load());
+  EXPECT_EQ(Constant::ACCESS_KEY, provider.getProviderName());
+  EXPECT_EQ(1u, provider.getGeneration());
+}
+
+TEST(ThreadLocalCachedProviderTest, EachThreadHasItsOwnCopy) {
+  auto inner = std::make_shared<CountingProvider>();
+  ThreadLocalCachedProvider provider(inner, std::chrono::hours(1));
+
+  const Models::CredentialModel *mainCopy = &provider.getCredential();
+  const Models::CredentialModel *otherCopy = nullptr;
+  std::thread other([&provider, &otherCopy]() {
+    otherCopy = &provider.getCredential();
+  });
+  other.join();
+
+  EXPECT_NE(mainCopy, otherCopy);
+  EXPECT_EQ(2, inner->calls.load());
+}
+
+TEST(ThreadLocalCachedProviderTest, EpochChangeReloads) {
+  auto inner = std::make_shared<ManualRotationProvider>();
+  ThreadLocalCachedProvider provider(inner, std::chrono::hours(1));
+
+  EXPECT_EQ("ak_0", provider.getCredential().getAccessKeyId());
+
+  // Another user of the inner provider triggers the rotation
+  inner->rotate();
+  EXPECT_EQ("ak_1", inner->getCredential().getAccessKeyId());
+
+  EXPECT_EQ("ak_1", provider.getCredential().getAccessKeyId());
+  EXPECT_EQ("ak_1", provider.getSnapshot()->getAccessKeyId());
+}
+
+TEST(ThreadLocalCachedProviderTest, IntervalRevalidates) {
+  auto inner = std::make_shared<ManualRotationProvider>();
+  ThreadLocalCachedProvider provider(inner, std::chrono::milliseconds(0));
+
+  EXPECT_EQ("ak_0", provider.getCredential().getAccessKeyId());
+
+  // No one else calls the inner provider: the wrapper must reach it itself
+  inner->rotate();
+  EXPECT_EQ("ak_1", provider.getCredential().getAccessKeyId());
+}
+
+TEST(ThreadLocalCachedProviderTest, BusyThreadRevalidatesWithinReadBudget) {
+  auto inner = std::make_shared<CountingProvider>();
+  ThreadLocalCachedProvider provider(inner, std::chrono::milliseconds(20));
+
+  // Read through one interval so the next one gets the largest read budget
+  auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(30);
+  while (inner->calls.load() < 2 || std::chrono::steady_clock::now() < until) {
+    provider.getCredential();
+  }
+  const int calls = inner->calls.load();
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  int reads = 0;
+  while (inner->calls.load() == calls && reads < 1000) {
+    provider.getCredential();
+    ++reads;
+  }
+  EXPECT_LE(reads, 64);
+}
+
+TEST(ThreadLocalCachedProviderTest, ManyInstancesPerThread) {
+  auto inner = std::make_shared<CountingProvider>();
+  for (size_t i = 0; i < PinnedValues::SWEEP_THRESHOLD * 2; ++i) {
+    ThreadLocalCachedProvider provider(inner, std::chrono::hours(1));
+    EXPECT_EQ("ak", provider.getCredential().getAccessKeyId());
+  }
+}
+
+TEST(ThreadLocalCachedProviderTest, ReferenceSurvivesOtherProviders) {
+  auto inner = std::make_shared<CountingProvider>();
+  ThreadLocalCachedProvider provider(inner, std::chrono::hours(1));
+  const auto &credential = provider.getCredential();
+
+  // Adds and sweeps entries of the thread around this provider's
+  std::vector<std::unique_ptr<ThreadLocalCachedProvider>> others;
+  for (size_t i = 0; i < PinnedValues::SWEEP_THRESHOLD * 4; ++i) {
+    if (i % 2 == 0) {
+      others.clear();
+    }
+    others.emplace_back(
+        new ThreadLocalCachedProvider(inner, std::chrono::hours(1)));
+    EXPECT_EQ("ak", others.back()->getCredential().getAccessKeyId());
+  }
+
+  EXPECT_EQ("ak", credential.getAccessKeyId());
+  EXPECT_EQ(&credential, &provider.getCredential());
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/HttpConnectionPool.hpp>
+#include <alibabacloud/credential/TlsSessionCache.hpp>
+#include <memory>
+#include <string>
+
+#ifndef _WIN32
+#include "tls_loopback_server.hpp"
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== TlsSessionCache Tests ====================
+
+class TlsSessionCacheTest : public ::testing::Test {
+protected:
+  // A pool that reconnects for every request, as after an idle close
+  static HttpConnectionPool::Options reconnecting(
+      std::shared_ptr<TlsSessionCache> sessionCache,
+      const TlsLoopbackServer &server) {
+    HttpConnectionPool::Options options;
+    options.maxIdlePerEndpoint = 0;
+    options.sessionCache = std::move(sessionCache);
+    options.caFile = server.caFile();
+    return options;
+  }
+
+  const std::string caFile_ = ::testing::TempDir() + "tls_session_cache_ca.pem";
+};
+
+TEST_F(TlsSessionCacheTest, ReconnectResumesSession) {
+  TlsLoopbackServer server("{\"Code\":\"Success\"}", caFile_);
+  HttpConnectionPool pool(
+      reconnecting(std::make_shared<TlsSessionCache>(), server));
+
+  for (int i = 0; i < 3; ++i) {
+    const auto response = pool.send(HttpRequest(server.url()));
+    EXPECT_EQ(200, response.statusCode);
+    EXPECT_EQ("{\"Code\":\"Success\"}", response.body);
+  }
+
+  EXPECT_EQ(3, server.handshakes());
+  EXPECT_EQ(2, server.resumed());
+}
+
+TEST_F(TlsSessionCacheTest, SessionsSharedBetweenPools) {
+  TlsLoopbackServer server("{}", caFile_);
+  auto sessionCache = std::make_shared<TlsSessionCache>();
+  HttpConnectionPool first(reconnecting(sessionCache, server));
+  HttpConnectionPool second(reconnecting(sessionCache, server));
+
+  first.send(HttpRequest(server.url()));
+  second.send(HttpRequest(server.url()));
+
+  EXPECT_EQ(1, server.resumed());
+}
+
+TEST_F(TlsSessionCacheTest, NoResumptionWithoutCache) {
+  TlsLoopbackServer server("{}", caFile_);
+  HttpConnectionPool pool(reconnecting(nullptr, server));
+
+  pool.send(HttpRequest(server.url()));
+  pool.send(HttpRequest(server.url()));
+
+  EXPECT_EQ(2, server.handshakes());
+  EXPECT_EQ(0, server.resumed());
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <alibabacloud/credential/TokenFile.hpp>
+#include <darabonba/Exception.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace AlibabaCloud::Credential;
+
+// ==================== TokenFile Tests ====================
+
+class TokenFileTest : public ::testing::Test {
+protected:
+  void SetUp() override { path_ = ::testing::TempDir() + "token_file_test"; }
+
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  static void write(const std::string &path, const std::string &content) {
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs << content;
+  }
+
+  // Wait up to 5 seconds for the token to become `expected`
+  static bool waitForToken(const TokenFile &file, const std::string &expected) {
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (*file.getToken() != expected) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+  }
+
+  std::string path_;
+};
+
+TEST_F(TokenFileTest, TokenKeptUntilFileChanges) {
+  TokenFileWatcher::Options options;
+  options.pollIntervalMs = 60000;  // Only inotify can notice the change
+  TokenFileWatcher watcher(options);
+  write(path_, "token-1");
+  TokenFile file(path_, watcher);
+  std::atomic<int> changes{0};
+  file.setListener([&changes]() { ++changes; });
+
+  auto token = file.getToken();
+  EXPECT_EQ("token-1", *token);
+  EXPECT_EQ(token, file.getToken());
+
+  write(path_, "token-22");
+  if (!watcher.usesInotify()) {
+    return;  // Covered by PollingDetectsSymlinkRotation
+  }
+  EXPECT_TRUE(waitForToken(file, "token-22"));
+  EXPECT_EQ(1, changes);
+  // Tokens handed out before the change stay valid
+  EXPECT_EQ("token-1", *token);
+}
+
+#ifndef _WIN32
+TEST_F(TokenFileTest, PollingDetectsSymlinkRotation) {
+  // Kubernetes projects a token as a symlink swapped on rotation
+  const std::string first = path_ + ".1", second = path_ + ".2";
+  const std::string link = path_ + ".link";
+  write(first, "projected-1");
+  write(second, "projected-2");
+  ASSERT_EQ(0, symlink(first.c_str(), path_.c_str()));
+
+  TokenFileWatcher::Options options;
+  options.pollIntervalMs = 10;
+  options.inotifyEnabled = false;
+  TokenFileWatcher watcher(options);
+  EXPECT_FALSE(watcher.usesInotify());
+  TokenFile file(path_, watcher);
+  EXPECT_EQ("projected-1", *file.getToken());
+
+  ASSERT_EQ(0, symlink(second.c_str(), link.c_str()));
+  ASSERT_EQ(0, rename(link.c_str(), path_.c_str()));
+  EXPECT_TRUE(waitForToken(file, "projected-2"));
+
+  std::remove(first.c_str());
+  std::remove(second.c_str());
+}
+#endif
+
+TEST_F(TokenFileTest, MissingFileThrowsUntilCreated) {
+  TokenFileWatcher::Options options;
+  options.pollIntervalMs = 10;
+  TokenFileWatcher watcher(options);
+  TokenFile file(path_, watcher);
+  EXPECT_THROW(file.getToken(), Darabonba::Exception);
+
+  write(path_, "late-token");
+  EXPECT_EQ("late-token", *file.getToken());
+
+  // A file emptied mid-rotation keeps the previous token
+  write(path_, "");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ("late-token", *file.getToken());
+  write(path_, "next-token");
+  EXPECT_TRUE(waitForToken(file, "next-token"));
+}
+
+TEST_F(TokenFileTest, ListenerRemovedSynchronously) {
+  TokenFileWatcher::Options options;
+  options.pollIntervalMs = 5;
+  TokenFileWatcher watcher(options);
+  write(path_, "a");
+  TokenFile file(path_, watcher);
+  file.getToken();
+
+  std::atomic<int> changes{0};
+  file.setListener([&changes]() { ++changes; });
+  write(path_, "bb");
+  ASSERT_TRUE(waitForToken(file, "bb"));
+  // The listener runs right after the token is swapped
+  for (int i = 0; i < 1000 && changes == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  file.setListener(nullptr);
+  const int seen = changes;
+  EXPECT_EQ(1, seen);
+
+  write(path_, "ccc");
+  ASSERT_TRUE(waitForToken(file, "ccc"));
+  EXPECT_EQ(seen, changes);
+}
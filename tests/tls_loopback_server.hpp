@@ -0,0 +1,166 @@
+// HTTPS server on a loopback port standing in for STS in tests and
+// benchmarks. It answers every request with a fixed body and closes the
+// connection, so each request makes a new TLS handshake, and counts the
+// handshakes that resumed a session.
+//
+// The certificate is self-signed for 127.0.0.1 and written to caFile() for
+// clients to trust.
+
+#ifndef ALIBABACLOUD_CREDENTIAL_TESTS_TLS_LOOPBACK_SERVER_HPP_
+#define ALIBABACLOUD_CREDENTIAL_TESTS_TLS_LOOPBACK_SERVER_HPP_
+
+#include <atomic>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/ec.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+
+class TlsLoopbackServer {
+public:
+  TlsLoopbackServer(const std::string &body, const std::string &caFile)
+      : body_(body), caFile_(caFile) {
+    ctx_ = SSL_CTX_new(TLS_server_method());
+    EVP_PKEY *key = makeKey();
+    X509 *cert = makeCertificate(key);
+    SSL_CTX_use_certificate(ctx_, cert);
+    SSL_CTX_use_PrivateKey(ctx_, key);
+    const unsigned char context[] = "tls-loopback";
+    SSL_CTX_set_session_id_context(ctx_, context, sizeof(context) - 1);
+
+    FILE *file = std::fopen(caFile_.c_str(), "w");
+    if (file == nullptr) {
+      throw std::runtime_error("Can't write " + caFile_);
+    }
+    PEM_write_X509(file, cert);
+    std::fclose(file);
+    X509_free(cert);
+    EVP_PKEY_free(key);
+
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    socklen_t length = sizeof(addr);
+    getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &length);
+    port_ = ntohs(addr.sin_port);
+    listen(fd_, 16);
+    thread_ = std::thread(&TlsLoopbackServer::serve, this);
+  }
+
+  ~TlsLoopbackServer() {
+    shutdown(fd_, SHUT_RDWR);
+    close(fd_);
+    thread_.join();
+    SSL_CTX_free(ctx_);
+    std::remove(caFile_.c_str());
+  }
+
+  TlsLoopbackServer(const TlsLoopbackServer &) = delete;
+  TlsLoopbackServer &operator=(const TlsLoopbackServer &) = delete;
+
+  std::string url() const {
+    return "https://127.0.0.1:" + std::to_string(port_) + "/";
+  }
+
+  const std::string &caFile() const { return caFile_; }
+
+  int handshakes() const { return handshakes_.load(); }
+  int resumed() const { return resumed_.load(); }
+
+private:
+  static EVP_PKEY *makeKey() {
+    EVP_PKEY *key = nullptr;
+    EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    EVP_PKEY_keygen_init(ctx);
+    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx, NID_X9_62_prime256v1);
+    EVP_PKEY_keygen(ctx, &key);
+    EVP_PKEY_CTX_free(ctx);
+    return key;
+  }
+
+  static X509 *makeCertificate(EVP_PKEY *key) {
+    X509 *cert = X509_new();
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), -60);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME *name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char *>(
+                                   "127.0.0.1"),
+                               -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509V3_CTX v3;
+    X509V3_set_ctx_nodb(&v3);
+    X509V3_set_ctx(&v3, cert, cert, nullptr, nullptr, 0);
+    for (const auto &extension :
+         {std::make_pair(NID_subject_alt_name, "IP:127.0.0.1"),
+          std::make_pair(NID_basic_constraints, "critical,CA:TRUE")}) {
+      X509_EXTENSION *ext = X509V3_EXT_conf_nid(
+          nullptr, &v3, extension.first, const_cast<char *>(extension.second));
+      X509_add_ext(cert, ext, -1);
+      X509_EXTENSION_free(ext);
+    }
+    X509_sign(cert, key, EVP_sha256());
+    return cert;
+  }
+
+  void serve() {
+    for (;;) {
+      const int client = accept(fd_, nullptr, nullptr);
+      if (client < 0) {
+        return;
+      }
+      SSL *ssl = SSL_new(ctx_);
+      SSL_set_fd(ssl, client);
+      if (SSL_accept(ssl) == 1) {
+        ++handshakes_;
+        if (SSL_session_reused(ssl)) {
+          ++resumed_;
+        }
+        std::string request;
+        char chunk[4096];
+        while (request.find("\r\n\r\n") == std::string::npos) {
+          const int n = SSL_read(ssl, chunk, sizeof(chunk));
+          if (n <= 0) {
+            break;
+          }
+          request.append(chunk, static_cast<size_t>(n));
+        }
+        const std::string response =
+            "HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: " +
+            std::to_string(body_.size()) + "\r\n\r\n" + body_;
+        SSL_write(ssl, response.data(), static_cast<int>(response.size()));
+        SSL_shutdown(ssl);
+      }
+      SSL_free(ssl);
+      close(client);
+      ERR_clear_error();
+    }
+  }
+
+  const std::string body_;
+  const std::string caFile_;
+  SSL_CTX *ctx_ = nullptr;
+  int fd_ = -1;
+  int port_ = 0;
+  std::atomic<int> handshakes_{0};
+  std::atomic<int> resumed_{0};
+  std::thread thread_;
+};
+
+#endif